@@ -0,0 +1,4 @@
+include(CMakeFindDependencyMacro)
+find_dependency(Threads)
+
+include("${CMAKE_CURRENT_LIST_DIR}/tuple_arithmeticTargets.cmake")
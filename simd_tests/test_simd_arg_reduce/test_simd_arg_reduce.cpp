@@ -0,0 +1,46 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <cmath>
+
+using simd_t = xsimd::make_sized_batch_t<double, 4>;
+using fsimd_t = xsimd::make_sized_batch_t<float, 8>;
+
+TEST_CASE( "simd reductions with index", "[simd arg reduce]" ) {
+
+    SECTION( "lanes of a batch" ) {
+        fsimd_t x{3, 1, 4, 1, 5, 9, 2, 9};
+        REQUIRE( tpa::min_element(x) == std::pair{1.0f, size_t(1)} );
+        REQUIRE( tpa::max_element(x) == std::pair{9.0f, size_t(5)} );
+        REQUIRE( tpa::argmin(std::array<float, 8>{3, 1, 4, 1, 5, 9, 2, 0}) == 7 );
+        const float nan = std::nanf("");
+        REQUIRE( tpa::argmax(fsimd_t{3, 1, 4, nan, 5, nan, 2, 9}) == 3 );
+        REQUIRE( tpa::argmin(fsimd_t{nan, 1, 4, nan, 5, nan, 2, 9}) == 0 );
+    }
+
+    SECTION( "lane-packed records" ) {
+        auto r = std::make_tuple(simd_t{1, 5, 0, 2}, simd_t{0, 6, 0, 2}, simd_t{2, 4, 0, 3});
+        auto [v, i] = tpa::min_element(r);
+        REQUIRE( tpa::to_array(v) == std::array<double, 4>{0, 4, 0, 2} );
+        REQUIRE( tpa::to_array(i) == std::array<int64_t, 4>{1, 2, 0, 0} );
+        REQUIRE( tpa::to_array(tpa::argmax(r)) == std::array<int64_t, 4>{2, 1, 0, 2} );
+    }
+
+    SECTION( "bulk double array" ) {
+        std::vector<double> x(1027);
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = std::sin(double(i));
+        size_t mn = 0, mx = 0;
+        for (size_t i = 1; i < x.size(); ++i) {
+            if (x[i] < x[mn]) mn = i;
+            if (x[i] > x[mx]) mx = i;
+        }
+        auto [a, b] = tpa::minmax_element(x.data(), x.size());
+        REQUIRE( a == std::pair{x[mn], mn} );
+        REQUIRE( b == std::pair{x[mx], mx} );
+    }
+}
@@ -0,0 +1,75 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+
+// Written once for scalars, batches and duals of either.
+struct test_fn {
+    template<typename V>
+    auto operator()(const V& v) const {
+        using std::sqrt;
+        using std::log;
+        using std::atan2;
+        using std::tgamma;
+        using std::max;
+        const auto r = sqrt(v[0] * v[0] + v[1] * v[1] + 1.0);
+        return log(r) * atan2(v[2], v[3]) + tgamma(v[1] + 2.0) / r + max(v[0], v[3]) * v[2];
+    }
+};
+
+template<typename T>
+void check_lanes() {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    std::array<std::array<T, W>, 4> pts;
+    for (size_t l = 0; l < W; ++l) {
+        pts[0][l] = T(0.1) * T(l) - T(0.3);
+        pts[1][l] = T(0.5) + T(0.05) * T(l);
+        pts[2][l] = T(1) - T(0.2) * T(l);
+        pts[3][l] = T(0.25) * T(l % 3) - T(0.1);
+    }
+    std::array<simd_t, 4> x;
+    for (size_t k = 0; k < 4; ++k)
+        x[k] = simd_t::load_unaligned(pts[k].data());
+
+    // One pass gives the gradients at W points.
+    const auto g = tpa::gradient(test_fn{}, x);
+    static_assert(std::is_same_v<decltype(g), const std::array<simd_t, 4>>);
+    const T eps = std::is_same_v<T, float> ? T(1e-4) : T(1e-10);
+    for (size_t l = 0; l < W; ++l) {
+        const std::array<T, 4> p{pts[0][l], pts[1][l], pts[2][l], pts[3][l]};
+        const auto gs = tpa::gradient(test_fn{}, p);
+        for (size_t k = 0; k < 4; ++k)
+            REQUIRE( tpa::to_array(g[k])[l] == Catch::Approx(gs[k]).epsilon(eps) );
+    }
+
+    const auto j = tpa::jacobian([](const auto& v) { return std::array{v[0] * v[1], v[2] / v[3]}; }, x);
+    for (size_t l = 0; l < W; ++l) {
+        REQUIRE( tpa::to_array(j[0][0])[l] == Catch::Approx(pts[1][l]) );
+        REQUIRE( tpa::to_array(j[0][1])[l] == Catch::Approx(pts[0][l]) );
+        REQUIRE( tpa::to_array(j[1][2])[l] == Catch::Approx(T(1) / pts[3][l]) );
+        REQUIRE( tpa::to_array(j[1][3])[l] == Catch::Approx(-pts[2][l] / (pts[3][l] * pts[3][l])).epsilon(eps) );
+    }
+}
+
+TEST_CASE( "lane-packed duals", "[dual]" ) {
+    check_lanes<float>();
+    check_lanes<double>();
+}
+
+TEST_CASE( "batch-sized derivative part", "[dual]" ) {
+    // The partials of a dual<double, 4> fill one AVX batch.
+    using d4 = tpa::dual<double, 4>;
+    const auto v = tpa::dual_variables(std::array{1.0, 2.0, 3.0, 4.0});
+    static_assert(std::is_same_v<decltype(v), const std::array<d4, 4>>);
+    const d4 y = tpa::dot(v, v * 2.0) - v[0] * v[3];
+    REQUIRE( y.value == 56.0 );
+    REQUIRE( y.deriv[0] == 0.0 );
+    REQUIRE( y.deriv[1] == 8.0 );
+    REQUIRE( y.deriv[2] == 12.0 );
+    REQUIRE( y.deriv[3] == 15.0 );
+}
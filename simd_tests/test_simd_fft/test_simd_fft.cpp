@@ -0,0 +1,64 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+template<typename T, size_t N>
+void check_size() {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    const T eps = std::is_same_v<T, float> ? T(1e-5) * T(N) : T(1e-13) * T(N);
+
+    // Records, transformed one by one with scalars and W at a time with batches.
+    const size_t count = 3 * W + 2;
+    std::vector<T> data(2 * N * count);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = std::sin(T(i % 97)) + T(i % 5);
+    auto ref = data;
+    for (size_t j = 0; j < count; ++j) {
+        std::array<T, 2 * N> x;
+        std::copy_n(ref.data() + 2 * N * j, 2 * N, x.begin());
+        tpa::fft_interleaved(x);
+        std::copy_n(x.begin(), 2 * N, ref.data() + 2 * N * j);
+    }
+    auto out = data;
+    tpa::fft_many<N>(out.data(), count, 2);
+    for (size_t i = 0; i < data.size(); ++i)
+        REQUIRE( out[i] == Catch::Approx(ref[i]).margin(eps) );
+    tpa::ifft_many<N>(out.data(), count);
+    for (size_t i = 0; i < data.size(); ++i)
+        REQUIRE( out[i] == Catch::Approx(data[i]).margin(eps) );
+
+    // Lane-packed split signals: lane l holds record l.
+    std::array<simd_t, N> re, im;
+    for (size_t k = 0; k < N; ++k) {
+        std::array<T, W> r, i;
+        for (size_t l = 0; l < W; ++l) {
+            r[l] = data[2 * N * l + 2 * k];
+            i[l] = data[2 * N * l + 2 * k + 1];
+        }
+        re[k] = simd_t::load_unaligned(r.data());
+        im[k] = simd_t::load_unaligned(i.data());
+    }
+    tpa::fft(re, im);
+    for (size_t k = 0; k < N; ++k) {
+        const auto r = tpa::to_array(re[k]);
+        const auto i = tpa::to_array(im[k]);
+        for (size_t l = 0; l < W; ++l) {
+            REQUIRE( r[l] == Catch::Approx(ref[2 * N * l + 2 * k]).margin(eps) );
+            REQUIRE( i[l] == Catch::Approx(ref[2 * N * l + 2 * k + 1]).margin(eps) );
+        }
+    }
+}
+
+TEST_CASE( "lane-packed fft", "[fft]" ) {
+    check_size<float, 8>();
+    check_size<float, 64>();
+    check_size<double, 2>();
+    check_size<double, 32>();
+}
@@ -0,0 +1,75 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+template<typename T>
+void check_batches() {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    constexpr size_t C = 2 * W;
+    const size_t n = 300;
+    std::vector<T> in(C * n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t c = 0; c < C; ++c)
+            in[C * i + c] = std::sin(T(0.05) * T(i * (c + 1))) + T(c);
+
+    // Lane-packed channels, with per-channel coefficients, against scalar frames.
+    using packed = std::array<simd_t, 2>;
+    using scalar = std::array<T, C>;
+    tpa::biquad_cascade<packed, 2> bp(tpa::biquad_lowpass(3000, 48000));
+    tpa::biquad_cascade<scalar, 2> bs(tpa::biquad_lowpass(3000, 48000));
+    tpa::dc_blocker<packed> dp;
+    tpa::dc_blocker<scalar> ds;
+    tpa::one_pole<packed> ep(T(0.1));
+    tpa::one_pole<scalar> es(T(0.1));
+    static_assert(decltype(bp)::channels == C);
+    for (size_t c = 0; c < C; c += 3) {
+        const auto k = tpa::biquad_notch(1000 + 500 * double(c), 48000, 2);
+        bp.set(1, c, k);
+        bs.set(1, c, k);
+        ep.set(c, T(0.5));
+        es.set(c, T(0.5));
+    }
+
+    std::vector<T> out(C * n);
+    tpa::filter_interleaved(in.data(), out.data(), n, dp, bp, ep);
+
+    std::vector<std::vector<T>> planar(C, std::vector<T>(n));
+    std::array<T*, C> cols;
+    for (size_t c = 0; c < C; ++c) {
+        cols[c] = planar[c].data();
+        for (size_t i = 0; i < n; ++i)
+            planar[c][i] = in[C * i + c];
+    }
+    dp.reset();
+    bp.reset();
+    ep.reset();
+    tpa::filter_planar(cols, cols, n, dp, bp, ep);
+
+    const T eps = std::is_same_v<T, float> ? T(1e-4) : T(1e-12);
+    for (size_t i = 0; i < n; ++i) {
+        scalar x;
+        for (size_t c = 0; c < C; ++c)
+            x[c] = in[C * i + c];
+        const auto y = es.process(bs.process(ds.process(x)));
+        for (size_t c = 0; c < C; ++c) {
+            REQUIRE( out[C * i + c] == Catch::Approx(y[c]).margin(eps) );
+            REQUIRE( planar[c][i] == out[C * i + c] );
+        }
+    }
+
+    // A frame of batches returns a frame of batches.
+    const auto y = ep.process(packed{ simd_t(T(1)), simd_t(T(2)) });
+    REQUIRE( xsimd::all(y[1] > y[0]) );
+}
+
+TEST_CASE( "lane-packed filter bank", "[filter]" ) {
+    check_batches<float>();
+    check_batches<double>();
+}
@@ -0,0 +1,46 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <vector>
+
+using simd_t = xsimd::make_sized_batch_t<double, 4>;
+using fsimd_t = xsimd::make_sized_batch_t<float, 8>;
+
+TEST_CASE( "simd grid interpolation", "[simd interp]" ) {
+
+    SECTION( "batched bilinear lookups match scalar ones" ) {
+        std::vector<float> v(7 * 5 * 3);
+        for (size_t i = 0; i < v.size(); ++i)
+            v[i] = float((i * 13) % 17);
+        auto g = tpa::make_grid_view<3>(v.data(), std::array<size_t, 2>{7, 5});
+        g.set_axes({-1.0f, 0.0f}, {0.5f, 2.0f});
+        fsimd_t x{-3, -1, -0.8f, 0, 0.3f, 1.1f, 2, 5};
+        fsimd_t y{0, 1, 2.5f, -4, 7.9f, 8, 3.3f, 20};
+        auto r = tpa::interp2<tpa::boundary::wrap>(g, std::make_tuple(x, y));
+        auto xa = tpa::to_array(x), ya = tpa::to_array(y);
+        for (size_t l = 0; l < 8; ++l) {
+            auto s = tpa::interp2<tpa::boundary::wrap>(g, std::make_tuple(xa[l], ya[l]));
+            for (size_t c = 0; c < 3; ++c)
+                REQUIRE( tpa::to_array(r[c])[l] == Catch::Approx(s[c]) );
+        }
+    }
+
+    SECTION( "batched trilinear lookups" ) {
+        const size_t n = 4;
+        std::vector<double> v(n * n * n);
+        for (size_t i = 0; i < v.size(); ++i)
+            v[i] = double(i % n) + 10.0 * double(i / (n * n));
+        auto g = tpa::make_grid_view(v.data(), std::array<size_t, 3>{n, n, n});
+        simd_t x{0.5, 1, -2, 3.25};
+        auto r = tpa::to_array(tpa::interp3(g, std::make_tuple(x, simd_t(1.0), simd_t(0.5))));
+        REQUIRE( r[0] == Catch::Approx(5.5) );
+        REQUIRE( r[1] == Catch::Approx(6.0) );
+        REQUIRE( r[2] == Catch::Approx(5.0) );
+        REQUIRE( r[3] == Catch::Approx(8.0) );
+    }
+}
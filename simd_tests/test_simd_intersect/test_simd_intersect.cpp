@@ -0,0 +1,110 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+template<typename T>
+struct columns3 {
+    std::array<std::vector<T>, 3> data;
+    explicit columns3(size_t n) { for (auto& c : data) c.resize(n); }
+    std::array<T, 3> get(size_t i) const { return {data[0][i], data[1][i], data[2][i]}; }
+    void set(size_t i, const std::array<T, 3>& v) { for (size_t k = 0; k < 3; ++k) data[k][i] = v[k]; }
+    std::array<const T*, 3> cols() const { return {data[0].data(), data[1].data(), data[2].data()}; }
+};
+
+template<typename T>
+void check_intersect(std::mt19937& gen) {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    const size_t n = 1000 + W + 3;
+    std::uniform_real_distribution<T> dist(-1, 1);
+    auto rnd = [&]() { return std::array<T, 3>{dist(gen), dist(gen), dist(gen)}; };
+    auto inv = [](const std::array<T, 3>& d) { return std::array<T, 3>{T(1) / d[0], T(1) / d[1], T(1) / d[2]}; };
+
+    columns3<T> org(n), dir(n), idir(n), lo(n), hi(n), v0(n), v1(n), v2(n);
+    for (size_t i = 0; i < n; ++i) {
+        org.set(i, rnd() * T(3));
+        dir.set(i, rnd());
+        idir.set(i, inv(dir.get(i)));
+        const auto c = rnd(), e = rnd();
+        lo.set(i, c - tpa::abs(e));
+        hi.set(i, c + tpa::abs(e));
+        v0.set(i, rnd());
+        v1.set(i, rnd());
+        v2.set(i, rnd());
+    }
+    // A ray starting among the objects, so that it hits some of them.
+    org.set(0, {T(0.05), T(-0.02), T(0.01)});
+    const auto o = org.get(0), d = dir.get(0), id = idir.get(0);
+    const auto b0 = lo.get(0), b1 = hi.get(0);
+    const auto p0 = v0.get(0), p1 = v1.get(0), p2 = v2.get(0);
+
+    // One ray against n objects.
+    std::vector<T> tb(n), tt(n);
+    size_t box_hits = tpa::intersect_boxes(o, id, lo.cols(), hi.cols(), n, tb.data(), 3);
+    size_t tri_hits = tpa::intersect_triangles(o, d, v0.cols(), v1.cols(), v2.cols(), n, tt.data(), 3);
+    size_t count_b = 0, count_t = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const auto hb = tpa::ray_box(o, id, lo.get(i), hi.get(i));
+        const auto ht = tpa::ray_triangle(o, d, v0.get(i), v1.get(i), v2.get(i));
+        REQUIRE( std::isinf(tb[i]) == !hb.hit );
+        REQUIRE( std::isinf(tt[i]) == !ht.hit );
+        if (hb.hit)
+            REQUIRE( tb[i] == Catch::Approx(hb.t_near) );
+        if (ht.hit)
+            REQUIRE( tt[i] == Catch::Approx(ht.t) );
+        count_b += hb.hit;
+        count_t += ht.hit;
+    }
+    REQUIRE( box_hits == count_b );
+    REQUIRE( tri_hits == count_t );
+    REQUIRE( count_b > 0 );
+    REQUIRE( count_t > 0 );
+
+    // n rays against one object.
+    box_hits = tpa::intersect_rays_box(org.cols(), idir.cols(), n, b0, b1, tb.data(), 2);
+    tri_hits = tpa::intersect_rays_triangle(org.cols(), dir.cols(), n, p0, p1, p2, tt.data(), 2);
+    count_b = count_t = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const auto hb = tpa::ray_box(org.get(i), idir.get(i), b0, b1);
+        const auto ht = tpa::ray_triangle(org.get(i), dir.get(i), p0, p1, p2);
+        REQUIRE( std::isinf(tb[i]) == !hb.hit );
+        REQUIRE( std::isinf(tt[i]) == !ht.hit );
+        count_b += hb.hit;
+        count_t += ht.hit;
+    }
+    REQUIRE( box_hits == count_b );
+    REQUIRE( tri_hits == count_t );
+
+    // Packets: W rays in lanes against one triangle.
+    std::array<simd_t, 3> po, pd;
+    for (size_t k = 0; k < 3; ++k) {
+        po[k] = simd_t::load_unaligned(org.data[k].data());
+        pd[k] = simd_t::load_unaligned(dir.data[k].data());
+    }
+    const auto h = tpa::ray_triangle(po, pd, p0, p1, p2);
+    static_assert(std::is_same_v<decltype(h), const tpa::triangle_hit<simd_t>>);
+    const auto hit = h.hit.mask();
+    const auto t = tpa::to_array(h.t);
+    const auto u = tpa::to_array(h.u);
+    for (size_t l = 0; l < W; ++l) {
+        const auto ref = tpa::ray_triangle(org.get(l), dir.get(l), p0, p1, p2);
+        REQUIRE( bool((hit >> l) & 1) == ref.hit );
+        if (ref.hit) {
+            REQUIRE( t[l] == Catch::Approx(ref.t) );
+            REQUIRE( u[l] == Catch::Approx(ref.u) );
+        }
+    }
+}
+
+TEST_CASE( "simd ray intersection", "[simd intersect]" ) {
+    std::mt19937 gen(39);
+    check_intersect<float>(gen);
+    check_intersect<double>(gen);
+}
@@ -0,0 +1,80 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+template<typename T, size_t D>
+void check_tree(size_t n, unsigned threads, std::mt19937& gen) {
+    using point = std::array<T, D>;
+    std::uniform_real_distribution<T> dist(-1, 1);
+    std::vector<point> pts(n);
+    for (auto& p : pts)
+        for (auto& v : p)
+            v = dist(gen);
+    const tpa::kd_tree<point> tree(pts.data(), n, 16, threads);
+    auto sq = [&](size_t i, const point& q) {
+        double acc = 0;
+        for (size_t k = 0; k < D; ++k)
+            acc += double(pts[i][k] - q[k]) * double(pts[i][k] - q[k]);
+        return acc;
+    };
+
+    for (int t = 0; t < 20; ++t) {
+        point q;
+        for (auto& v : q)
+            v = dist(gen);
+
+        const T r = T(D == 3 ? 0.2 : 0.8);
+        std::vector<size_t> found;
+        tree.radius_query(q, r, found);
+        std::sort(found.begin(), found.end());
+        std::vector<size_t> ref;
+        for (size_t i = 0; i < n; ++i)
+            if (sq(i, q) <= double(r) * double(r) * (1 + 1e-5) and sq(i, q) <= double(r) * double(r) * (1 - 1e-5))
+                ref.push_back(i);
+        // Points within rounding of the sphere may go either way.
+        REQUIRE( std::includes(found.begin(), found.end(), ref.begin(), ref.end()) );
+        for (size_t i : found)
+            REQUIRE( sq(i, q) <= double(r) * double(r) * (1 + 1e-5) );
+
+        point lo = q - T(0.3), hi = q + T(0.3);
+        found.clear();
+        tree.box_query(lo, hi, found);
+        std::sort(found.begin(), found.end());
+        ref.clear();
+        for (size_t i = 0; i < n; ++i)
+            if (std::equal(lo.begin(), lo.end(), pts[i].begin(), std::less_equal<>{}) and
+                std::equal(pts[i].begin(), pts[i].end(), hi.begin(), std::less_equal<>{}))
+                ref.push_back(i);
+        REQUIRE( found == ref );
+
+        constexpr size_t k = 7;
+        std::array<size_t, k> idx;
+        std::array<T, k> d;
+        REQUIRE( tree.knn(q, k, idx.data(), d.data()) == k );
+        std::vector<double> all(n);
+        for (size_t i = 0; i < n; ++i)
+            all[i] = sq(i, q);
+        std::partial_sort(all.begin(), all.begin() + k, all.end());
+        for (size_t j = 0; j < k; ++j) {
+            REQUIRE( d[j] == Catch::Approx(std::sqrt(all[j])).epsilon(1e-4) );
+            REQUIRE( std::sqrt(sq(idx[j], q)) == Catch::Approx(d[j]).epsilon(1e-4) );
+        }
+    }
+}
+
+TEST_CASE( "simd kd tree", "[simd kd_tree]" ) {
+    std::mt19937 gen(38);
+    check_tree<float, 3>(20011, 1, gen);
+    check_tree<float, 3>(20011, 4, gen);
+    check_tree<double, 3>(3001, 2, gen);
+    check_tree<float, 8>(5003, 0, gen);
+    check_tree<double, 2>(17, 1, gen);
+}
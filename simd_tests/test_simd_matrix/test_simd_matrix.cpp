@@ -0,0 +1,97 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <random>
+#include <vector>
+
+using simd_t = xsimd::make_sized_batch_t<double, 4>;
+
+template<typename T, size_t N>
+tpa::mat<T, N> random_mat(std::mt19937& gen) {
+    std::uniform_real_distribution<T> dist(-1, 1);
+    tpa::mat<T, N> m;
+    for (auto& r : m)
+        for (auto& v : r)
+            v = dist(gen);
+    return m;
+}
+
+template<typename T, size_t N>
+tpa::mat<double, N> widen(const tpa::mat<T, N>& m) {
+    return tpa::cast<double>(m);
+}
+
+template<typename T, size_t N>
+void check_simd_matrix(std::mt19937& gen, double eps) {
+    for (int rep = 0; rep < 20; ++rep) {
+        const auto a = random_mat<T, N>(gen);
+        const auto b = random_mat<T, N>(gen);
+        // Reference in double, through the generic (non-SIMD) path of lane-packed batches.
+        tpa::mat<simd_t, N> wa, wb;
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = 0; j < N; ++j) {
+                wa[i][j] = simd_t(double(a[i][j]));
+                wb[i][j] = simd_t(double(b[i][j]));
+            }
+
+        const auto p = tpa::matmul(a, b);
+        const auto wp = tpa::matmul(wa, wb);
+        const auto t = tpa::transpose(a);
+        const auto inv = tpa::inverse(a);
+        const auto winv = tpa::inverse(wa);
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = 0; j < N; ++j) {
+                REQUIRE( p[i][j] == Catch::Approx(tpa::to_array(wp[i][j])[0]).epsilon(eps).margin(eps) );
+                REQUIRE( t[i][j] == a[j][i] );
+                REQUIRE( inv[i][j] == Catch::Approx(tpa::to_array(winv[i][j])[2]).epsilon(eps * 100).margin(eps) );
+            }
+        REQUIRE( tpa::det(a) == Catch::Approx(tpa::to_array(tpa::det(wa))[1]).epsilon(eps).margin(eps) );
+
+        if constexpr (N > 2) {
+            std::array<T, N> v;
+            for (size_t i = 0; i < N; ++i) v[i] = T(i + 1);
+            const auto mv = tpa::matmul(a, v);
+            for (size_t i = 0; i < N; ++i) {
+                double ref = 0;
+                for (size_t k = 0; k < N; ++k) ref += double(a[i][k]) * double(v[k]);
+                REQUIRE( mv[i] == Catch::Approx(ref).epsilon(eps).margin(eps) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "simd matrix operations", "[simd matrix]" ) {
+    std::mt19937 gen(3);
+    check_simd_matrix<float, 2>(gen, 1e-4);
+    check_simd_matrix<float, 3>(gen, 1e-4);
+    check_simd_matrix<float, 4>(gen, 1e-4);
+    check_simd_matrix<double, 3>(gen, 1e-10);
+    check_simd_matrix<double, 4>(gen, 1e-10);
+}
+
+TEST_CASE( "simd bulk point transform", "[simd matrix]" ) {
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<float> dist(-10, 10);
+    const size_t n = 20011;
+    std::vector<float> x(n), y(n), z(n), u(n), v(n), w(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = dist(gen);
+        y[i] = dist(gen);
+        z[i] = dist(gen);
+    }
+    const tpa::mat<double, 4> m{{ {0.5, 2, 0, 1}, {0, 1, 3, -2}, {2, 0, 1, 0.5}, {0.01, 0.02, 0.03, 20} }};
+    for (unsigned threads : {1u, 4u}) {
+        tpa::transform_points(m, std::tuple{x.data(), y.data(), z.data()}, std::array{u.data(), v.data(), w.data()}, n, threads);
+        for (size_t i = 0; i < n; ++i) {
+            const auto r = tpa::matmul(m, std::array<double, 4>{x[i], y[i], z[i], 1.0});
+            REQUIRE( u[i] == Catch::Approx(r[0] / r[3]).epsilon(1e-5).margin(1e-5) );
+            REQUIRE( v[i] == Catch::Approx(r[1] / r[3]).epsilon(1e-5).margin(1e-5) );
+            REQUIRE( w[i] == Catch::Approx(r[2] / r[3]).epsilon(1e-5).margin(1e-5) );
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <tuple_math.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+template<typename T, size_t D>
+struct point_set {
+    std::array<std::vector<T>, D> data;
+    point_set(size_t n, std::mt19937& gen) {
+        std::uniform_real_distribution<T> dist(-1, 1);
+        for (auto& c : data) {
+            c.resize(n);
+            for (auto& v : c)
+                v = dist(gen);
+        }
+    }
+    std::array<const T*, D> cols() const {
+        std::array<const T*, D> ret;
+        for (size_t k = 0; k < D; ++k)
+            ret[k] = data[k].data();
+        return ret;
+    }
+    std::array<double, D> point(size_t i) const {
+        std::array<double, D> ret;
+        for (size_t k = 0; k < D; ++k)
+            ret[k] = data[k][i];
+        return ret;
+    }
+};
+
+template<size_t L, bool Root, typename T, size_t D>
+void check_pairwise(const point_set<T, D>& a, size_t na, const point_set<T, D>& b, size_t nb) {
+    std::vector<T> out(na * nb);
+    tpa::pairwise_distances<L, Root>(a.cols(), na, b.cols(), nb, out.data(), 4);
+    for (size_t i = 0; i < na; ++i)
+        for (size_t j = 0; j < nb; ++j) {
+            const auto d = a.point(i) - b.point(j);
+            const double ref = Root ? tpa::norm<L>(d) : std::pow(tpa::norm<L>(d), double(L));
+            REQUIRE( out[i * nb + j] == Catch::Approx(ref).epsilon(1e-4) );
+        }
+}
+
+template<typename T, size_t D>
+void check_knn(std::mt19937& gen) {
+    const size_t n = 2003, nq = 37, k = 9;
+    const point_set<T, D> points(n, gen), queries(nq, gen);
+    std::vector<size_t> idx(nq * k);
+    std::vector<T> dist(nq * k);
+    tpa::knn<2, false>(queries.cols(), nq, points.cols(), n, k, idx.data(), dist.data(), 0);
+    for (size_t q = 0; q < nq; ++q) {
+        std::vector<double> ref(n);
+        for (size_t j = 0; j < n; ++j) {
+            const auto d = queries.point(q) - points.point(j);
+            ref[j] = tpa::dot(d, d);
+        }
+        std::vector<double> sorted = ref;
+        std::nth_element(sorted.begin(), sorted.begin() + k - 1, sorted.end());
+        const double kth = sorted[k - 1];
+        REQUIRE( std::is_sorted(dist.begin() + q * k, dist.begin() + (q + 1) * k) );
+        REQUIRE( dist[q * k + k - 1] == Catch::Approx(kth).epsilon(1e-4) );
+        for (size_t r = 0; r < k; ++r) {
+            REQUIRE( idx[q * k + r] < n );
+            REQUIRE( dist[q * k + r] == Catch::Approx(ref[idx[q * k + r]]).epsilon(1e-4) );
+        }
+
+        // The single-query overload agrees with the batch.
+        std::array<size_t, k> i1;
+        std::array<T, k> d1;
+        REQUIRE( tpa::knn<2, false>(queries.point(q), points.cols(), n, k, i1.data(), d1.data()) == k );
+        for (size_t r = 0; r < k; ++r) {
+            REQUIRE( i1[r] == idx[q * k + r] );
+            REQUIRE( d1[r] == dist[q * k + r] );
+        }
+    }
+}
+
+TEST_CASE( "simd pairwise distances", "[simd neighbors]" ) {
+    std::mt19937 gen(37);
+    const point_set<float, 3> a(23, gen), b(1031, gen);
+    check_pairwise<1, true>(a, 23, b, 1031);
+    check_pairwise<2, true>(a, 23, b, 1031);
+    check_pairwise<2, false>(a, 23, b, 1031);
+    check_pairwise<3, true>(a, 23, b, 1031);
+    const point_set<double, 8> c(9, gen), d(101, gen);
+    check_pairwise<2, true>(c, 9, d, 101);
+    check_pairwise<4, true>(c, 9, d, 101);
+}
+
+TEST_CASE( "simd knn", "[simd neighbors]" ) {
+    std::mt19937 gen(38);
+    check_knn<float, 3>(gen);
+    check_knn<float, 8>(gen);
+    check_knn<double, 3>(gen);
+}
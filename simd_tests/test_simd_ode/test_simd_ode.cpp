@@ -0,0 +1,82 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+
+template<typename T>
+void check_lane_packed() {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    // Lane l integrates an oscillator of angular frequency w[l].
+    std::array<T, W> wl;
+    for (size_t l = 0; l < W; ++l)
+        wl[l] = T(1) + T(l);
+    const simd_t w = simd_t::load_unaligned(wl.data());
+    auto f = [w](const simd_t&, const std::array<simd_t, 2>& y) {
+        return std::array<simd_t, 2>{y[1], -w * w * y[0]};
+    };
+    const std::array<simd_t, 2> y0{simd_t(T(1)), simd_t(T(0))};
+    const T tol = std::is_same_v<T, float> ? T(1e-3) : T(1e-6);
+
+    // Fixed step, with per-lane step sizes.
+    const auto y4 = tpa::rk4(f, simd_t(T(0)), y0, simd_t(T(1)) / (w * T(200)), 200);
+    const auto x4 = tpa::to_array(y4[0]);
+    for (size_t l = 0; l < W; ++l)
+        REQUIRE( x4[l] == Catch::Approx(std::cos(T(1))).margin(tol) );
+
+    // Adaptive: fast lanes need more steps, and every lane ends at t1.
+    const auto r = tpa::rk45(f, T(0), T(2), y0, T(0.01), T(std::is_same_v<T, float> ? 1e-5 : 1e-9), T(1e-9));
+    REQUIRE( xsimd::all(r.done) );
+    REQUIRE( xsimd::all(r.t == simd_t(T(2))) );
+    const auto x = tpa::to_array(r.y[0]);
+    const auto v = tpa::to_array(r.y[1]);
+    for (size_t l = 0; l < W; ++l) {
+        REQUIRE( x[l] == Catch::Approx(std::cos(T(2) * wl[l])).margin(tol * wl[l]) );
+        REQUIRE( v[l] == Catch::Approx(-wl[l] * std::sin(T(2) * wl[l])).margin(tol * wl[l] * wl[l]) );
+    }
+
+    // Forward and backward lanes in one integration.
+    std::array<T, W> ends;
+    for (size_t l = 0; l < W; ++l)
+        ends[l] = l % 2 ? T(-1) - T(l) / T(W) : T(1);
+    auto growth = [](const simd_t&, const std::array<simd_t, 1>& y) { return y; };
+    const auto g = tpa::rk45(growth, simd_t(T(0)), simd_t::load_unaligned(ends.data()), std::array{simd_t(T(1))},
+        simd_t(T(0.1)), simd_t(T(std::is_same_v<T, float> ? 1e-5 : 1e-9)), simd_t(T(1e-9)));
+    REQUIRE( xsimd::all(g.done) );
+    const auto gt = tpa::to_array(g.t);
+    const auto gy = tpa::to_array(g.y[0]);
+    for (size_t l = 0; l < W; ++l) {
+        REQUIRE( gt[l] == ends[l] );
+        REQUIRE( gy[l] == Catch::Approx(std::exp(ends[l])).epsilon(tol) );
+    }
+
+    // Lane-wise acceptance: the same step is too large only for fast lanes.
+    const T h = std::is_same_v<T, float> ? T(0.1) : T(0.05);
+    const T stol = std::is_same_v<T, float> ? T(1e-5) : T(1e-7);
+    const auto s = tpa::rk45_step(f, T(0), y0, h, stol, stol);
+    const auto ok = s.accepted.mask();
+    const auto t = tpa::to_array(s.t);
+    REQUIRE( (ok & 1) );
+    REQUIRE( not ((ok >> (W - 1)) & 1) );
+    for (size_t l = 0; l < W; ++l)
+        REQUIRE( t[l] == (((ok >> l) & 1) ? h : T(0)) );
+
+    // Symplectic steppers, one oscillator per lane.
+    auto accel = [w](const std::array<simd_t, 1>& p) { return std::array<simd_t, 1>{-w * w * p[0]}; };
+    const auto [px, pv] = tpa::velocity_verlet(accel, std::array{simd_t(T(1))}, std::array{simd_t(T(0))}, T(0.001), 1000);
+    const auto [qx, qv] = tpa::leapfrog(accel, std::array{simd_t(T(1))}, std::array{simd_t(T(0))}, T(0.001), 1000);
+    const auto a = tpa::to_array(px[0]), b = tpa::to_array(qx[0]);
+    for (size_t l = 0; l < W; ++l) {
+        REQUIRE( a[l] == Catch::Approx(std::cos(wl[l])).margin(tol * 10 * wl[l] * wl[l]) );
+        REQUIRE( b[l] == Catch::Approx(std::cos(wl[l])).margin(tol * 10 * wl[l] * wl[l]) );
+    }
+}
+
+TEST_CASE( "simd lane-packed ode integrators", "[simd ode]" ) {
+    check_lane_packed<float>();
+    check_lane_packed<double>();
+}
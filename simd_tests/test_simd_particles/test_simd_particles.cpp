@@ -0,0 +1,88 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+template<typename T>
+struct particles {
+    std::array<std::vector<T>, 3> x, a;
+    std::vector<T> m;
+    particles(size_t n, T extent, std::mt19937& gen) : m(n) {
+        std::uniform_real_distribution<T> dist(0, extent);
+        for (size_t k = 0; k < 3; ++k) {
+            x[k].resize(n);
+            a[k].resize(n);
+            for (auto& v : x[k])
+                v = dist(gen);
+        }
+        for (auto& v : m)
+            v = T(0.5) + dist(gen) / extent;
+    }
+    std::array<T*, 3> pos() { return {x[0].data(), x[1].data(), x[2].data()}; }
+    std::array<T*, 3> acc() { return {a[0].data(), a[1].data(), a[2].data()}; }
+};
+
+template<typename T>
+void check_gravity(std::mt19937& gen) {
+    const size_t n = 1500;
+    particles<T> p(n, T(10), gen);
+    const T eps = T(0.1);
+    tpa::nbody_accelerations(p.pos(), p.m.data(), n, p.acc(), T(1), eps, 4);
+    for (size_t i = 0; i < n; i += 7) {
+        std::array<double, 3> ref{0, 0, 0};
+        for (size_t j = 0; j < n; ++j) {
+            std::array<double, 3> d;
+            double r2 = double(eps) * double(eps);
+            for (size_t k = 0; k < 3; ++k) {
+                d[k] = double(p.x[k][j]) - double(p.x[k][i]);
+                r2 += d[k] * d[k];
+            }
+            const double s = double(p.m[j]) / (r2 * std::sqrt(r2));
+            for (size_t k = 0; k < 3; ++k)
+                ref[k] += s * d[k];
+        }
+        for (size_t k = 0; k < 3; ++k)
+            REQUIRE( p.a[k][i] == Catch::Approx(ref[k]).epsilon(1e-3).margin(1e-2) );
+    }
+}
+
+template<typename T>
+void check_pair_forces(std::mt19937& gen) {
+    const size_t n = 4000;
+    particles<T> p(n, T(20), gen);
+    const T rc = T(1.2);
+    // Soft repulsion (rc^2 - r^2) / r^2 on the separation vector.
+    auto force = [rc](auto r2) { return (rc * rc - r2) / r2; };
+    const tpa::cell_list<T> cells(p.pos(), n, rc);
+    REQUIRE( cells.cell_count() > 1000 );
+    tpa::pair_forces(cells, rc, force, p.acc(), 3);
+    for (size_t i = 0; i < n; i += 5) {
+        std::array<double, 3> ref{0, 0, 0};
+        for (size_t j = 0; j < n; ++j) {
+            std::array<double, 3> d;
+            double r2 = 0;
+            for (size_t k = 0; k < 3; ++k) {
+                d[k] = double(p.x[k][i]) - double(p.x[k][j]);
+                r2 += d[k] * d[k];
+            }
+            if (r2 > 0 and r2 < double(rc) * double(rc))
+                for (size_t k = 0; k < 3; ++k)
+                    ref[k] += (double(rc) * double(rc) - r2) / r2 * d[k];
+        }
+        for (size_t k = 0; k < 3; ++k)
+            REQUIRE( p.a[k][i] == Catch::Approx(ref[k]).epsilon(1e-3).margin(1e-2) );
+    }
+}
+
+TEST_CASE( "simd particle kernels", "[simd particles]" ) {
+    std::mt19937 gen(41);
+    check_gravity<float>(gen);
+    check_gravity<double>(gen);
+    check_pair_forces<float>(gen);
+    check_pair_forces<double>(gen);
+}
@@ -0,0 +1,101 @@
+#include <tuple_arithmetic.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <array>
+#include <type_traits>
+#include <utility>
+
+template<typename T>
+auto iota_batch(T start) {
+    using simd_t = xsimd::batch<T>;
+    std::array<T, simd_t::size> v;
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = start + T(i);
+    return simd_t::load_unaligned(v.data());
+}
+
+template<typename T>
+void check_lanes() {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    const auto x = iota_batch<T>(0);
+    const auto y = iota_batch<T>(T(W));
+
+    const auto r = tpa::to_array(tpa::reverse_lanes(x));
+    const auto rot = tpa::to_array(tpa::rotate_lanes<1>(x));
+    const auto bc = tpa::to_array(tpa::broadcast_lane<W - 1>(x));
+    for (size_t i = 0; i < W; ++i) {
+        REQUIRE(r[i] == T(W - 1 - i));
+        REQUIRE(rot[i] == T((i + 1) % W));
+        REQUIRE(bc[i] == T(W - 1));
+    }
+
+    const auto sw = [&]<size_t...I>(std::index_sequence<I...>) {
+        return tpa::permute<(I ^ 1)...>(x);
+    }(std::make_index_sequence<W>{});
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(sw)>, simd_t>);
+    const auto swa = tpa::to_array(sw);
+    for (size_t i = 0; i < W; ++i)
+        REQUIRE(swa[i] == T(i ^ 1));
+
+    // Fewer lanes than the batch: an std::array.
+    const auto f = tpa::firstN<2>(x);
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(f)>, std::array<T, 2>>);
+    REQUIRE(f[0] == T(0));
+    REQUIRE(f[1] == T(1));
+    const auto p = tpa::permute<W - 1, 0>(x);
+    REQUIRE(p[0] == T(W - 1));
+    REQUIRE(p[1] == T(0));
+
+    // Lanes of y are numbered from W.
+    const auto s = tpa::to_array([&]<size_t...I>(std::index_sequence<I...>) {
+        return tpa::shuffle<(I % 2 == 0 ? I / 2 : W + I / 2)...>(x, y);
+    }(std::make_index_sequence<W>{}));
+    for (size_t i = 0; i < W; ++i)
+        REQUIRE(s[i] == T(i % 2 == 0 ? i / 2 : W + i / 2));
+
+    const auto [lo, hi] = tpa::interleave(x, y);
+    const auto l = tpa::to_array(lo);
+    const auto h = tpa::to_array(hi);
+    for (size_t i = 0; i < W / 2; ++i) {
+        REQUIRE(l[2 * i] == T(i));
+        REQUIRE(l[2 * i + 1] == T(W + i));
+        REQUIRE(h[2 * i] == T(W / 2 + i));
+        REQUIRE(h[2 * i + 1] == T(W + W / 2 + i));
+    }
+    const auto [a, b] = tpa::deinterleave(lo, hi);
+    REQUIRE(xsimd::all(a == x));
+    REQUIRE(xsimd::all(b == y));
+}
+
+TEST_CASE("Batch lane permutations", "[permute]") {
+    check_lanes<float>();
+    check_lanes<double>();
+    check_lanes<int32_t>();
+}
+
+TEST_CASE("Permutations of tuple temporaries", "[permute]") {
+    // Temporaries that fit in a batch are permuted in registers and returned by value.
+    const auto a = tpa::permute<3, 2, 1, 0>(std::array<float, 4>{1, 2, 3, 4});
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(a)>, std::array<float, 4>>);
+    REQUIRE(a == std::array<float, 4>{4, 3, 2, 1});
+
+    const auto d = tpa::rotate_lanes<1>(std::array<double, 4>{1, 2, 3, 4});
+    REQUIRE(d == std::array<double, 4>{2, 3, 4, 1});
+    REQUIRE(tpa::reverse_lanes(std::array<double, 2>{1, 2}) == std::array<double, 2>{2, 1});
+    REQUIRE(tpa::broadcast_lane<2>(std::array<float, 4>{1, 2, 3, 4}) == std::array<float, 4>{3, 3, 3, 3});
+
+    const auto f = tpa::firstN<3>(std::array<float, 4>{1, 2, 3, 4});
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(f)>, std::array<float, 3>>);
+    REQUIRE(f == std::array<float, 3>{1, 2, 3});
+
+    // Lvalues keep reference semantics.
+    std::array<float, 4> v{1, 2, 3, 4};
+    tpa::permute<3, 0>(v) = std::make_tuple(10.f, 20.f);
+    REQUIRE(v == std::array<float, 4>{20, 2, 3, 10});
+    get<0>(tpa::firstN<2>(v)) = 5;
+    REQUIRE(v[0] == 5);
+}
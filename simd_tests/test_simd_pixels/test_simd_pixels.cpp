@@ -0,0 +1,81 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+template<typename T>
+void check_lanes() {
+    // Every batch operation against the scalar one, lane by lane.
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    std::array<T, W> x, y;
+    for (size_t r = 0; r < 64; ++r) {
+        for (size_t l = 0; l < W; ++l) {
+            x[l] = T((r * 977 + l * 131) * 40503u >> 3);
+            y[l] = T((r * 613 + l * 37) * 2654435761u >> 7);
+        }
+        if (r == 0) {
+            x.fill(std::numeric_limits<T>::max());
+            y.fill(std::numeric_limits<T>::min());
+            y[0] = std::numeric_limits<T>::max();
+        }
+        const simd_t a = simd_t::load_unaligned(x.data());
+        const simd_t b = simd_t::load_unaligned(y.data());
+        const auto add = tpa::to_array(tpa::sat_add(a, b));
+        const auto sub = tpa::to_array(tpa::sat_sub(a, b));
+        const auto av = tpa::to_array(tpa::avg(a, b));
+        const auto hi = tpa::to_array(tpa::mulhi(a, b));
+        const auto w = tpa::widen(a);
+        const auto w0 = tpa::to_array(w[0]);
+        const auto w1 = tpa::to_array(w[1]);
+        const auto back = tpa::to_array(tpa::narrow_sat(w[0], w[1]));
+        const auto wb = tpa::widen(b);
+        const auto packed = tpa::to_array(tpa::narrow_sat(w[0] * wb[0], w[1] * wb[1]));
+        for (size_t l = 0; l < W; ++l) {
+            REQUIRE( add[l] == tpa::sat_add(x[l], y[l]) );
+            REQUIRE( sub[l] == tpa::sat_sub(x[l], y[l]) );
+            REQUIRE( av[l] == tpa::avg(x[l], y[l]) );
+            REQUIRE( hi[l] == tpa::mulhi(x[l], y[l]) );
+            REQUIRE( (l < W / 2 ? w0[l] : w1[l - W / 2]) == tpa::widen(x[l]) );
+            REQUIRE( back[l] == x[l] );
+            REQUIRE( packed[l] == tpa::narrow_sat(decltype(tpa::widen(x[l]))(tpa::widen(x[l]) * tpa::widen(y[l]))) );
+        }
+    }
+}
+
+TEST_CASE( "vectorized pixel arithmetic", "[pixels]" ) {
+    check_lanes<uint8_t>();
+    check_lanes<int8_t>();
+    check_lanes<uint16_t>();
+    check_lanes<int16_t>();
+
+    SECTION( "tuples of batches" ) {
+        using simd_t = xsimd::batch<uint8_t>;
+        const auto p = std::tuple{ simd_t(200), simd_t(100), simd_t(3) };
+        const auto s = tpa::to_array(get<0>(tpa::sat_add(p, simd_t(100))));
+        for (auto v : s)
+            REQUIRE( v == 255 );
+        const auto w = tpa::widen(p);
+        const auto n = tpa::narrow_sat(std::tuple{ get<0>(w)[0], get<1>(w)[0] }, std::tuple{ get<0>(w)[1], get<1>(w)[1] });
+        REQUIRE( tpa::to_array(get<1>(n))[0] == 100 );
+    }
+
+    SECTION( "arrays of pixels" ) {
+        using px = std::tuple<uint16_t, uint16_t, uint16_t>;
+        const size_t n = 100003;
+        std::vector<px> a(n), b(n), out(n), ref(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = px{ uint16_t(i * 7), uint16_t(i * 11 + 60000), uint16_t(i) };
+            b[i] = px{ uint16_t(i * 3), uint16_t(i * 5), uint16_t(65535 - i) };
+            const auto r = tpa::sat_sub(a[i], b[i]);
+            ref[i] = px{ r[0], r[1], r[2] };
+        }
+        tpa::transform_pixels(a.data(), b.data(), out.data(), n, [](auto x, auto y) { return tpa::sat_sub(x, y); }, 0);
+        REQUIRE( (out == ref) );
+    }
+}
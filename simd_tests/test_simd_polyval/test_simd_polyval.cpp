@@ -0,0 +1,35 @@
+#include <tuple_arithmetic.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+using simd_t = xsimd::make_sized_batch_t<double, 4>;
+using fsimd_t = xsimd::make_sized_batch_t<float, 8>;
+
+TEST_CASE( "simd polynomial evaluation", "[simd polyval]" ) {
+
+    SECTION( "batch" ) {
+        simd_t x{-1, 0, 0.5, 2};
+        auto a = tpa::to_array(tpa::polyval<1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0>(x));
+        for (size_t i = 0; i < 4; ++i)
+            REQUIRE( a[i] == Catch::Approx(tpa::polyval<1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0>(tpa::to_array(x)[i])) );
+        auto b = tpa::polyval(std::make_tuple(1.0, -1.0), x);
+        REQUIRE( tpa::to_array(b) == std::array<double, 4>{2, 1, 0.5, -1} );
+    }
+
+    SECTION( "same type tuple" ) {
+        std::array<float, 8> x{0, 1, 2, 3, 4, 5, 6, 7};
+        auto a = tpa::polyval<0.0f, 0.0f, 1.0f>(x);
+        REQUIRE( std::is_same_v<decltype(a), std::array<float, 8>> );
+        REQUIRE( a == std::array<float, 8>{0, 1, 4, 9, 16, 25, 36, 49} );
+    }
+
+    SECTION( "tuple of batches" ) {
+        auto t = std::make_tuple(simd_t(1.0), fsimd_t(2.0f));
+        auto r = tpa::polyval<1.0, 1.0>(t);
+        REQUIRE( tpa::to_array(std::get<0>(r))[0] == 2.0 );
+        REQUIRE( tpa::to_array(std::get<1>(r))[7] == 3.0f );
+    }
+}
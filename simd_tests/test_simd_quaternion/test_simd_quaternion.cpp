@@ -0,0 +1,77 @@
+#include <tuple_arithmetic.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <random>
+
+template<typename T>
+tpa::quat<T> random_quat(std::mt19937& gen) {
+    std::normal_distribution<T> dist;
+    tpa::quat<T> q{dist(gen), dist(gen), dist(gen), dist(gen)};
+    return q / std::sqrt(tpa::dot(q, q));
+}
+
+template<typename T>
+void check_quaternions(std::mt19937& gen, double eps) {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    std::uniform_real_distribution<T> dist(-2, 2);
+    std::array<tpa::quat<T>, W> a, b;
+    std::array<std::array<T, 3>, W> v;
+    for (size_t l = 0; l < W; ++l) {
+        a[l] = random_quat<T>(gen);
+        b[l] = random_quat<T>(gen);
+        v[l] = {dist(gen), dist(gen), dist(gen)};
+    }
+    // Lane-packed: one quaternion per lane.
+    tpa::quat<simd_t> pa, pb;
+    std::array<simd_t, 3> pv;
+    for (size_t k = 0; k < 4; ++k) {
+        std::array<T, W> la, lb;
+        for (size_t l = 0; l < W; ++l) { la[l] = a[l][k]; lb[l] = b[l][k]; }
+        pa[k] = simd_t::load_unaligned(la.data());
+        pb[k] = simd_t::load_unaligned(lb.data());
+    }
+    for (size_t k = 0; k < 3; ++k) {
+        std::array<T, W> lv;
+        for (size_t l = 0; l < W; ++l) lv[l] = v[l][k];
+        pv[k] = simd_t::load_unaligned(lv.data());
+    }
+    const auto pm = tpa::quat_mul(pa, pb);
+    const auto pr = tpa::quat_rotate(pa, pv);
+    const auto ps = tpa::slerp(pa, pb, simd_t(T(0.3)));
+    const auto pq = tpa::quat_from_mat(tpa::quat_to_mat(pa));
+
+    for (size_t l = 0; l < W; ++l) {
+        // Single quaternions, through the 4-lane kernels.
+        const auto m = tpa::quat_mul(a[l], b[l]);
+        const auto r = tpa::quat_rotate(a[l], v[l]);
+        const auto s = tpa::slerp(a[l], b[l], T(0.3));
+        const auto c = tpa::quat_conjugate(a[l]);
+        const auto rm = tpa::matmul(tpa::quat_to_mat(a[l]), v[l]);
+        const auto back = tpa::quat_rotate(c, r);
+        const auto sign = tpa::to_array(pq[3])[l] * a[l][3] < 0 ? T(-1) : T(1);
+        for (size_t k = 0; k < 4; ++k) {
+            REQUIRE( m[k] == Catch::Approx(tpa::to_array(pm[k])[l]).epsilon(eps).margin(eps) );
+            REQUIRE( s[k] == Catch::Approx(tpa::to_array(ps[k])[l]).epsilon(eps).margin(eps) );
+            REQUIRE( c[k] == (k < 3 ? -a[l][k] : a[l][k]) );
+            REQUIRE( sign * tpa::to_array(pq[k])[l] == Catch::Approx(a[l][k]).epsilon(eps).margin(eps) );
+        }
+        for (size_t k = 0; k < 3; ++k) {
+            REQUIRE( r[k] == Catch::Approx(tpa::to_array(pr[k])[l]).epsilon(eps).margin(eps) );
+            REQUIRE( r[k] == Catch::Approx(rm[k]).epsilon(eps).margin(eps) );
+            REQUIRE( back[k] == Catch::Approx(v[l][k]).epsilon(eps).margin(eps) );
+        }
+    }
+}
+
+TEST_CASE( "simd quaternions", "[simd quaternion]" ) {
+    std::mt19937 gen(11);
+    for (int rep = 0; rep < 50; ++rep) {
+        check_quaternions<float>(gen, 1e-4);
+        check_quaternions<double>(gen, 1e-10);
+    }
+}
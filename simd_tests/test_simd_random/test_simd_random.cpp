@@ -0,0 +1,71 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+template<typename T>
+void check_batches() {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+
+    // A batch of uniforms is W scalar draws.
+    tpa::philox g(9, 1), h(9, 1);
+    const auto u = tpa::to_array(tpa::uniform<simd_t>(g));
+    for (size_t l = 0; l < W; ++l)
+        REQUIRE( u[l] == tpa::uniform<T>(h) );
+    REQUIRE( g.position() == h.position() );
+
+    // Normals and exponentials agree with the scalar ones up to rounding.
+    const auto z = tpa::to_array(tpa::normal<simd_t>(g));
+    const auto e = tpa::to_array(tpa::exponential<simd_t>(g, T(4)));
+    std::array<T, W> u1, u2, u3;
+    for (size_t l = 0; l < W; ++l)
+        u1[l] = tpa::uniform<T>(h);
+    for (size_t l = 0; l < W; ++l)
+        u2[l] = tpa::uniform<T>(h);
+    for (size_t l = 0; l < W; ++l)
+        u3[l] = tpa::uniform<T>(h);
+    const T eps = std::is_same_v<T, float> ? T(1e-4) : T(1e-10);
+    for (size_t l = 0; l < W; ++l) {
+        const T zs = std::sqrt(T(-2) * std::log(T(1) - u1[l])) * std::cos(T(2) * std::numbers::pi_v<T> * u2[l]);
+        REQUIRE( z[l] == Catch::Approx(zs).epsilon(eps).margin(eps) );
+        REQUIRE( e[l] == Catch::Approx(-std::log(T(1) - u3[l]) / T(4)).epsilon(eps) );
+    }
+
+    // Tuples of batches.
+    const auto t = tpa::uniform<std::array<simd_t, 2>>(g, T(-1), T(1));
+    REQUIRE( xsimd::all(t[0] >= simd_t(T(-1)) & t[0] < simd_t(T(1))) );
+    REQUIRE( xsimd::all(t[1] >= simd_t(T(-1)) & t[1] < simd_t(T(1))) );
+
+    // Bulk fills: partial last batches, thread independence and moments.
+    const size_t n = 50003;
+    std::vector<T> a(n), b(n);
+    tpa::philox ga(21), gb(21);
+    tpa::fill_normal(ga, a.data(), n, T(2), T(3));
+    tpa::fill_normal(gb, b.data(), n, T(2), T(3), 4);
+    REQUIRE( (a == b) );
+    double s = 0, s2 = 0;
+    for (T x : a) {
+        s += x;
+        s2 += double(x) * x;
+    }
+    const double m = s / double(n);
+    REQUIRE( m == Catch::Approx(2.0).margin(0.06) );
+    REQUIRE( s2 / double(n) - m * m == Catch::Approx(9.0).margin(0.2) );
+
+    tpa::fill_uniform(ga, a.data(), n, T(0), T(1), 3);
+    tpa::philox gc(21);
+    gc.seek(gb.position());
+    for (size_t i = 0; i < W; ++i)
+        REQUIRE( a[i] == tpa::uniform<T>(gc) );
+}
+
+TEST_CASE( "batched variates", "[random]" ) {
+    check_batches<float>();
+    check_batches<double>();
+}
@@ -0,0 +1,68 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+
+template<typename T>
+void check_batches() {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    const T eps = std::is_same_v<T, float> ? T(1e-5) : T(1e-13);
+
+    // Cube roots of 1, 2, ..., W, with lane 0 failing on a zero derivative.
+    std::array<T, W> c, x0;
+    for (size_t l = 0; l < W; ++l) {
+        c[l] = T(l + 1);
+        x0[l] = l == 0 ? T(0) : T(l);
+    }
+    const simd_t cb = simd_t::load_unaligned(c.data());
+    auto f = [&](const simd_t& x) { return x * x * x - cb; };
+    auto df = [](const simd_t& x) { return T(3) * x * x; };
+    const auto r = tpa::newton(f, df, simd_t::load_unaligned(x0.data()));
+    const auto x = tpa::to_array(r.x);
+    const auto mask = r.converged.mask();
+    REQUIRE( (mask & 1) == 0 );
+    for (size_t l = 1; l < W; ++l) {
+        REQUIRE( ((mask >> l) & 1) );
+        REQUIRE( x[l] == Catch::Approx(std::cbrt(c[l])).epsilon(eps) );
+        // Every lane gets the same answer as alone.
+        REQUIRE( x[l] == tpa::newton([&](T v) { return v * v * v - c[l]; }, [](T v) { return T(3) * v * v; }, x0[l]).x );
+    }
+
+    const auto h = tpa::halley(f, df, [](const simd_t& v) { return T(6) * v; }, simd_t(T(1)));
+    REQUIRE( xsimd::all(h.converged) );
+    REQUIRE( xsimd::all(abs(h.x * h.x * h.x - cb) <= cb * simd_t(T(4) * eps)) );
+
+    // Systems of batches: intersections of circles of radius c with y = x.
+    auto g = [&](const std::array<simd_t, 2>& v) { return std::array{v[0] * v[0] + v[1] * v[1] - cb * cb, v[1] - v[0]}; };
+    auto dg = [](const std::array<simd_t, 2>& v) {
+        return tpa::mat<simd_t, 2>{{ {T(2) * v[0], T(2) * v[1]}, {simd_t(T(-1)), simd_t(T(1))} }};
+    };
+    const auto s = tpa::newton(g, dg, std::array{simd_t(T(1)), simd_t(T(0.5))});
+    REQUIRE( xsimd::all(s.converged) );
+    const auto sx = tpa::to_array(s.x[0]);
+    for (size_t l = 0; l < W; ++l)
+        REQUIRE( sx[l] == Catch::Approx(c[l] * std::sqrt(T(0.5))).epsilon(eps) );
+
+    // ITP with brackets of different widths and one lane without a root.
+    std::array<T, W> hi;
+    for (size_t l = 0; l < W; ++l)
+        hi[l] = l == W - 1 ? T(0.5) : T(2 * l + 2);
+    const auto b = tpa::itp([&](const simd_t& v) { return v * v * v - cb; }, simd_t(T(0)), simd_t::load_unaligned(hi.data()));
+    const auto bx = tpa::to_array(b.x);
+    const auto bm = b.converged.mask();
+    REQUIRE( ((bm >> (W - 1)) & 1) == 0 );
+    for (size_t l = 0; l + 1 < W; ++l) {
+        REQUIRE( ((bm >> l) & 1) );
+        REQUIRE( bx[l] == Catch::Approx(std::cbrt(c[l])).epsilon(eps) );
+    }
+}
+
+TEST_CASE( "batched root finding", "[roots]" ) {
+    check_batches<float>();
+    check_batches<double>();
+}
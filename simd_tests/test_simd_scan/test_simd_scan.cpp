@@ -0,0 +1,41 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <vector>
+
+using simd_t = xsimd::make_sized_batch_t<double, 4>;
+using fsimd_t = xsimd::make_sized_batch_t<float, 8>;
+
+TEST_CASE( "simd scan", "[simd scan]" ) {
+
+    SECTION( "batch scan" ) {
+        auto a = tpa::to_array(tpa::inclusive_scan(simd_t{1, 2, 3, 4}));
+        REQUIRE(a == std::array<double, 4>{1, 3, 6, 10});
+        auto b = tpa::to_array(tpa::exclusive_scan(fsimd_t{1, 1, 1, 1, 2, 2, 2, 2}, 1));
+        REQUIRE(b == std::array<float, 8>{1, 2, 3, 4, 5, 7, 9, 11});
+    }
+
+    SECTION( "same type tuple" ) {
+        auto a = tpa::inclusive_scan(std::array<float, 8>{1, 2, 3, 4, 5, 6, 7, 8});
+        REQUIRE(a == std::array<float, 8>{1, 3, 6, 10, 15, 21, 28, 36});
+    }
+
+    SECTION( "bulk float array" ) {
+        const size_t n = 1027;
+        std::vector<float> v(n, 1.0f), out(n);
+        tpa::inclusive_scan(v.data(), out.data(), n);
+        for (size_t i = 0; i < n; ++i) REQUIRE(out[i] == float(i + 1));
+        tpa::exclusive_scan(v.data(), v.data(), n, 0.0f);
+        for (size_t i = 0; i < n; ++i) REQUIRE(v[i] == float(i));
+    }
+
+    SECTION( "bulk simd records" ) {
+        std::vector<std::array<double, 4>> r(9, std::array<double, 4>{1, 2, 3, 4});
+        tpa::inclusive_scan(r.data(), r.data(), r.size());
+        REQUIRE(r[8] == std::array<double, 4>{9, 18, 27, 36});
+    }
+}
@@ -0,0 +1,71 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <vector>
+
+using simd_t = xsimd::make_sized_batch_t<double, 4>;
+using isimd_t = xsimd::make_sized_batch_t<int64_t, 4>;
+
+TEST_CASE( "simd scatter add", "[simd scatter]" ) {
+
+    SECTION( "conflicting lanes" ) {
+        std::array<double, 4> hist{1, 1, 1, 1};
+        tpa::scatter_add(hist.data(), isimd_t{2, 0, 2, 2}, simd_t{1, 2, 3, 4});
+        REQUIRE(hist[0] == 3.0);
+        REQUIRE(hist[1] == 1.0);
+        REQUIRE(hist[2] == 9.0);
+        REQUIRE(hist[3] == 1.0);
+
+        tpa::scatter_add(hist.data(), isimd_t{3}, 1);
+        REQUIRE(hist[3] == 5.0);
+    }
+
+    SECTION( "index and value types differ" ) {
+        std::array<float, 4> hist{};
+        auto idx = xsimd::make_sized_batch_t<int32_t, 4>{1, 1, 0, 1};
+        tpa::scatter_add(hist.data(), idx, std::tuple{1, 2.0, 3.0f, 4});
+        REQUIRE(hist[0] == 3.0f);
+        REQUIRE(hist[1] == 7.0f);
+    }
+
+    SECTION( "SoA bins" ) {
+        std::array<double, 3> x{}, y{};
+        tpa::scatter_add(std::tuple{x.data(), y.data()}, isimd_t{0, 1, 0, 0},
+                         std::tuple{simd_t{1}, simd_t{1, 2, 3, 4}});
+        REQUIRE(x == std::array<double, 3>{3, 1, 0});
+        REQUIRE(y == std::array<double, 3>{8, 2, 0});
+    }
+}
+
+TEST_CASE( "simd histogram", "[simd scatter]" ) {
+    const size_t n = 1001;
+    std::vector<int> idx(n);
+    std::vector<float> w(n), w2(n);
+    for (size_t i = 0; i < n; ++i) {
+        idx[i] = (i * 7) % 5;
+        w[i] = 1.0f;
+        w2[i] = float(i % 3);
+    }
+    std::array<float, 5> ref{}, ref2{};
+    for (size_t i = 0; i < n; ++i) {
+        ref[idx[i]] += w[i];
+        ref2[idx[i]] += w2[i];
+    }
+
+    SECTION( "scalar bins" ) {
+        std::array<float, 5> hist{};
+        tpa::histogram(hist.data(), idx.data(), w.data(), n);
+        REQUIRE(hist == ref);
+    }
+
+    SECTION( "SoA bins" ) {
+        std::array<float, 5> h1{}, h2{};
+        tpa::histogram(std::tuple{h1.data(), h2.data()}, idx.data(), std::tuple{w.data(), w2.data()}, n);
+        REQUIRE(h1 == ref);
+        REQUIRE(h2 == ref2);
+    }
+}
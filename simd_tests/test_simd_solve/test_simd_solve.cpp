@@ -0,0 +1,126 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+template<typename T, size_t M, size_t N>
+void check_lane_packed(std::mt19937& gen, double eps) {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    std::uniform_real_distribution<T> dist(-1, 1);
+    std::array<tpa::mat<T, M, N>, W> a;
+    std::array<std::array<T, M>, W> b;
+    for (auto& m : a)
+        for (size_t i = 0; i < M; ++i)
+            for (size_t j = 0; j < N; ++j)
+                m[i][j] = dist(gen) + (i == j ? T(2) : T(0));
+    for (auto& v : b)
+        for (auto& e : v) e = dist(gen);
+    // Lane 1 is singular: two equal columns.
+    for (size_t i = 0; i < M; ++i)
+        a[1][i][N - 1] = a[1][i][0];
+
+    tpa::mat<simd_t, M, N> am;
+    std::array<simd_t, M> bm;
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            std::array<T, W> lanes;
+            for (size_t l = 0; l < W; ++l) lanes[l] = a[l][i][j];
+            am[i][j] = simd_t::load_unaligned(lanes.data());
+        }
+        std::array<T, W> lanes;
+        for (size_t l = 0; l < W; ++l) lanes[l] = b[l][i];
+        bm[i] = simd_t::load_unaligned(lanes.data());
+    }
+
+    auto check = [&](const auto& f, const auto& x, auto&& scalar_solve) {
+        REQUIRE( f.singular.mask() == 2 );
+        for (size_t l = 0; l < W; ++l) {
+            if (l == 1) continue;
+            const auto ref = scalar_solve(a[l], b[l]);
+            for (size_t j = 0; j < N; ++j)
+                REQUIRE( tpa::to_array(x[j])[l] == Catch::Approx(ref[j]).epsilon(eps).margin(eps) );
+        }
+        for (size_t j = 0; j < N; ++j)
+            REQUIRE( std::isfinite(tpa::to_array(x[j])[1]) );
+    };
+
+    const auto fq = tpa::qr_factor(am);
+    check(fq, tpa::qr_solve(fq, bm), [](const auto& m, const auto& v) { return tpa::qr_solve(tpa::qr_factor(m), v); });
+    if constexpr (M == N) {
+        const auto fl = tpa::lu_factor(am);
+        check(fl, tpa::lu_solve(fl, bm), [](const auto& m, const auto& v) { return tpa::lu_solve(tpa::lu_factor(m), v); });
+        // Normal equations are symmetric positive definite, and singular where a is.
+        const auto s = tpa::matmul(tpa::transpose(am), am);
+        const auto fc = tpa::cholesky_factor(s);
+        check(fc, tpa::cholesky_solve(fc, bm), [](const auto& m, const auto& v) {
+            return tpa::cholesky_solve(tpa::cholesky_factor(tpa::matmul(tpa::transpose(m), m)), v);
+        });
+    }
+}
+
+template<tpa::solver S, size_t M, size_t N>
+void check_bulk(std::mt19937& gen, unsigned threads) {
+    const size_t n = 5003;
+    std::uniform_real_distribution<float> dist(-1, 1);
+    std::vector<std::vector<float>> av(M * N, std::vector<float>(n)), bv(M, std::vector<float>(n)), xv(N, std::vector<float>(n));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t e = 0; e < M * N; ++e)
+            av[e][i] = dist(gen) + (e / N == e % N ? 5.0f : 0.0f);
+        for (size_t r = 0; r < M; ++r)
+            bv[r][i] = dist(gen);
+    }
+    if constexpr (S == tpa::solver::cholesky) {
+        for (size_t i = 0; i < n; ++i)
+            for (size_t r = 0; r < N; ++r)
+                for (size_t c = r + 1; c < N; ++c)
+                    av[r * N + c][i] = av[c * N + r][i];
+    }
+    for (size_t i : {size_t(7), size_t(4000)})
+        for (size_t e = 0; e < M * N; ++e)
+            av[e][i] = 0;
+    std::array<float*, M * N> ac;
+    std::array<float*, M> bc;
+    std::array<float*, N> xc;
+    for (size_t e = 0; e < M * N; ++e) ac[e] = av[e].data();
+    for (size_t r = 0; r < M; ++r) bc[r] = bv[r].data();
+    for (size_t r = 0; r < N; ++r) xc[r] = xv[r].data();
+    std::unique_ptr<bool[]> singular(new bool[n]);
+    const size_t count = tpa::solve_systems<S>(ac, bc, xc, n, singular.get(), threads);
+    REQUIRE( count == 2 );
+    for (size_t i = 0; i < n; ++i) {
+        REQUIRE( singular[i] == (i == 7 or i == 4000) );
+        if (singular[i]) continue;
+        tpa::mat<double, M, N> m;
+        std::array<double, M> rhs;
+        for (size_t e = 0; e < M * N; ++e) m[e / N][e % N] = av[e][i];
+        for (size_t r = 0; r < M; ++r) rhs[r] = bv[r][i];
+        const auto ref = tpa::qr_solve(tpa::qr_factor(m), rhs);
+        for (size_t j = 0; j < N; ++j)
+            REQUIRE( xv[j][i] == Catch::Approx(ref[j]).epsilon(1e-4).margin(1e-4) );
+    }
+}
+
+TEST_CASE( "lane-packed linear solvers", "[simd solve]" ) {
+    std::mt19937 gen(7);
+    check_lane_packed<float, 3, 3>(gen, 1e-3);
+    check_lane_packed<float, 4, 4>(gen, 1e-3);
+    check_lane_packed<double, 5, 5>(gen, 1e-9);
+    check_lane_packed<double, 6, 6>(gen, 1e-9);
+    check_lane_packed<double, 6, 4>(gen, 1e-9);
+}
+
+TEST_CASE( "bulk linear solvers", "[simd solve]" ) {
+    std::mt19937 gen(9);
+    check_bulk<tpa::solver::lu, 3, 3>(gen, 1);
+    check_bulk<tpa::solver::lu, 6, 6>(gen, 4);
+    check_bulk<tpa::solver::cholesky, 4, 4>(gen, 3);
+    check_bulk<tpa::solver::qr, 5, 3>(gen, 2);
+}
@@ -0,0 +1,53 @@
+#include <tuple_arithmetic.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <algorithm>
+#include <random>
+
+using simd_t = xsimd::make_sized_batch_t<double, 4>;
+using fsimd_t = xsimd::make_sized_batch_t<float, 8>;
+using bsimd_t = xsimd::make_sized_batch_t<int8_t, 32>;
+
+TEST_CASE( "simd sorting networks", "[simd sort]" ) {
+    std::mt19937 gen(7);
+
+    SECTION( "lanes of a batch" ) {
+        std::uniform_real_distribution<float> dist(-1, 1);
+        for (int rep = 0; rep < 100; ++rep) {
+            std::array<float, 8> a;
+            for (auto& v : a) v = dist(gen);
+            auto ref = a;
+            std::sort(ref.begin(), ref.end());
+            REQUIRE(tpa::to_array(tpa::sort(fsimd_t::load_unaligned(a.data()))) == ref);
+            REQUIRE(tpa::sort(a) == ref);
+            auto idx = tpa::argsort(a);
+            for (size_t k = 0; k < 8; ++k) REQUIRE(a[idx[k]] == ref[k]);
+            REQUIRE(tpa::median(a) == ref[3] + (ref[4] - ref[3]) / 2);
+            REQUIRE(tpa::nth_element<6>(a) == ref[6]);
+        }
+    }
+
+    SECTION( "32 byte lanes" ) {
+        std::uniform_int_distribution<int> dist(-100, 100);
+        std::array<int8_t, 32> a;
+        for (auto& v : a) v = int8_t(dist(gen));
+        auto ref = a;
+        std::sort(ref.begin(), ref.end());
+        REQUIRE(tpa::to_array(tpa::sort(bsimd_t::load_unaligned(a.data()))) == ref);
+    }
+
+    SECTION( "lane-packed records" ) {
+        std::array<simd_t, 5> recs{
+            simd_t{5, 1, 0, 3}, simd_t{4, 2, 0, 3}, simd_t{3, 3, 0, 1},
+            simd_t{2, 4, 1, 2}, simd_t{1, 5, 0, 0}};
+        auto s = tpa::sort(recs);
+        REQUIRE(tpa::to_array(s[0]) == std::array<double, 4>{1, 1, 0, 0});
+        REQUIRE(tpa::to_array(s[4]) == std::array<double, 4>{5, 5, 1, 3});
+        REQUIRE(tpa::to_array(tpa::median(recs)) == std::array<double, 4>{3, 3, 0, 2});
+        auto idx = tpa::argsort(recs);
+        REQUIRE(tpa::to_array(idx[0]) == std::array<int64_t, 4>{4, 0, 0, 4});
+    }
+}
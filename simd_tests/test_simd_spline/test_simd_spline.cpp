@@ -0,0 +1,65 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+template<typename Curve>
+void check_curve(const Curve& c) {
+    using T = typename Curve::value_type;
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    const T eps = std::is_same_v<T, float> ? T(1e-5) : T(1e-12);
+
+    // Lanes on different segments, and out of range.
+    std::array<T, W> t;
+    for (size_t l = 0; l < W; ++l)
+        t[l] = T(l * 7 % W) / T(W - 1) * T(1.2) - T(0.1);
+    const auto p = c(simd_t::load_unaligned(t.data()));
+    const auto d = c.derivative(simd_t::load_unaligned(t.data()));
+    for (size_t k = 0; k < Curve::dim; ++k) {
+        const auto pk = tpa::to_array(p[k]);
+        const auto dk = tpa::to_array(d[k]);
+        for (size_t l = 0; l < W; ++l) {
+            REQUIRE( pk[l] == Catch::Approx(c(t[l])[k]).margin(eps) );
+            REQUIRE( dk[l] == Catch::Approx(c.derivative(t[l])[k]).epsilon(eps).margin(eps) );
+        }
+    }
+
+    // Bulk sampling with a scalar tail and threads.
+    const size_t n = 3 * W + 1;
+    std::vector<T> ts(n), x(n), y(n), z(n);
+    for (size_t i = 0; i < n; ++i)
+        ts[i] = T(i) / T(n - 1);
+    c.sample(ts.data(), n, std::array{x.data(), y.data(), z.data()}, 2);
+    for (size_t i = 0; i < n; ++i)
+        REQUIRE( z[i] == Catch::Approx(c(ts[i])[2]).margin(eps) );
+
+    // Batched arc length lookups.
+    tpa::arc_length_table table(c, 64);
+    const auto s = tpa::to_array(table.length_at(simd_t::load_unaligned(t.data())));
+    const auto u = tpa::to_array(table.param_at(simd_t::load_unaligned(s.data())));
+    for (size_t l = 0; l < W; ++l) {
+        REQUIRE( s[l] == Catch::Approx(table.length_at(t[l])).margin(eps) );
+        REQUIRE( u[l] == Catch::Approx(table.param_at(s[l])).margin(eps) );
+    }
+}
+
+template<typename T>
+void check_batches() {
+    std::vector<std::array<T, 3>> pts(11);
+    for (size_t i = 0; i < pts.size(); ++i)
+        pts[i] = { T(i), std::sin(T(i)), T(i % 3) };
+    check_curve(tpa::bezier_spline<std::array<T, 3>>(pts.data(), pts.size()));
+    check_curve(tpa::bspline<std::array<T, 3>>(pts.data(), pts.size()));
+    check_curve(tpa::bspline<std::array<T, 3>, 2>(pts.data(), pts.size()));
+}
+
+TEST_CASE( "batched spline evaluation", "[spline]" ) {
+    check_batches<float>();
+    check_batches<double>();
+}
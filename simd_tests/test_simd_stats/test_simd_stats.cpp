@@ -0,0 +1,55 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+template<typename T>
+void check_batches() {
+    using simd_t = xsimd::batch<T>;
+    constexpr size_t W = simd_t::size;
+    const size_t n = 4099;
+    std::vector<T> a(n), b(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = T(100) + std::sin(T(i));
+        b[i] = T(2) * std::sin(T(i)) + std::cos(T(3 * i));
+    }
+
+    tpa::running_stats<std::array<T, 2>, true> ref;
+    for (size_t i = 0; i < n; ++i)
+        ref.push(std::array{a[i], b[i]});
+
+    // Records of batches, one record per lane.
+    tpa::running_stats<std::array<T, 2>, true> s;
+    size_t i = 0;
+    for (; i + W <= n; i += W)
+        s.push(std::array{simd_t::load_unaligned(a.data() + i), simd_t::load_unaligned(b.data() + i)});
+    for (; i < n; ++i)
+        s.push(std::array{a[i], b[i]});
+
+    // Column sets, a batch of records at a time.
+    tpa::running_stats<std::array<T, 2>, true> c;
+    c.push(std::array{a.data(), b.data()}, n, 2);
+
+    const T eps = std::is_same_v<T, float> ? T(1e-4) : T(1e-12);
+    for (const auto* t : {&s, &c}) {
+        REQUIRE( t->count() == n );
+        for (size_t k = 0; k < 2; ++k) {
+            REQUIRE( t->mean()[k] == Catch::Approx(ref.mean()[k]).epsilon(eps) );
+            REQUIRE( t->variance()[k] == Catch::Approx(ref.variance()[k]).epsilon(eps) );
+            REQUIRE( t->min()[k] == ref.min()[k] );
+            REQUIRE( t->max()[k] == ref.max()[k] );
+        }
+        REQUIRE( t->covariance()[0][1] == Catch::Approx(ref.covariance()[0][1]).epsilon(eps) );
+        REQUIRE( t->covariance()[1][0] == Catch::Approx(ref.covariance()[0][1]).epsilon(eps) );
+    }
+}
+
+TEST_CASE( "batched running statistics", "[stats]" ) {
+    check_batches<float>();
+    check_batches<double>();
+}
@@ -0,0 +1,78 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <xsimd/xsimd.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+template<typename T, size_t C>
+void check_rows() {
+    // Widths around the batch size, so that rows end in the vector loop and in
+    // the scalar tail; the reference is the same sum pixel by pixel.
+    constexpr size_t W = xsimd::batch<T>::size;
+    const T eps = std::is_same_v<T, float> ? T(1e-5) : T(1e-12);
+    const std::array<T, 5> k{ T(0.5), T(-1), T(2), T(0.25), T(1) };
+    for (size_t w : {W - 1, W, W + 3, 4 * W + 1}) {
+        const size_t h = 3;
+        std::vector<T> in(w * h * C), out(in.size());
+        for (size_t i = 0; i < in.size(); ++i)
+            in[i] = std::cos(T(i % 23)) + T(i % 4);
+        using P = std::conditional_t<C == 1, T, std::array<T, C>>;
+        tpa::stencil2d(reinterpret_cast<const P*>(in.data()), reinterpret_cast<P*>(out.data()), w, h,
+            std::tuple{ std::tuple{k[0], k[1], k[2], k[3], k[4]} });
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                for (size_t c = 0; c < C; ++c) {
+                    T acc = 0;
+                    for (size_t j = 0; j < 5; ++j) {
+                        const std::ptrdiff_t xx = std::clamp<std::ptrdiff_t>(std::ptrdiff_t(x + j) - 2, 0, std::ptrdiff_t(w) - 1);
+                        acc += k[j] * in[(y * w + size_t(xx)) * C + c];
+                    }
+                    REQUIRE( out[(y * w + x) * C + c] == Catch::Approx(acc).margin(eps) );
+                }
+    }
+}
+
+template<typename T, size_t C>
+void check_int_rows() {
+    // Integer pixels are summed in float batches; the weights are exact in
+    // binary, so rounding matches the double reference.
+    constexpr size_t W = xsimd::batch<float>::size;
+    const std::array<float, 5> k{ 0.25f, -1.0f, 1.5f, 0.5f, -0.75f };
+    for (size_t w : {W - 1, W, W + 3, 4 * W + 1}) {
+        const size_t h = 2;
+        std::vector<T> in(w * h * C), out(in.size());
+        for (size_t i = 0; i < in.size(); ++i)
+            in[i] = T(i * 97 % 251);
+        using P = std::conditional_t<C == 1, T, std::array<T, C>>;
+        tpa::stencil2d(reinterpret_cast<const P*>(in.data()), reinterpret_cast<P*>(out.data()), w, h,
+            std::tuple{ std::tuple{k[0], k[1], k[2], k[3], k[4]} });
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                for (size_t c = 0; c < C; ++c) {
+                    double acc = 0;
+                    for (size_t j = 0; j < 5; ++j) {
+                        const std::ptrdiff_t xx = std::clamp<std::ptrdiff_t>(std::ptrdiff_t(x + j) - 2, 0, std::ptrdiff_t(w) - 1);
+                        acc += k[j] * double(in[(y * w + size_t(xx)) * C + c]);
+                    }
+                    const double ref = std::clamp(std::nearbyint(acc), double(std::numeric_limits<T>::min()), double(std::numeric_limits<T>::max()));
+                    REQUIRE( double(out[(y * w + x) * C + c]) == ref );
+                }
+    }
+}
+
+TEST_CASE( "vectorized stencils", "[stencil]" ) {
+    check_rows<float, 1>();
+    check_rows<float, 3>();
+    check_rows<double, 1>();
+    check_rows<double, 4>();
+    check_int_rows<uint8_t, 1>();
+    check_int_rows<uint8_t, 4>();
+    check_int_rows<int16_t, 3>();
+}
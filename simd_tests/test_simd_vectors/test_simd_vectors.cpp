@@ -0,0 +1,72 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+template<typename T, size_t D>
+void check_vectors(std::mt19937& gen, unsigned threads) {
+    const size_t n = 2003;
+    std::uniform_real_distribution<T> dist(-5, 5);
+    std::vector<std::array<T, D>> a(n), b(n), u(n), v(n);
+    std::array<std::vector<T>, D> cols;
+    for (auto& c : cols) c.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t k = 0; k < D; ++k) {
+            a[i][k] = dist(gen);
+            b[i][k] = dist(gen);
+            cols[k][i] = b[i][k];
+        }
+    a[3] = {};
+    a[n - 2] = {};
+    std::array<T*, D> soa;
+    for (size_t k = 0; k < D; ++k) soa[k] = cols[k].data();
+
+    std::vector<T> d(n), s(n), l(n);
+    tpa::dot(a.data(), soa, d.data(), n, threads);
+    tpa::squared_norm(soa, s.data(), n, threads);
+    tpa::norm(a.data(), l.data(), n, threads);
+    tpa::normalize(a.data(), u.data(), n, threads);
+    tpa::normalize<tpa::degenerate::keep, true>(a.data(), v.data(), n, threads);
+    tpa::normalize<tpa::degenerate::zero, true>(soa, soa, n, threads);
+    for (size_t i = 0; i < n; ++i) {
+        double rd = 0, rs = 0, rl = 0;
+        for (size_t k = 0; k < D; ++k) {
+            rd += double(a[i][k]) * b[i][k];
+            rs += double(b[i][k]) * b[i][k];
+            rl += double(a[i][k]) * a[i][k];
+        }
+        rl = std::sqrt(rl);
+        REQUIRE( d[i] == Catch::Approx(rd).epsilon(1e-5).margin(1e-4) );
+        REQUIRE( s[i] == Catch::Approx(rs).epsilon(1e-5) );
+        REQUIRE( l[i] == Catch::Approx(rl).epsilon(1e-5) );
+        for (size_t k = 0; k < D; ++k) {
+            const double ref = rl == 0 ? 0.0 : a[i][k] / rl;
+            REQUIRE( u[i][k] == Catch::Approx(ref).epsilon(1e-5).margin(1e-6) );
+            REQUIRE( v[i][k] == Catch::Approx(ref).epsilon(1e-5).margin(1e-6) );
+            REQUIRE( cols[k][i] == Catch::Approx(b[i][k] / std::sqrt(rs)).epsilon(1e-5).margin(1e-6) );
+        }
+    }
+
+    if constexpr (D == 3) {
+        std::vector<std::array<T, 3>> c(n);
+        tpa::cross(a.data(), b.data(), c.data(), n, threads);
+        for (size_t i = 0; i < n; ++i) {
+            const auto r = tpa::cross(a[i], b[i]);
+            for (size_t k = 0; k < 3; ++k)
+                REQUIRE( c[i][k] == Catch::Approx(r[k]).epsilon(1e-5).margin(1e-4) );
+        }
+    }
+}
+
+TEST_CASE( "simd bulk vector operations", "[simd vectors]" ) {
+    std::mt19937 gen(13);
+    check_vectors<float, 2>(gen, 1);
+    check_vectors<float, 3>(gen, 4);
+    check_vectors<float, 4>(gen, 1);
+    check_vectors<double, 3>(gen, 3);
+}
@@ -0,0 +1,75 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE( "reductions with index", "[arg reduce op]" ) {
+    auto a = std::make_tuple(3, 1.0, 5.0f, 1, 5ull);
+
+    SECTION( "min and max element" ) {
+        auto mn = tpa::min_element(a);
+        REQUIRE( std::is_same_v<decltype(mn), std::pair<double, size_t>> );
+        REQUIRE( mn == std::pair{1.0, size_t(1)} );
+        REQUIRE( tpa::max_element(a) == std::pair{5.0, size_t(2)} );
+        REQUIRE( tpa::argmin(a) == 1 );
+        REQUIRE( tpa::argmax(a) == 2 );
+    }
+
+    SECTION( "minmax element" ) {
+        auto [mn, mx] = tpa::minmax_element(std::array{4, -2, 7, -2, 7});
+        REQUIRE( mn == std::pair{-2, size_t(1)} );
+        REQUIRE( mx == std::pair{7, size_t(2)} );
+    }
+
+    SECTION( "NaN" ) {
+        const double nan = std::nan("");
+        auto b = std::make_tuple(2.0, nan, -1.0, nan);
+        REQUIRE( tpa::argmin(b) == 1 );
+        REQUIRE( tpa::argmax(b) == 1 );
+        REQUIRE( std::isnan(tpa::min_element(b).first) );
+        REQUIRE( tpa::argmin(std::array{nan, 1.0, 0.0}) == 0 );
+    }
+}
+
+TEST_CASE( "bulk reductions with index", "[arg reduce op]" ) {
+    const size_t n = 1000;
+    std::vector<float> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = float((i * 37) % 101) - 50;
+
+    SECTION( "scalar array" ) {
+        REQUIRE( tpa::min_element(x.data(), n) == std::pair{-50.0f, size_t(0)} );
+        REQUIRE( tpa::max_element(x.data(), n) == std::pair{50.0f, size_t(30)} );
+        auto [mn, mx] = tpa::minmax_element(x.data(), 7);
+        REQUIRE( mn.second == 0 );
+        REQUIRE( mx == std::pair{34.0f, size_t(5)} );
+        x[500] = std::nan("");
+        x[700] = std::nan("");
+        REQUIRE( tpa::argmin(x.data(), n) == 500 );
+        REQUIRE( tpa::argmax(x.data(), n) == 500 );
+    }
+
+    SECTION( "8 bit values" ) {
+        std::vector<int8_t> y(5000, 0);
+        y[4321] = -3;
+        y[4999] = 9;
+        y[17] = 9;
+        REQUIRE( tpa::argmin(y.data(), y.size()) == 4321 );
+        REQUIRE( tpa::argmax(y.data(), y.size()) == 17 );
+    }
+
+    SECTION( "columns" ) {
+        std::vector<double> y(n);
+        for (size_t i = 0; i < n; ++i)
+            y[i] = -double(i % 300);
+        auto r = tpa::argmax(std::make_tuple(x.data(), y.data()), n);
+        REQUIRE( std::get<0>(r) == 30 );
+        REQUIRE( std::get<1>(r) == 0 );
+        auto m = tpa::min_element(std::make_tuple(x.data(), y.data()), n);
+        REQUIRE( std::get<1>(m) == std::pair{-299.0, size_t(299)} );
+    }
+}
@@ -0,0 +1,163 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+using d1 = tpa::dual<double, 1>;
+
+// Derivative of f at x by the dual number and by central differences.
+template<typename F>
+void check_derivative(F&& f, double x) {
+    const d1 y = f(d1::variable(x, 0));
+    const double h = 1e-6;
+    REQUIRE( y.value == Catch::Approx(f(x)) );
+    REQUIRE( y.deriv[0] == Catch::Approx((f(x + h) - f(x - h)) / (2 * h)).epsilon(1e-6) );
+}
+
+#define CHECK_FN(FN, X) check_derivative([](auto v) { using std::FN; return FN(v); }, X)
+
+TEST_CASE( "dual numbers", "[dual]" ) {
+    SECTION( "arithmetic" ) {
+        const auto x = d1::variable(3.0, 0);
+        const d1 y = (x * x + 2.0 * x - 1.0) / (x - 0.5);
+        REQUIRE( y.value == Catch::Approx(14.0 / 2.5) );
+        // ((2x + 2)(x - 0.5) - (x^2 + 2x - 1)) / (x - 0.5)^2 at 3
+        REQUIRE( y.deriv[0] == Catch::Approx((8 * 2.5 - 14) / 6.25) );
+        const d1 z = 1.0 / x - x;
+        REQUIRE( z.deriv[0] == Catch::Approx(-1.0 / 9 - 1) );
+        d1 w = x;
+        w *= x;
+        w += 1.0;
+        w -= x;
+        w /= 2.0;
+        REQUIRE( w.value == 3.5 );
+        REQUIRE( w.deriv[0] == 2.5 );
+        REQUIRE( (-x).deriv[0] == -1.0 );
+        REQUIRE( x < 4.0 );
+        REQUIRE( 2.0 < x );
+        REQUIRE( x == d1(3.0) );
+        REQUIRE( d1(2.0).deriv[0] == 0.0 );
+    }
+
+    SECTION( "unary functions" ) {
+        CHECK_FN(abs, -0.7);
+        CHECK_FN(fabs, 0.7);
+        CHECK_FN(exp, 0.3);
+        CHECK_FN(exp2, 0.3);
+        CHECK_FN(expm1, 0.3);
+        CHECK_FN(log, 1.7);
+        CHECK_FN(log10, 1.7);
+        CHECK_FN(log2, 1.7);
+        CHECK_FN(log1p, 0.7);
+        CHECK_FN(sqrt, 2.5);
+        CHECK_FN(cbrt, -2.5);
+        CHECK_FN(sin, 0.4);
+        CHECK_FN(cos, 0.4);
+        CHECK_FN(tan, 0.4);
+        CHECK_FN(asin, 0.4);
+        CHECK_FN(acos, 0.4);
+        CHECK_FN(atan, 0.4);
+        CHECK_FN(sinh, 0.4);
+        CHECK_FN(cosh, 0.4);
+        CHECK_FN(tanh, 0.4);
+        CHECK_FN(asinh, 0.4);
+        CHECK_FN(acosh, 1.4);
+        CHECK_FN(atanh, 0.4);
+        CHECK_FN(erf, 0.4);
+        CHECK_FN(erfc, 0.4);
+        CHECK_FN(tgamma, 3.3);
+        CHECK_FN(tgamma, -1.3);
+        CHECK_FN(lgamma, 0.2);
+        CHECK_FN(lgamma, 20.5);
+        CHECK_FN(lgamma, -2.6);
+
+        const auto x = d1::variable(2.6, 0);
+        REQUIRE( floor(x).value == 2.0 );
+        REQUIRE( floor(x).deriv[0] == 0.0 );
+        REQUIRE( round(x).value == 3.0 );
+        REQUIRE( lrint(x) == 3 );
+        REQUIRE( isfinite(x) );
+        REQUIRE_FALSE( isnan(x) );
+    }
+
+    SECTION( "binary and ternary functions" ) {
+        check_derivative([](auto v) { using std::pow; return pow(v, 2.5); }, 1.3);
+        check_derivative([](auto v) { using std::pow; return pow(2.5, v); }, 1.3);
+        check_derivative([](auto v) { using std::pow; return pow(v, v); }, 1.3);
+        check_derivative([](auto v) { using std::pow; return pow(v, 2.0); }, -1.3);
+        check_derivative([](auto v) { using std::atan2; return atan2(v, 0.5 - v); }, 0.8);
+        check_derivative([](auto v) { using std::hypot; return hypot(v, 2.0); }, 0.8);
+        check_derivative([](auto v) { using std::hypot; return hypot(v, 2.0, v * v); }, 0.8);
+        check_derivative([](auto v) { using std::fmod; return fmod(3.0 * v, v + 1.0); }, 2.3);
+        check_derivative([](auto v) { using std::remainder; return remainder(3.0 * v, 1.0); }, 2.3);
+        check_derivative([](auto v) { using std::fma; return fma(v, v, 3.0); }, 0.8);
+        check_derivative([](auto v) { using std::lerp; return lerp(v, 2.0, v); }, 0.3);
+
+        const auto x = d1::variable(0.5, 0);
+        REQUIRE( min(x, 1.0).deriv[0] == 1.0 );
+        REQUIRE( max(x, 1.0).deriv[0] == 0.0 );
+        REQUIRE( max(x, 1.0).value == 1.0 );
+        REQUIRE( fmin(2.0 * x, x).value == 0.5 );
+        REQUIRE( fmin(2.0 * x, x).deriv[0] == 1.0 );
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        REQUIRE( fmin(d1(nan), x).value == 0.5 );
+        REQUIRE( fmin(x, d1(nan)).value == 0.5 );
+        REQUIRE( fmax(nan, x).deriv[0] == 1.0 );
+        REQUIRE( fmax(x, nan).deriv[0] == 1.0 );
+        REQUIRE( std::isnan(min(d1(nan), x).value) );
+        REQUIRE( fdim(x, 0.25).deriv[0] == 1.0 );
+        REQUIRE( fdim(x, 1.0).deriv[0] == 0.0 );
+    }
+
+    SECTION( "gradient" ) {
+        auto f = [](const auto& v) {
+            using std::sin;
+            using std::exp;
+            return v[0] * v[1] + sin(v[2]) * exp(v[0]) / v[1];
+        };
+        const std::array<double, 3> x{0.3, 1.5, 0.7};
+        const auto g = tpa::gradient(f, x);
+        static_assert(std::is_same_v<decltype(g), const std::array<double, 3>>);
+        const double e = std::exp(0.3), s = std::sin(0.7);
+        REQUIRE( g[0] == Catch::Approx(1.5 + s * e / 1.5) );
+        REQUIRE( g[1] == Catch::Approx(0.3 - s * e / (1.5 * 1.5)) );
+        REQUIRE( g[2] == Catch::Approx(std::cos(0.7) * e / 1.5) );
+
+        // Tuple operators on tuples of duals, and integer inputs.
+        const auto n = tpa::gradient([](const auto& v) { return tpa::dot(v, v); }, std::tuple<int, int>{2, -3});
+        REQUIRE( n[0] == 4.0 );
+        REQUIRE( n[1] == -6.0 );
+
+        // A constant function has a zero gradient.
+        const auto c = tpa::gradient([](const auto&) { return 1.0; }, x);
+        REQUIRE( (c[0] == 0.0 and c[1] == 0.0 and c[2] == 0.0) );
+    }
+
+    SECTION( "jacobian" ) {
+        // Polar to Cartesian coordinates.
+        auto f = [](const auto& v) {
+            using std::cos;
+            using std::sin;
+            return std::array{v[0] * cos(v[1]), v[0] * sin(v[1])};
+        };
+        const double r = 2.0, t = 0.6;
+        const auto j = tpa::jacobian(f, std::array{r, t});
+        static_assert(std::is_same_v<decltype(j), const tpa::mat<double, 2, 2>>);
+        REQUIRE( j[0][0] == Catch::Approx(std::cos(t)) );
+        REQUIRE( j[0][1] == Catch::Approx(-r * std::sin(t)) );
+        REQUIRE( j[1][0] == Catch::Approx(std::sin(t)) );
+        REQUIRE( j[1][1] == Catch::Approx(r * std::cos(t)) );
+        REQUIRE( tpa::det(j) == Catch::Approx(r) );
+
+        // Elements that do not depend on the input are constant rows.
+        const auto k = tpa::jacobian([](const auto& v) { return std::tuple{v[0] * v[1], 2.0}; }, std::array{3.0, 4.0});
+        REQUIRE( k[0][0] == 4.0 );
+        REQUIRE( k[0][1] == 3.0 );
+        REQUIRE( (k[1][0] == 0.0 and k[1][1] == 0.0) );
+    }
+}
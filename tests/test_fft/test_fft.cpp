@@ -0,0 +1,118 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <tuple>
+#include <vector>
+
+template<size_t N>
+std::array<std::complex<double>, N> naive_dft(const std::array<std::complex<double>, N>& x) {
+    std::array<std::complex<double>, N> ret;
+    for (size_t j = 0; j < N; ++j) {
+        ret[j] = 0;
+        for (size_t k = 0; k < N; ++k)
+            ret[j] += x[k] * std::polar(1.0, -2 * std::numbers::pi * double(j * k % N) / double(N));
+    }
+    return ret;
+}
+
+template<size_t N>
+std::array<std::complex<double>, N> signal(size_t seed) {
+    std::array<std::complex<double>, N> x;
+    for (size_t k = 0; k < N; ++k)
+        x[k] = { std::sin(double(3 * k + seed)), std::cos(double(k * k + 2 * seed)) };
+    return x;
+}
+
+template<size_t N>
+void check_size() {
+    const auto x = signal<N>(N);
+    const auto ref = naive_dft(x);
+    const double eps = 1e-13 * double(N);
+
+    // Split layout, and back.
+    std::array<double, N> re, im;
+    for (size_t k = 0; k < N; ++k) {
+        re[k] = x[k].real();
+        im[k] = x[k].imag();
+    }
+    tpa::fft(re, im);
+    for (size_t k = 0; k < N; ++k) {
+        REQUIRE( re[k] == Catch::Approx(ref[k].real()).margin(eps) );
+        REQUIRE( im[k] == Catch::Approx(ref[k].imag()).margin(eps) );
+    }
+    tpa::ifft(re, im);
+    for (size_t k = 0; k < N; ++k) {
+        REQUIRE( re[k] == Catch::Approx(x[k].real()).margin(eps) );
+        REQUIRE( im[k] == Catch::Approx(x[k].imag()).margin(eps) );
+    }
+
+    // Interleaved layout.
+    std::array<double, 2 * N> v;
+    for (size_t k = 0; k < N; ++k) {
+        v[2 * k] = x[k].real();
+        v[2 * k + 1] = x[k].imag();
+    }
+    tpa::fft_interleaved(v);
+    for (size_t k = 0; k < N; ++k) {
+        REQUIRE( v[2 * k] == Catch::Approx(ref[k].real()).margin(eps) );
+        REQUIRE( v[2 * k + 1] == Catch::Approx(ref[k].imag()).margin(eps) );
+    }
+
+    // Records of std::complex.
+    std::vector<std::array<std::complex<double>, N>> recs{ x, signal<N>(1), signal<N>(2) };
+    tpa::fft_many<N>(reinterpret_cast<double*>(recs.data()), recs.size());
+    for (size_t k = 0; k < N; ++k) {
+        REQUIRE( recs[0][k].real() == Catch::Approx(ref[k].real()).margin(eps) );
+        REQUIRE( recs[0][k].imag() == Catch::Approx(ref[k].imag()).margin(eps) );
+    }
+    tpa::ifft_many<N>(reinterpret_cast<double*>(recs.data()), recs.size());
+    for (size_t k = 0; k < N; ++k)
+        REQUIRE( std::abs(recs[2][k] - signal<N>(2)[k]) < eps );
+}
+
+TEST_CASE( "fft codelets", "[fft]" ) {
+    SECTION( "twiddles" ) {
+        for (size_t n : {8, 16, 64})
+            for (size_t k = 0; k <= n / 2; ++k) {
+                const auto w = tpa::detail::fft_unit_root(k, n);
+                REQUIRE( w[0] == Catch::Approx(std::cos(2 * std::numbers::pi * double(k) / double(n))).margin(1e-15) );
+                REQUIRE( w[1] == Catch::Approx(std::sin(2 * std::numbers::pi * double(k) / double(n))).margin(1e-15) );
+            }
+    }
+
+    SECTION( "sizes" ) {
+        check_size<2>();
+        check_size<4>();
+        check_size<8>();
+        check_size<16>();
+        check_size<32>();
+        check_size<64>();
+    }
+
+    SECTION( "mixed tuples" ) {
+        // An impulse transforms to a constant, a constant to an impulse.
+        auto re = std::tuple{1.0f, 0.0, 0.0f, 0.0};
+        auto im = std::tuple{0.0, 0.0, 0.0, 0.0f};
+        tpa::fft(re, im);
+        REQUIRE( re == std::tuple{1.0f, 1.0, 1.0f, 1.0} );
+        tpa::fft(re, im);
+        REQUIRE( re == std::tuple{4.0f, 0.0, 0.0f, 0.0} );
+    }
+
+    SECTION( "threads" ) {
+        constexpr size_t N = 16;
+        std::vector<double> a(2 * N * 1000);
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = std::sin(double(i));
+        auto b = a;
+        tpa::fft_many<N>(a.data(), 1000);
+        tpa::fft_many<N>(b.data(), 1000, 4);
+        REQUIRE( (a == b) );
+    }
+}
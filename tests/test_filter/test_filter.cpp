@@ -0,0 +1,123 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <tuple>
+#include <vector>
+
+// Direct form I reference of one biquad on one channel.
+struct biquad_ref {
+    tpa::biquad_coeffs c;
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+    double operator()(double x) {
+        const double y = c.b0 * x + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+        return y;
+    }
+};
+
+// Amplitude of the steady-state response to a sine of frequency f.
+template<typename F>
+double sine_gain(F&& filter, double f, double fs) {
+    double peak = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const double y = filter(std::sin(2 * std::numbers::pi * f / fs * i));
+        if (i >= 10000)
+            peak = std::max(peak, std::abs(y));
+    }
+    return peak;
+}
+
+TEST_CASE( "filter bank", "[filter]" ) {
+    const size_t n = 500;
+    std::vector<std::array<double, 3>> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = { std::sin(0.1 * double(i)), double(i % 7) - 3, 1.0 };
+
+    SECTION( "biquad cascades against direct form I" ) {
+        const auto lp = tpa::biquad_lowpass(1000, 48000);
+        const auto hp = tpa::biquad_highpass(300, 48000, 0.5);
+        const auto pk = tpa::biquad_peak(5000, 48000, 2, 6);
+        tpa::biquad_cascade<std::array<double, 3>, 2> f(lp);
+        f.set(1, hp);
+        f.set(1, 2, pk);
+        std::array<std::array<biquad_ref, 2>, 3> ref{{ {{{lp}, {hp}}}, {{{lp}, {hp}}}, {{{lp}, {pk}}} }};
+        for (size_t i = 0; i < n; ++i) {
+            const auto y = f.process(x[i]);
+            for (size_t c = 0; c < 3; ++c)
+                REQUIRE( y[c] == Catch::Approx(ref[c][1](ref[c][0](x[i][c]))).margin(1e-12) );
+        }
+        f.reset();
+        REQUIRE( f.process(std::array{0.0, 0.0, 0.0}) == std::array{0.0, 0.0, 0.0} );
+    }
+
+    SECTION( "designs" ) {
+        const double fs = 48000;
+        auto gain = [&](const tpa::biquad_coeffs& c, double f) {
+            biquad_ref r{c};
+            return sine_gain(r, f, fs);
+        };
+        REQUIRE( gain(tpa::biquad_lowpass(1000, fs), 50) == Catch::Approx(1).margin(1e-3) );
+        REQUIRE( gain(tpa::biquad_lowpass(1000, fs), 1000) == Catch::Approx(std::sqrt(0.5)).margin(1e-3) );
+        REQUIRE( gain(tpa::biquad_highpass(1000, fs), 1000) == Catch::Approx(std::sqrt(0.5)).margin(1e-3) );
+        REQUIRE( gain(tpa::biquad_bandpass(2000, fs, 3), 2000) == Catch::Approx(1).margin(1e-3) );
+        REQUIRE( gain(tpa::biquad_notch(2000, fs, 3), 2000) < 1e-3 );
+        REQUIRE( gain(tpa::biquad_peak(2000, fs, 1, 6), 2000) == Catch::Approx(std::pow(10.0, 6.0 / 20)).margin(1e-3) );
+    }
+
+    SECTION( "one pole and dc blocker" ) {
+        tpa::one_pole<std::tuple<double, float>> ema(0.25);
+        ema.set(1, 0.5f);
+        double y0 = 0, y1 = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const auto y = ema.process(std::tuple{x[i][0], float(x[i][1])});
+            y0 += 0.25 * (x[i][0] - y0);
+            y1 += 0.5 * (x[i][1] - y1);
+            REQUIRE( std::get<0>(y) == Catch::Approx(y0).margin(1e-12) );
+            REQUIRE( std::get<1>(y) == Catch::Approx(y1).margin(1e-5) );
+        }
+        REQUIRE( tpa::one_pole<std::array<double, 1>>::alpha_for(100, 1000) == Catch::Approx(1 - std::exp(-0.2 * std::numbers::pi)) );
+
+        // A constant input decays to zero, a sine well above the corner passes.
+        tpa::dc_blocker<std::array<double, 3>> dc(0.99);
+        std::array<double, 3> y{};
+        for (size_t i = 0; i < 5000; ++i)
+            y = dc.process(std::array{5.0, -2.0, 1.0});
+        REQUIRE( std::abs(y[0]) < 1e-12 );
+        tpa::dc_blocker<std::array<double, 1>> ac(tpa::dc_blocker<std::array<double, 1>>::r_for(10, 48000));
+        REQUIRE( sine_gain([&](double v) { return ac.process(std::array{v + 3})[0]; }, 1000, 48000) == Catch::Approx(1).margin(1e-3) );
+    }
+
+    SECTION( "interleaved and planar blocks" ) {
+        std::vector<double> buf(3 * n), planar[3];
+        for (size_t c = 0; c < 3; ++c)
+            planar[c].resize(n);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t c = 0; c < 3; ++c)
+                buf[3 * i + c] = planar[c][i] = x[i][c];
+
+        using frame = std::array<double, 3>;
+        tpa::dc_blocker<frame> d0, d1, d2;
+        tpa::biquad_cascade<frame, 2> b0(tpa::biquad_lowpass(2000, 48000)), b1 = b0, b2 = b0;
+
+        // In place, in sequence.
+        tpa::filter_interleaved(buf.data(), buf.data(), n, d0, b0);
+        std::array<double*, 3> cols{planar[0].data(), planar[1].data(), planar[2].data()};
+        tpa::filter_planar(cols, cols, n, d1, b1);
+        for (size_t i = 0; i < n; ++i) {
+            const auto y = b2.process(d2.process(x[i]));
+            for (size_t c = 0; c < 3; ++c) {
+                REQUIRE( buf[3 * i + c] == y[c] );
+                REQUIRE( planar[c][i] == y[c] );
+            }
+        }
+    }
+}
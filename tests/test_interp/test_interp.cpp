@@ -0,0 +1,56 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE( "grid interpolation", "[interp]" ) {
+
+    SECTION( "interp1" ) {
+        std::vector<double> v{0, 10, 20, 40};
+        auto g = tpa::make_grid_view(v.data(), std::array<size_t, 1>{4});
+        REQUIRE( tpa::interp1(g, 0.25) == Catch::Approx(2.5) );
+        REQUIRE( tpa::interp1(g, 2.5) == Catch::Approx(30) );
+        REQUIRE( tpa::interp1(g, 3.0) == Catch::Approx(40) );
+        REQUIRE( tpa::interp1(g, -1.0) == Catch::Approx(0) );
+        REQUIRE( tpa::interp1(g, 7.0) == Catch::Approx(40) );
+        REQUIRE( tpa::interp1<tpa::boundary::wrap>(g, 3.5) == Catch::Approx(20) );
+        REQUIRE( tpa::interp1<tpa::boundary::wrap>(g, -0.5) == Catch::Approx(20) );
+        REQUIRE( tpa::interp1<tpa::boundary::wrap>(g, 5.0) == Catch::Approx(10) );
+
+        g.set_axes({1.0}, {0.5});
+        REQUIRE( tpa::interp1(g, 1.25) == Catch::Approx(5) );
+    }
+
+    SECTION( "interp2 with tuple-valued cells" ) {
+        // value(x, y) = (x + 10 y, 1), x fastest
+        std::vector<float> v;
+        for (int y = 0; y < 3; ++y)
+            for (int x = 0; x < 4; ++x) {
+                v.push_back(float(x + 10 * y));
+                v.push_back(1.0f);
+            }
+        auto g = tpa::make_grid_view<2>(v.data(), std::array<size_t, 2>{4, 3});
+        auto r = tpa::interp2(g, std::make_tuple(1.5, 0.25f));
+        REQUIRE( std::is_same_v<decltype(r), std::array<float, 2>> );
+        REQUIRE( r[0] == Catch::Approx(4.0) );
+        REQUIRE( r[1] == Catch::Approx(1.0) );
+        REQUIRE( tpa::interp2(g, std::array{9.0f, 9.0f})[0] == Catch::Approx(23.0) );
+    }
+
+    SECTION( "interp3 is exact for trilinear functions" ) {
+        const size_t n = 5;
+        std::vector<double> v(n * n * n);
+        auto f = [](double x, double y, double z) { return 1 + 2 * x - y + 0.5 * z + x * y * z; };
+        for (size_t z = 0; z < n; ++z)
+            for (size_t y = 0; y < n; ++y)
+                for (size_t x = 0; x < n; ++x)
+                    v[x + n * (y + n * z)] = f(double(x), double(y), double(z));
+        auto g = tpa::make_grid_view(v.data(), std::array<size_t, 3>{n, n, n});
+        for (double x : {0.0, 0.3, 1.7, 3.99})
+            for (double z : {0.1, 2.5})
+                REQUIRE( tpa::interp3(g, std::make_tuple(x, 1.25, z)) == Catch::Approx(f(x, 1.25, z)) );
+    }
+}
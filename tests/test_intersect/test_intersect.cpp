@@ -0,0 +1,70 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+TEST_CASE( "ray intersection", "[intersect]" ) {
+    const double inf = std::numeric_limits<double>::infinity();
+
+    SECTION( "box" ) {
+        const std::array lo{0.0, 0.0, 0.0}, hi{1.0, 2.0, 3.0};
+        auto h = tpa::ray_box(std::array{-1.0, 0.5, 0.5}, std::array{1.0, inf, inf}, lo, hi);
+        REQUIRE( h.hit );
+        REQUIRE( h.t_near == 1.0 );
+        REQUIRE( h.t_far == 2.0 );
+        // Pointing away, and beyond t_max.
+        REQUIRE_FALSE( tpa::ray_box(std::array{-1.0, 0.5, 0.5}, std::array{-1.0, inf, inf}, lo, hi).hit );
+        REQUIRE_FALSE( tpa::ray_box(std::array{-1.0, 0.5, 0.5}, std::array{1.0, inf, inf}, lo, hi, 0.0, 0.5).hit );
+        // Parallel to the x slabs, outside of them.
+        REQUIRE_FALSE( tpa::ray_box(std::array{2.0, -1.0, 0.5}, std::array{inf, 1.0, inf}, lo, hi).hit );
+        // Origin inside: enters at t_min.
+        h = tpa::ray_box(std::make_tuple(0.5f, 1, 1), std::array{1.0, 1.0, 1.0}, lo, hi);
+        REQUIRE( h.hit );
+        REQUIRE( h.t_near == 0.0 );
+        REQUIRE( h.t_far == 0.5 );
+        // Any dimension.
+        REQUIRE( tpa::ray_box(std::array{-1.0, 0.5}, std::array{1.0, 2.0}, std::array{0.0, 0.0}, std::array{1.0, 1.0}).hit );
+    }
+
+    SECTION( "triangle" ) {
+        const std::array v0{0.0, 0.0, 0.0}, v1{1.0, 0.0, 0.0}, v2{0.0, 1.0, 0.0};
+        auto h = tpa::ray_triangle(std::array{0.25, 0.5, 2.0}, std::array{0.0, 0.0, -1.0}, v0, v1, v2);
+        REQUIRE( h.hit );
+        REQUIRE( h.t == Catch::Approx(2.0) );
+        REQUIRE( h.u == Catch::Approx(0.25) );
+        REQUIRE( h.v == Catch::Approx(0.5) );
+        // From below.
+        REQUIRE( tpa::ray_triangle(std::array{0.25, 0.25, -1.0}, std::array{0.0, 0.0, 1.0}, v0, v1, v2).hit );
+        // Outside, behind, parallel, degenerate.
+        REQUIRE_FALSE( tpa::ray_triangle(std::array{0.75, 0.5, 2.0}, std::array{0.0, 0.0, -1.0}, v0, v1, v2).hit );
+        REQUIRE_FALSE( tpa::ray_triangle(std::array{0.25, 0.5, 2.0}, std::array{0.0, 0.0, 1.0}, v0, v1, v2).hit );
+        REQUIRE_FALSE( tpa::ray_triangle(std::array{0.25, 0.5, 0.0}, std::array{1.0, 0.0, 0.0}, v0, v1, v2).hit );
+        REQUIRE_FALSE( tpa::ray_triangle(std::array{0.0, 0.0, 2.0}, std::array{0.0, 0.0, -1.0}, v0, v1, v1).hit );
+    }
+
+    SECTION( "bulk" ) {
+        const size_t n = 5;
+        // Boxes [i, i + 1]^3 along the diagonal.
+        std::vector<double> lx(n), ly(n), lz(n), hx(n), hy(n), hz(n), t(n);
+        for (size_t i = 0; i < n; ++i) {
+            lx[i] = ly[i] = lz[i] = double(i);
+            hx[i] = hy[i] = hz[i] = double(i) + 1;
+        }
+        ly[2] = 3.5;  // off the diagonal
+        hy[2] = 4.5;
+        const size_t hits = tpa::intersect_boxes(std::array{-1.0, -1.0, -1.0}, std::array{1.0, 1.0, 1.0},
+                std::array{lx.data(), ly.data(), lz.data()}, std::array{hx.data(), hy.data(), hz.data()}, n, t.data());
+        REQUIRE( hits == n - 1 );
+        for (size_t i = 0; i < n; ++i) {
+            if (i == 2)
+                REQUIRE( std::isinf(t[i]) );
+            else
+                REQUIRE( t[i] == Catch::Approx(double(i) + 1) );
+        }
+    }
+}
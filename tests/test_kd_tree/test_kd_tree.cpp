@@ -0,0 +1,81 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+TEST_CASE( "kd tree queries", "[kd_tree]" ) {
+    // Integer grid of 2D points, mixed tuple types.
+    std::vector<std::tuple<int, double>> pts;
+    for (int y = 0; y < 9; ++y)
+        for (int x = 0; x < 7; ++x)
+            pts.emplace_back(x, 0.5 * y);
+    const tpa::kd_tree<std::tuple<int, double>> tree(pts.data(), pts.size(), 4);
+    REQUIRE( tree.size() == pts.size() );
+    REQUIRE( tree.node_count() > 1 );
+
+    auto dist = [&](size_t i, double x, double y) {
+        return std::hypot(std::get<0>(pts[i]) - x, std::get<1>(pts[i]) - y);
+    };
+
+    SECTION( "radius" ) {
+        std::vector<size_t> found;
+        const size_t count = tree.radius_query(std::array{3.0, 2.0}, 1.0, found);
+        REQUIRE( count == found.size() );
+        std::sort(found.begin(), found.end());
+        std::vector<size_t> ref;
+        for (size_t i = 0; i < pts.size(); ++i)
+            if (dist(i, 3, 2) <= 1.0)
+                ref.push_back(i);
+        REQUIRE( found == ref );
+    }
+
+    SECTION( "box" ) {
+        std::vector<size_t> found{size_t(-1)};
+        const size_t count = tree.box_query(std::array{1, 1}, std::array{2.5, 2.0}, found);
+        REQUIRE( count == found.size() - 1 );
+        // Appended after the existing entry: x in {1, 2}, y in {1, 1.5, 2}
+        REQUIRE( found.size() == 7 );
+        REQUIRE( found[0] == size_t(-1) );
+        for (size_t p = 1; p < 7; ++p) {
+            const auto [x, y] = pts[found[p]];
+            REQUIRE( x >= 1 );
+            REQUIRE( x <= 2 );
+            REQUIRE( y >= 1.0 );
+            REQUIRE( y <= 2.0 );
+        }
+    }
+
+    SECTION( "knn" ) {
+        std::array<size_t, 5> idx;
+        std::array<double, 5> d;
+        REQUIRE( tree.knn(std::array{6.2, 4.1}, 5, idx.data(), d.data()) == 5 );
+        std::vector<double> ref(pts.size());
+        for (size_t i = 0; i < pts.size(); ++i)
+            ref[i] = dist(i, 6.2, 4.1);
+        std::sort(ref.begin(), ref.end());
+        for (size_t r = 0; r < 5; ++r) {
+            REQUIRE( d[r] == Catch::Approx(ref[r]) );
+            REQUIRE( dist(idx[r], 6.2, 4.1) == Catch::Approx(ref[r]) );
+        }
+
+        std::vector<size_t> all(pts.size() + 1);
+        std::vector<double> da(pts.size() + 1);
+        REQUIRE( tree.knn(std::array{0, 0}, all.size(), all.data(), da.data()) == pts.size() );
+        REQUIRE( all.back() == pts.size() );
+        REQUIRE( std::isinf(da.back()) );
+    }
+
+    SECTION( "empty tree" ) {
+        const tpa::kd_tree<std::array<float, 3>> empty(nullptr, 0);
+        std::vector<size_t> found;
+        REQUIRE( empty.radius_query(std::array{0, 0, 0}, 1.f, found) == 0 );
+        size_t i;
+        float d;
+        REQUIRE( empty.knn(std::array{0, 0, 0}, 1, &i, &d) == 0 );
+    }
+}
@@ -0,0 +1,98 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <type_traits>
+#include <vector>
+
+template<typename M>
+void require_identity(const M& m) {
+    constexpr size_t N = std::tuple_size_v<M>;
+    for (size_t i = 0; i < N; ++i)
+        for (size_t j = 0; j < N; ++j)
+            REQUIRE( m[i][j] == Catch::Approx(i == j ? 1.0 : 0.0).margin(1e-12) );
+}
+
+TEST_CASE( "matrix operations", "[matrix]" ) {
+    const tpa::mat<int, 2, 3> a{{ {1, 2, 3}, {4, 5, 6} }};
+
+    SECTION( "transpose" ) {
+        auto t = tpa::transpose(a);
+        REQUIRE( std::is_same_v<decltype(t), tpa::mat<int, 3, 2>> );
+        REQUIRE( t == tpa::mat<int, 3, 2>{{ {1, 4}, {2, 5}, {3, 6} }} );
+    }
+
+    SECTION( "matrix products" ) {
+        REQUIRE( tpa::matmul(a, std::make_tuple(1, 0.5, 2)) == std::array{8.0, 18.5} );
+        auto p = tpa::matmul(a, tpa::transpose(a));
+        REQUIRE( p == tpa::mat<int, 2, 2>{{ {14, 32}, {32, 77} }} );
+    }
+
+    SECTION( "existing operators apply" ) {
+        auto b = a * 2 + 1;
+        REQUIRE( b[1][2] == 13 );
+    }
+
+    SECTION( "determinant" ) {
+        REQUIRE( tpa::det(tpa::mat<int, 2>{{ {1, 2}, {3, 4} }}) == -2 );
+        REQUIRE( tpa::det(tpa::mat<int, 3>{{ {2, 0, 1}, {1, 3, 2}, {1, 1, 2} }}) == 6 );
+        REQUIRE( tpa::det(tpa::mat<int, 4>{{ {1, 0, 2, -1}, {3, 0, 0, 5}, {2, 1, 4, -3}, {1, 0, 5, 0} }}) == 30 );
+        REQUIRE( tpa::det(std::make_tuple(std::make_tuple(2.0, 1), std::array{1, 1})) == 1.0 );
+    }
+
+    SECTION( "inverse" ) {
+        const tpa::mat<int, 3> m3{{ {2, 0, 1}, {1, 3, 2}, {1, 1, 2} }};
+        auto i3 = tpa::inverse(m3);
+        REQUIRE( std::is_same_v<decltype(i3), tpa::mat<double, 3>> );
+        require_identity(tpa::matmul(i3, m3));
+
+        const tpa::mat<int, 4> m4{{ {1, 0, 2, -1}, {3, 0, 0, 5}, {2, 1, 4, -3}, {1, 0, 5, 0} }};
+        require_identity(tpa::matmul(tpa::inverse(m4), m4));
+        require_identity(tpa::matmul(m4, tpa::inverse(m4)));
+
+        const tpa::mat<int, 2> m2{{ {1, 2}, {3, 4} }};
+        require_identity(tpa::matmul(tpa::inverse(m2), m2));
+    }
+}
+
+TEST_CASE( "bulk point transform", "[matrix]" ) {
+    const size_t n = 37;
+    std::vector<double> x(n), y(n), z(n), u(n), v(n), w(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = double(i);
+        y[i] = 1.0 - 0.5 * double(i);
+        z[i] = 0.25 * double(i % 7);
+    }
+    const std::array<const double*, 3> in{x.data(), y.data(), z.data()};
+    const tpa::mat<double, 4> m{{ {1, 2, 0, 1}, {0, 1, 3, -2}, {2, 0, 1, 0.5}, {0, 0.5, 0.25, 2} }};
+
+    SECTION( "linear" ) {
+        const auto m3 = tpa::mat<int, 3>{{ {1, 2, 0}, {0, 1, 3}, {2, 0, 1} }};
+        tpa::transform_points(m3, in, std::array{u.data(), v.data(), w.data()}, n);
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE( (std::array{u[i], v[i], w[i]} == tpa::matmul(m3, std::array{x[i], y[i], z[i]})) );
+    }
+
+    SECTION( "affine" ) {
+        tpa::transform_points(tpa::firstN<3>(m), in, std::array{u.data(), v.data(), w.data()}, n);
+        for (size_t i = 0; i < n; ++i) {
+            const auto r = tpa::matmul(m, std::array{x[i], y[i], z[i], 1.0});
+            REQUIRE( u[i] == Catch::Approx(r[0]) );
+            REQUIRE( v[i] == Catch::Approx(r[1]) );
+            REQUIRE( w[i] == Catch::Approx(r[2]) );
+        }
+    }
+
+    SECTION( "projective, in place" ) {
+        const std::array cols{x.data(), y.data(), z.data()};
+        const auto x0 = x, y0 = y, z0 = z;
+        tpa::transform_points(m, cols, cols, n, 2);
+        for (size_t i = 0; i < n; ++i) {
+            const auto r = tpa::matmul(m, std::array{x0[i], y0[i], z0[i], 1.0});
+            REQUIRE( x[i] == Catch::Approx(r[0] / r[3]) );
+            REQUIRE( y[i] == Catch::Approx(r[1] / r[3]) );
+            REQUIRE( z[i] == Catch::Approx(r[2] / r[3]) );
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <tuple_math.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+TEST_CASE( "pairwise distances and knn", "[neighbors]" ) {
+    const size_t na = 7, nb = 11;
+    std::vector<double> ax(na), ay(na), az(na), bx(nb), by(nb), bz(nb);
+    for (size_t i = 0; i < na; ++i) {
+        ax[i] = double(i); ay[i] = 0.5 * double(i % 3); az[i] = -double(i) / 4;
+    }
+    for (size_t j = 0; j < nb; ++j) {
+        bx[j] = double(j % 4); by[j] = double(j) / 3; bz[j] = 1.0 - double(j % 5);
+    }
+    const std::array a{ax.data(), ay.data(), az.data()};
+    const std::array b{bx.data(), by.data(), bz.data()};
+    auto point = [](const auto& cols, size_t i) {
+        return std::array{get<0>(cols)[i], get<1>(cols)[i], get<2>(cols)[i]};
+    };
+
+    SECTION( "pairwise" ) {
+        std::vector<double> l1(na * nb), l2(na * nb), sq(na * nb), l3(na * nb), l4(na * nb);
+        tpa::pairwise_distances<1>(a, na, b, nb, l1.data());
+        tpa::pairwise_distances(a, na, b, nb, l2.data());
+        tpa::pairwise_distances<2, false>(a, na, b, nb, sq.data());
+        tpa::pairwise_distances<3>(a, na, b, nb, l3.data());
+        tpa::pairwise_distances<4>(a, na, b, nb, l4.data(), 3);
+        for (size_t i = 0; i < na; ++i)
+            for (size_t j = 0; j < nb; ++j) {
+                const auto d = point(a, i) - point(b, j);
+                REQUIRE( l1[i * nb + j] == Catch::Approx(tpa::norm<1>(d)) );
+                REQUIRE( l2[i * nb + j] == Catch::Approx(tpa::norm<2>(d)) );
+                REQUIRE( sq[i * nb + j] == Catch::Approx(tpa::dot(d, d)) );
+                REQUIRE( l3[i * nb + j] == Catch::Approx(tpa::norm<3>(d)) );
+                REQUIRE( l4[i * nb + j] == Catch::Approx(tpa::norm<4>(d)) );
+            }
+    }
+
+    SECTION( "knn" ) {
+        const size_t k = 4;
+        std::vector<size_t> idx(na * k);
+        std::vector<double> dist(na * k);
+        tpa::knn(a, na, b, nb, k, idx.data(), dist.data(), 2);
+        for (size_t i = 0; i < na; ++i) {
+            std::vector<size_t> order(nb);
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::stable_sort(order.begin(), order.end(), [&](size_t p, size_t q) {
+                return tpa::norm(point(a, i) - point(b, p)) < tpa::norm(point(a, i) - point(b, q));
+            });
+            for (size_t r = 0; r < k; ++r) {
+                REQUIRE( idx[i * k + r] == order[r] );
+                REQUIRE( dist[i * k + r] == Catch::Approx(tpa::norm(point(a, i) - point(b, order[r]))) );
+            }
+        }
+
+        // Single query, ties broken by index, more neighbors than points.
+        std::vector<size_t> one(nb + 2);
+        std::vector<double> d1(nb + 2);
+        const size_t found = tpa::knn<1>(std::array{0.0, 0.0, 1.0}, b, nb, nb + 2, one.data(), d1.data());
+        REQUIRE( found == nb );
+        REQUIRE( std::is_sorted(d1.begin(), d1.begin() + nb) );
+        for (size_t r = 1; r < nb; ++r)
+            if (d1[r] == d1[r - 1])
+                REQUIRE( one[r] > one[r - 1] );
+        REQUIRE( one[nb] == nb );
+        REQUIRE( std::isinf(d1[nb + 1]) );
+    }
+}
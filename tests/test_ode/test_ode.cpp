@@ -0,0 +1,72 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cmath>
+#include <tuple>
+
+TEST_CASE( "ode integrators", "[ode]" ) {
+    // Harmonic oscillator y = (x, v): x' = v, v' = -x, x(0) = 1, v(0) = 0.
+    auto osc = [](double, const std::tuple<double, double>& y) {
+        return std::tuple<double, double>{std::get<1>(y), -std::get<0>(y)};
+    };
+    const std::tuple<double, double> y0{1.0, 0.0};
+
+    SECTION( "rk4 is 4th order" ) {
+        auto error = [&](size_t steps) {
+            const auto y = tpa::rk4(osc, 0.0, y0, 1.0 / double(steps), steps);
+            return std::abs(std::get<0>(y) - std::cos(1.0));
+        };
+        const double e1 = error(10), e2 = error(20);
+        REQUIRE( e1 < 1e-5 );
+        REQUIRE( e1 / e2 == Catch::Approx(16).epsilon(0.1) );
+    }
+
+    SECTION( "rk45" ) {
+        const auto r = tpa::rk45(osc, 0.0, 10.0, y0, 0.1, 1e-8, 1e-10);
+        REQUIRE( r.done );
+        REQUIRE( r.t == 10.0 );
+        REQUIRE( std::get<0>(r.y) == Catch::Approx(std::cos(10.0)).margin(1e-6) );
+        REQUIRE( std::get<1>(r.y) == Catch::Approx(-std::sin(10.0)).margin(1e-6) );
+        REQUIRE( r.steps > 10 );
+
+        // Too large a step is rejected and shrunk.
+        const auto s = tpa::rk45_step(osc, 0.0, y0, 5.0);
+        REQUIRE_FALSE( s.accepted );
+        REQUIRE( s.t == 0.0 );
+        REQUIRE( std::get<0>(s.y) == 1.0 );
+        REQUIRE( s.h < 5.0 );
+        const auto a = tpa::rk45_step(osc, 0.0, y0, 0.01);
+        REQUIRE( a.accepted );
+        REQUIRE( a.t == 0.01 );
+        REQUIRE( std::get<0>(a.y) == Catch::Approx(std::cos(0.01)) );
+
+        // Not enough steps allowed.
+        REQUIRE_FALSE( tpa::rk45(osc, 0.0, 10.0, y0, 0.1, 1e-8, 1e-10, 5).done );
+
+        // Backward in time.
+        auto growth = [](double, const std::array<double, 1>& y) { return y; };
+        const auto b = tpa::rk45(growth, 0.0, -1.0, std::array{1.0}, 0.1, 1e-10, 1e-12);
+        REQUIRE( b.done );
+        REQUIRE( b.t == -1.0 );
+        REQUIRE( b.h < 0.0 );
+        REQUIRE( b.steps > 0 );
+        REQUIRE( b.y[0] == Catch::Approx(std::exp(-1.0)).epsilon(1e-8) );
+    }
+
+    SECTION( "symplectic steppers keep the energy bounded" ) {
+        auto accel = [](const std::array<double, 1>& x) { return std::array<double, 1>{-x[0]}; };
+        const std::array<double, 1> x0{1.0}, v0{0.0};
+        for (auto step : {0, 1}) {
+            const auto [x, v] = step == 0 ? tpa::velocity_verlet(accel, x0, v0, 0.05, 20000)
+                                          : tpa::leapfrog(accel, x0, v0, 0.05, 20000);
+            const double energy = 0.5 * (x[0] * x[0] + v[0] * v[0]);
+            REQUIRE( energy == Catch::Approx(0.5).epsilon(1e-3) );
+        }
+        // Second order accurate over a short time.
+        const auto [x, v] = tpa::velocity_verlet(accel, x0, v0, 0.001, 1000);
+        REQUIRE( x[0] == Catch::Approx(std::cos(1.0)).epsilon(1e-6) );
+        REQUIRE( v[0] == Catch::Approx(-std::sin(1.0)).epsilon(1e-5) );
+    }
+}
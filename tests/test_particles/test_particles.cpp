@@ -0,0 +1,47 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cmath>
+#include <vector>
+
+TEST_CASE( "particle kernels", "[particles]" ) {
+    // Three bodies on the x axis.
+    std::vector<double> x{0, 1, 3}, y(3, 0.0), z(3, 0.0), m{1, 2, 4};
+    std::vector<double> ax(3), ay(3), az(3);
+    const std::array pos{x.data(), y.data(), z.data()};
+    const std::array acc{ax.data(), ay.data(), az.data()};
+
+    SECTION( "gravity" ) {
+        tpa::nbody_accelerations(pos, m.data(), 3, acc, 2.0);
+        REQUIRE( ax[0] == Catch::Approx(2.0 * (2.0 / 1 + 4.0 / 9)) );
+        REQUIRE( ax[1] == Catch::Approx(2.0 * (-1.0 / 1 + 4.0 / 4)) );
+        REQUIRE( ax[2] == Catch::Approx(2.0 * (-1.0 / 9 - 2.0 / 4)) );
+        REQUIRE( ay[0] == 0.0 );
+        // Softening.
+        tpa::nbody_accelerations(pos, m.data(), 3, acc, 1.0, 1.0);
+        REQUIRE( ax[0] == Catch::Approx(2.0 / std::pow(2.0, 1.5) + 4.0 * 3 / std::pow(10.0, 1.5)) );
+    }
+
+    SECTION( "cell list pair forces" ) {
+        const tpa::cell_list<double> cells(pos, 3, 1.5);
+        REQUIRE( cells.size() == 3 );
+        REQUIRE( cells.cell_count() == 3 );
+        // Spring-like repulsion within the cutoff: only particles 0 and 1 interact.
+        tpa::pair_forces(cells, 1.5, [](auto r2) { return r2 * 0 + 1; }, acc);
+        REQUIRE( ax[0] == -1.0 );
+        REQUIRE( ax[1] == 1.0 );
+        REQUIRE( ax[2] == 0.0 );
+    }
+
+    SECTION( "kick and drift" ) {
+        std::vector<double> vx{1, 1, 1}, vy{0, 0, 0}, vz{0, 0, 0};
+        const std::array vel{vx.data(), vy.data(), vz.data()};
+        ax = {1, 2, 3};
+        tpa::kick(vel, acc, 3, 0.5);
+        REQUIRE( vx == std::vector<double>{1.5, 2.0, 2.5} );
+        tpa::drift(pos, vel, 3, 2.0);
+        REQUIRE( x == std::vector<double>{3, 5, 8} );
+    }
+}
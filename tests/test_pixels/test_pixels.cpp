@@ -0,0 +1,92 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+template<typename T>
+void check_exhaustive() {
+    // Every pair of 8-bit values against the same operation on int.
+    constexpr int lo = std::numeric_limits<T>::min();
+    constexpr int hi = std::numeric_limits<T>::max();
+    for (int a = lo; a <= hi; ++a)
+        for (int b = lo; b <= hi; ++b) {
+            const T x = T(a), y = T(b);
+            REQUIRE( int(tpa::sat_add(x, y)) == std::clamp(a + b, lo, hi) );
+            REQUIRE( int(tpa::sat_sub(x, y)) == std::clamp(a - b, lo, hi) );
+            REQUIRE( int(tpa::avg(x, y)) == (a + b + 1) >> 1 );
+            REQUIRE( int(tpa::mulhi(x, y)) == (a * b) >> 8 );
+        }
+}
+
+TEST_CASE( "pixel arithmetic", "[pixels]" ) {
+    SECTION( "8-bit" ) {
+        check_exhaustive<uint8_t>();
+        check_exhaustive<int8_t>();
+    }
+
+    SECTION( "16-bit" ) {
+        static_assert(std::is_same_v<decltype(tpa::sat_add(uint16_t(1), 1)), uint16_t>);
+        REQUIRE( tpa::sat_add(uint16_t(65000), 1000) == 65535 );
+        REQUIRE( tpa::sat_sub(uint16_t(5), 1000) == 0 );
+        REQUIRE( tpa::sat_add(int16_t(-32000), -1000) == -32768 );
+        REQUIRE( tpa::sat_sub(int16_t(32000), -1000) == 32767 );
+        REQUIRE( tpa::avg(uint16_t(65535), 65534) == 65535 );
+        REQUIRE( tpa::avg(int16_t(-3), 0) == -1 );
+        REQUIRE( tpa::mulhi(uint16_t(65535), 65535) == 65534 );
+        REQUIRE( tpa::mulhi(int16_t(-32768), -32768) == 16384 );
+        REQUIRE( tpa::mulhi(int16_t(-1), 1) == -1 );
+    }
+
+    SECTION( "widen and narrow" ) {
+        static_assert(std::is_same_v<decltype(tpa::widen(uint8_t(0))), uint16_t>);
+        static_assert(std::is_same_v<decltype(tpa::widen(int16_t(0))), int32_t>);
+        static_assert(std::is_same_v<decltype(tpa::narrow_sat(uint32_t(0))), uint16_t>);
+        REQUIRE( tpa::narrow_sat(uint16_t(300)) == 255 );
+        REQUIRE( tpa::narrow_sat(int16_t(-300)) == -128 );
+        REQUIRE( tpa::narrow_sat(int32_t(1234)) == 1234 );
+        REQUIRE( tpa::narrow_sat(tpa::widen(int8_t(-7))) == -7 );
+    }
+
+    SECTION( "tuples" ) {
+        using rgba = std::array<uint8_t, 4>;
+        const rgba a{ 250, 10, 128, 255 }, b{ 10, 20, 128, 0 };
+        REQUIRE( (tpa::sat_add(a, b) == rgba{ 255, 30, 255, 255 }) );
+        REQUIRE( (tpa::sat_sub(a, b) == rgba{ 240, 0, 0, 255 }) );
+        REQUIRE( (tpa::avg(a, b) == rgba{ 130, 15, 128, 128 }) );
+        REQUIRE( (tpa::mulhi(a, uint8_t(128)) == rgba{ 125, 5, 64, 127 }) );
+        REQUIRE( (tpa::sat_add(a, uint8_t(100)) == rgba{ 255, 110, 228, 255 }) );
+
+        const auto t = std::tuple<uint16_t, int16_t, uint8_t>{ 65535, -32768, 7 };
+        const auto w = tpa::widen(t);
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(get<0>(w))>, uint32_t>);
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(get<2>(w))>, uint16_t>);
+        REQUIRE( get<1>(w) == -32768 );
+        const auto s = tpa::sat_add(t, std::tuple<uint16_t, int16_t, uint8_t>{ 1, -1, 250 });
+        REQUIRE( get<0>(s) == 65535 );
+        REQUIRE( get<1>(s) == -32768 );
+        REQUIRE( get<2>(s) == 255 );
+        REQUIRE( get<2>(tpa::narrow_sat(w)) == 7 );
+    }
+
+    SECTION( "arrays of pixels" ) {
+        using rgba = std::array<uint8_t, 4>;
+        const size_t n = 1000;
+        std::vector<rgba> a(n), b(n), out(n);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t c = 0; c < 4; ++c) {
+                a[i][c] = uint8_t(i * 7 + c * 50);
+                b[i][c] = uint8_t(i * 13 + c);
+            }
+        tpa::transform_pixels(a.data(), b.data(), out.data(), n, [](auto x, auto y) { return tpa::sat_add(x, y); });
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE( (out[i] == tpa::sat_add(a[i], b[i])) );
+        tpa::transform_pixels(out.data(), out.data(), n, [](auto x) { return tpa::mulhi(x, decltype(x)(200)); }, 4);
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE( (out[i] == tpa::mulhi(tpa::sat_add(a[i], b[i]), uint8_t(200))) );
+    }
+}
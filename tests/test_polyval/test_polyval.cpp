@@ -0,0 +1,56 @@
+#include <tuple_arithmetic.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <type_traits>
+#include <vector>
+
+template<typename T>
+T reference(const std::vector<double>& c, T x) {
+    T r = 0, p = 1;
+    for (double ci : c) {
+        r += T(ci) * p;
+        p *= x;
+    }
+    return r;
+}
+
+TEST_CASE( "polynomial evaluation", "[polyval]" ) {
+
+    SECTION( "compile-time coefficients" ) {
+        static_assert(tpa::polyval<1, 2, 3>(2) == 17);
+        auto a = tpa::polyval<1.0, -0.5, 0.25>(2);
+        REQUIRE( std::is_same_v<decltype(a), double> );
+        REQUIRE( a == 1.0 );
+        REQUIRE( tpa::polyval<>(3.0) == 0.0 );
+        REQUIRE( tpa::polyval<5>(3.0) == 5.0 );
+    }
+
+    SECTION( "Horner and Estrin agree" ) {
+        const std::vector<double> c{1, -2, 0.5, 3, -1, 0.25, 2, -0.125, 1.5, 0.75, -3};
+        for (double x : {-1.5, -0.3, 0.0, 0.7, 1.9}) {
+            REQUIRE( tpa::polyval<1.0, -2.0, 0.5, 3.0, -1.0>(x) ==
+                     Catch::Approx(reference(std::vector<double>(c.begin(), c.begin() + 5), x)) );
+            REQUIRE( tpa::polyval<1.0, -2.0, 0.5, 3.0, -1.0, 0.25, 2.0, -0.125, 1.5, 0.75, -3.0>(x) ==
+                     Catch::Approx(reference(c, x)) );
+        }
+    }
+
+    SECTION( "runtime coefficients" ) {
+        auto c = std::make_tuple(1, 0.5f, 2.0);
+        REQUIRE( tpa::polyval(c, 2.0) == 1 + 1 + 8 );
+        REQUIRE( tpa::polyval(std::array<double, 7>{1, 1, 1, 1, 1, 1, 1}, 2.0) == 127 );
+    }
+
+    SECTION( "element-wise on tuples" ) {
+        auto a = tpa::polyval<1, 1, 1>(std::make_tuple(1, 2.0, 3.0f));
+        REQUIRE( std::is_same_v<decltype(a), std::tuple<int, double, float>> );
+        REQUIRE( a == std::make_tuple(3, 7.0, 13.0f) );
+
+        double data[3] = {0, 1, 2};
+        auto pt = tpa::make_ptr_tuple<3>(data);
+        auto b = tpa::polyval(std::make_tuple(0.0, 0.0, 1.0), pt);
+        REQUIRE( b[0] == 0.0 );
+        REQUIRE( b[2] == 4.0 );
+    }
+}
@@ -0,0 +1,55 @@
+#include <tuple_arithmetic.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cmath>
+#include <numbers>
+
+template<typename A, typename B>
+void require_close(const A& a, const B& b) {
+    constexpr size_t N = std::tuple_size_v<A>;
+    for (size_t i = 0; i < N; ++i)
+        REQUIRE( a[i] == Catch::Approx(b[i]).margin(1e-12) );
+}
+
+TEST_CASE( "quaternions", "[quaternion]" ) {
+    using std::numbers::pi;
+    const auto qz = tpa::quat_from_axis_angle(std::array{0.0, 0.0, 1.0}, pi / 2);
+    const auto qx = tpa::quat_from_axis_angle(std::make_tuple(1, 0, 0), pi / 2);
+
+    SECTION( "rotate" ) {
+        require_close(tpa::quat_rotate(qz, std::array{1.0, 0.0, 0.0}), std::array{0.0, 1.0, 0.0});
+        require_close(tpa::quat_rotate(qx, std::make_tuple(0, 1, 0)), std::array{0.0, 0.0, 1.0});
+        // qz * qx rotates by qx first.
+        const auto q = tpa::quat_mul(qz, qx);
+        require_close(tpa::quat_rotate(q, std::array{0.0, 1.0, 0.0}), std::array{0.0, 0.0, 1.0});
+        require_close(tpa::quat_rotate(q, std::array{0.0, 0.0, 1.0}), std::array{1.0, 0.0, 0.0});
+        require_close(tpa::quat_mul(q, tpa::quat_conjugate(q)), std::array{0.0, 0.0, 0.0, 1.0});
+    }
+
+    SECTION( "matrix conversion" ) {
+        const auto q = tpa::quat_mul(qz, tpa::quat_from_axis_angle(std::array{0.6, 0.0, 0.8}, 2.5));
+        const auto m = tpa::quat_to_mat(q);
+        const std::array v{0.3, -1.2, 2.0};
+        require_close(tpa::matmul(m, v), tpa::quat_rotate(q, v));
+        require_close(tpa::quat_from_mat(m), q);
+        // Half turns, where the w component vanishes.
+        for (const auto& axis : {std::array{1.0, 0.0, 0.0}, std::array{0.0, 0.6, -0.8}, std::array{0.0, 0.0, 1.0}}) {
+            const auto h = tpa::quat_from_axis_angle(axis, pi);
+            const auto r = tpa::quat_from_mat(tpa::quat_to_mat(h));
+            require_close(tpa::quat_rotate(r, v), tpa::quat_rotate(h, v));
+        }
+    }
+
+    SECTION( "interpolation" ) {
+        const tpa::quat<double> id{0, 0, 0, 1};
+        require_close(tpa::slerp(id, qz, 0.5), tpa::quat_from_axis_angle(std::array{0.0, 0.0, 1.0}, pi / 4));
+        require_close(tpa::slerp(id, qz, 1.0), qz);
+        // Shorter arc: -qz is the same rotation.
+        require_close(tpa::slerp(id, qz * -1.0, 0.5), tpa::quat_from_axis_angle(std::array{0.0, 0.0, 1.0}, pi / 4));
+        require_close(tpa::slerp(qz, qz, 0.3), qz);
+        const auto n = tpa::nlerp(id, qz, 0.5);
+        require_close(n, tpa::quat_from_axis_angle(std::array{0.0, 0.0, 1.0}, pi / 4));
+        REQUIRE( std::abs(tpa::nlerp(id, qz, 0.2)[2]) < std::abs(tpa::slerp(id, qz, 0.2)[2]) + 0.01 );
+    }
+}
@@ -0,0 +1,135 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <random>
+#include <tuple>
+#include <vector>
+
+static_assert(std::uniform_random_bit_generator<tpa::philox>);
+
+// Sample mean and variance.
+template<typename T>
+std::pair<double, double> moments(const std::vector<T>& v) {
+    double s = 0, s2 = 0;
+    for (T x : v) {
+        s += x;
+        s2 += double(x) * x;
+    }
+    const double m = s / double(v.size());
+    return {m, s2 / double(v.size()) - m * m};
+}
+
+TEST_CASE( "philox generator", "[random]" ) {
+    SECTION( "known answers" ) {
+        // Philox4x32-10 test vectors of the Random123 library.
+        REQUIRE( tpa::philox::block({0, 0, 0, 0}, {0, 0}) ==
+                 std::array<uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8} );
+        REQUIRE( tpa::philox::block({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}) ==
+                 std::array<uint32_t, 4>{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd} );
+        REQUIRE( tpa::philox::block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) ==
+                 std::array<uint32_t, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1} );
+        // Word 4 b + k of stream s is word k of the block of counter (b, s).
+        tpa::philox g(0x299f31d0a4093822, 0x0370734413198a2e);
+        g.seek(4 * 0x12345678abcdef + 2);
+        const auto r = tpa::philox::block({0x78abcdef, 0x123456, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+        REQUIRE( g() == r[2] );
+        REQUIRE( g() == r[3] );
+    }
+
+    SECTION( "bulk words, jumps and streams" ) {
+        tpa::philox a(42, 7), b(42, 7);
+        std::vector<uint32_t> w(203);
+        for (auto& x : w)
+            x = a();
+        std::vector<uint32_t> v(203);
+        b.fill(v.data(), 1);
+        b.fill(v.data() + 1, 202);
+        REQUIRE( (v == w) );
+        REQUIRE( b.position() == 203 );
+
+        // Unaligned starts and lengths.
+        std::vector<uint32_t> u(150);
+        b.generate(37, u.data(), u.size());
+        REQUIRE( std::equal(u.begin(), u.end(), w.begin() + 37) );
+
+        tpa::philox c(42, 7);
+        c.discard(100);
+        REQUIRE( c() == w[100] );
+
+        tpa::philox d = c.split(8);
+        REQUIRE( d.stream() == 8 );
+        REQUIRE( d.position() == 0 );
+        REQUIRE( d() != w[0] );
+
+        // Usable with the standard distributions.
+        std::uniform_int_distribution<int> dist(1, 6);
+        tpa::philox e(1);
+        for (int i = 0; i < 100; ++i) {
+            const int r = dist(e);
+            REQUIRE( (r >= 1 and r <= 6) );
+        }
+    }
+
+    SECTION( "variates" ) {
+        tpa::philox g(3);
+        const auto u = tpa::uniform<double>(g);
+        REQUIRE( (u >= 0.0 and u < 1.0) );
+        REQUIRE( g.position() == 2 );
+        const auto f = tpa::uniform<float>(g, -2.0f, -1.0f);
+        REQUIRE( (f >= -2.0f and f < -1.0f) );
+        REQUIRE( g.position() == 3 );
+
+        // Tuple elements are drawn in order.
+        tpa::philox h(5), k(5);
+        const auto t = tpa::uniform<std::tuple<float, double>>(h);
+        REQUIRE( std::get<0>(t) == tpa::uniform<float>(k) );
+        REQUIRE( std::get<1>(t) == tpa::uniform<double>(k) );
+        const auto n = tpa::normal<std::array<double, 2>>(h, 1.0, 2.0);
+        REQUIRE( n[0] == tpa::normal<double>(k, 1.0, 2.0) );
+        REQUIRE( n[1] == tpa::normal<double>(k, 1.0, 2.0) );
+        REQUIRE( tpa::exponential<double>(h, 3.0) == tpa::exponential<double>(k, 3.0) );
+        REQUIRE( h.position() == k.position() );
+    }
+
+    SECTION( "bulk fills" ) {
+        const size_t n = 100001;
+        tpa::philox g(11);
+        std::vector<double> u(n), z(n), e(n);
+        tpa::fill_uniform(g, u.data(), n);
+        tpa::fill_normal(g, z.data(), n, 0.0, 1.0);
+        tpa::fill_exponential(g, e.data(), n, 2.0);
+        const auto [um, uv] = moments(u);
+        REQUIRE( um == Catch::Approx(0.5).margin(0.01) );
+        REQUIRE( uv == Catch::Approx(1.0 / 12).margin(0.01) );
+        const auto [zm, zv] = moments(z);
+        REQUIRE( zm == Catch::Approx(0.0).margin(0.02) );
+        REQUIRE( zv == Catch::Approx(1.0).margin(0.02) );
+        const auto [em, ev] = moments(e);
+        REQUIRE( em == Catch::Approx(0.5).margin(0.01) );
+        REQUIRE( ev == Catch::Approx(0.25).margin(0.01) );
+
+        // The result does not depend on the number of threads.
+        for (unsigned threads : {2u, 5u}) {
+            tpa::philox h(11);
+            std::vector<double> u2(n), z2(n), e2(n);
+            tpa::fill_uniform(h, u2.data(), n, 0.0, 1.0, threads);
+            tpa::fill_normal(h, z2.data(), n, 0.0, 1.0, threads);
+            tpa::fill_exponential(h, e2.data(), n, 2.0, threads);
+            REQUIRE( (u2 == u) );
+            REQUIRE( (z2 == z) );
+            REQUIRE( (e2 == e) );
+            REQUIRE( h.position() == g.position() );
+        }
+
+        std::vector<float> f(1000);
+        tpa::philox h(11);
+        tpa::fill_uniform(h, f.data(), f.size(), 2.0f, 3.0f);
+        REQUIRE( *std::min_element(f.begin(), f.end()) >= 2.0f );
+        REQUIRE( *std::max_element(f.begin(), f.end()) < 3.0f );
+    }
+}
@@ -0,0 +1,91 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <tuple>
+
+TEST_CASE( "root finding", "[roots]" ) {
+    SECTION( "newton and halley" ) {
+        auto f = [](double x) { return x * x - 2; };
+        auto df = [](double x) { return 2 * x; };
+        const auto r = tpa::newton(f, df, 1.0);
+        REQUIRE( r.converged );
+        REQUIRE( r.x == Catch::Approx(std::numbers::sqrt2).epsilon(1e-15) );
+        REQUIRE( r.iterations <= 6 );
+
+        const auto h = tpa::halley(f, df, [](double) { return 2.0; }, 1.0);
+        REQUIRE( h.converged );
+        REQUIRE( h.x == Catch::Approx(std::numbers::sqrt2).epsilon(1e-15) );
+        REQUIRE( h.iterations < r.iterations );
+
+        // An exact root stops at once, a flat start fails.
+        const auto e = tpa::newton(f, df, 2.0, 1e-12, 0);
+        REQUIRE( e.iterations == 0 );
+        REQUIRE( tpa::newton([](double x) { return x - 3; }, [](double) { return 1.0; }, 3.0).iterations == 1 );
+        const auto z = tpa::newton(f, df, 0.0);
+        REQUIRE( not z.converged );
+        REQUIRE( z.x == 0.0 );
+
+        // No root: hits the iteration cap.
+        const auto n = tpa::newton([](double x) { return x * x + 1; }, df, 0.5, 1e-12, 30);
+        REQUIRE( not n.converged );
+        REQUIRE( n.iterations == 30 );
+
+        const auto fl = tpa::newton([](float x) { return std::cos(x) - x; }, [](float x) { return -std::sin(x) - 1; }, 1.0f);
+        REQUIRE( fl.converged );
+        REQUIRE( fl.x == Catch::Approx(0.7390851f) );
+    }
+
+    SECTION( "newton on systems" ) {
+        // Intersection of the unit circle and the line y = x.
+        auto f = [](const auto& v) { return std::tuple{v[0] * v[0] + v[1] * v[1] - 1, v[1] - v[0]}; };
+        auto df = [](const std::array<double, 2>& v) {
+            return tpa::mat<double, 2>{{ {2 * v[0], 2 * v[1]}, {-1.0, 1.0} }};
+        };
+        const auto r = tpa::newton(f, df, std::array{1.0, 0.2});
+        REQUIRE( r.converged );
+        REQUIRE( r.x[0] == Catch::Approx(std::sqrt(0.5)).epsilon(1e-14) );
+        REQUIRE( r.x[1] == Catch::Approx(std::sqrt(0.5)).epsilon(1e-14) );
+
+        // Jacobians from dual numbers.
+        auto jf = [&](const std::array<double, 2>& v) { return tpa::jacobian(f, v); };
+        const auto d = tpa::newton(f, jf, std::array{-1.0, -0.2});
+        REQUIRE( d.converged );
+        REQUIRE( d.x[0] == Catch::Approx(-std::sqrt(0.5)).epsilon(1e-14) );
+
+        // A singular Jacobian stops the iteration.
+        const auto s = tpa::newton(f, jf, std::array{0.0, 0.0});
+        REQUIRE( not s.converged );
+        REQUIRE( s.iterations == 1 );
+    }
+
+    SECTION( "itp" ) {
+        const auto r = tpa::itp([](double x) { return std::cos(x) - x; }, 0.0, 1.0, 1e-14);
+        REQUIRE( r.converged );
+        REQUIRE( r.x == Catch::Approx(0.7390851332151607).margin(2e-14) );
+        // Fewer iterations than bisection on smooth functions.
+        REQUIRE( r.iterations < 20 );
+
+        // Decreasing functions, reversed brackets, and the default tolerance.
+        const auto d = tpa::itp([](double x) { return 1 - x * x * x; }, 3.0, -1.0);
+        REQUIRE( d.converged );
+        REQUIRE( d.x == Catch::Approx(1.0).epsilon(1e-14) );
+
+        // Roots at the ends, and brackets without a sign change.
+        REQUIRE( tpa::itp([](double x) { return x; }, 0.0, 1.0).x == 0.0 );
+        REQUIRE( tpa::itp([](double x) { return x - 1; }, 0.0, 1.0).x == 1.0 );
+        const auto n = tpa::itp([](double x) { return x * x + 1; }, -1.0, 1.0);
+        REQUIRE( not n.converged );
+        REQUIRE( n.iterations == 0 );
+
+        // A discontinuous sign change is still bracketed.
+        const auto s = tpa::itp([](double x) { return x < 0.3 ? -1.0 : 1.0; }, 0.0, 1.0, 1e-10);
+        REQUIRE( s.converged );
+        REQUIRE( s.x == Catch::Approx(0.3).margin(1e-10) );
+        REQUIRE( s.iterations <= 34 );
+    }
+}
@@ -0,0 +1,68 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE( "scan operators", "[scan op]" ) {
+
+    SECTION( "inclusive scan" ) {
+        auto a = tpa::inclusive_scan(std::make_tuple(1, 2.0, 3));
+        REQUIRE( std::is_same_v<decltype(a), std::tuple<int, double, double>> );
+        REQUIRE( std::get<1>(a) == 3.0 );
+        REQUIRE( std::get<2>(a) == 6.0 );
+
+        auto b = tpa::inclusive_scan(std::array{1, 2, 3, 4, 5});
+        REQUIRE( b == std::array{1, 3, 6, 10, 15} );
+    }
+
+    SECTION( "exclusive scan" ) {
+        auto a = tpa::exclusive_scan(std::array{1.0, 2.0, 3.0}, 1.0);
+        REQUIRE( a == std::array{1.0, 2.0, 4.0} );
+    }
+
+    SECTION( "scan with op" ) {
+        auto a = tpa::inclusive_scan([](auto a, auto b) { return a > b ? a : b; }, std::array{1, 3, 2, 5});
+        REQUIRE( a == std::array{1, 3, 3, 5} );
+        auto b = tpa::exclusive_scan([](auto a, auto b) { return a * b; }, std::array{2, 3, 4}, 1);
+        REQUIRE( b == std::array{1, 2, 6} );
+    }
+}
+
+TEST_CASE( "bulk scan", "[scan op]" ) {
+    const size_t n = 100003;
+    std::vector<int> in(n);
+    for (size_t i = 0; i < n; ++i) in[i] = int(i % 7) - 3;
+    std::vector<long long> ref(n);
+    long long acc = 0;
+    for (size_t i = 0; i < n; ++i) ref[i] = acc += in[i];
+
+    SECTION( "scalar array" ) {
+        std::vector<long long> out(n);
+        tpa::inclusive_scan(in.data(), out.data(), n);
+        REQUIRE( (out == ref) );
+        tpa::inclusive_scan(in.data(), out.data(), n, 4);
+        REQUIRE( (out == ref) );
+
+        std::vector<int> ex(in);
+        tpa::exclusive_scan(ex.data(), ex.data(), n, 10, 3);
+        std::vector<int> ex_ref(n, 10);
+        for (size_t i = 1; i < n; ++i) ex_ref[i] += int(ref[i-1]);
+        REQUIRE( (ex == ex_ref) );
+    }
+
+    SECTION( "records and columns" ) {
+        std::vector<std::tuple<int, double>> rec(n);
+        for (size_t i = 0; i < n; ++i) rec[i] = {in[i], 0.5};
+        tpa::inclusive_scan(rec.data(), rec.data(), n, 2);
+        REQUIRE( std::get<0>(rec[n-1]) == ref[n-1] );
+        REQUIRE( std::get<1>(rec[n-1]) == 0.5 * n );
+
+        std::vector<int> c0(n);
+        std::vector<double> c1(n, 1.0);
+        tpa::exclusive_scan(std::tuple{in.data(), c1.data()}, std::tuple{c0.data(), c1.data()}, n, std::tuple{0, 1.0});
+        REQUIRE( c0[n-1] == ref[n-2] );
+        REQUIRE( c1[n-1] == double(n) );
+    }
+}
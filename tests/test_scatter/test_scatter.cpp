@@ -0,0 +1,50 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <type_traits>
+
+TEST_CASE( "scatter add", "[scatter]" ) {
+
+    SECTION( "duplicated indices accumulate" ) {
+        std::array<double, 4> hist{0, 0, 0, 0};
+        tpa::scatter_add(hist.data(), std::array{1, 3, 1}, std::tuple{1, 2.0, 3.0f});
+        REQUIRE(hist[0] == 0.0);
+        REQUIRE(hist[1] == 4.0);
+        REQUIRE(hist[3] == 2.0);
+    }
+
+    SECTION( "tuple-valued bins" ) {
+        std::array<std::array<float, 3>, 2> aos{};
+        tpa::scatter_add(aos.data(), 1, std::tuple{1, 2, 3});
+        tpa::scatter_add(aos.data(), std::array{1, 1}, 1.0f);
+        REQUIRE(aos[0] == std::array<float, 3>{0, 0, 0});
+        REQUIRE(aos[1] == std::array<float, 3>{3, 4, 5});
+
+        std::array<double, 2> x{}, y{}, z{};
+        tpa::scatter_add(std::tuple{x.data(), y.data(), z.data()}, 0, std::tuple{1, 2, 3});
+        REQUIRE(x[0] == 1.0);
+        REQUIRE(y[0] == 2.0);
+        REQUIRE(z[0] == 3.0);
+    }
+}
+
+TEST_CASE( "histogram", "[scatter]" ) {
+    std::array<int, 10> idx{0, 1, 1, 2, 2, 2, 3, 3, 3, 3};
+
+    SECTION( "counts" ) {
+        std::array<int, 4> hist{};
+        tpa::histogram(hist.data(), idx.data(), idx.size());
+        REQUIRE(hist == std::array{1, 2, 3, 4});
+    }
+
+    SECTION( "AoS weights" ) {
+        std::array<std::array<double, 2>, 10> w;
+        for (size_t i = 0; i < w.size(); ++i) w[i] = {1.0, double(i)};
+        std::array<std::array<double, 2>, 4> hist{};
+        tpa::histogram(hist.data(), idx.data(), w.data(), idx.size());
+        REQUIRE(hist[2][0] == 3.0);
+        REQUIRE(hist[2][1] == 12.0);
+        REQUIRE(hist[3][1] == 30.0);
+    }
+}
@@ -0,0 +1,82 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <vector>
+
+template<size_t N>
+void require_solution(const std::array<double, N>& x, const std::array<double, N>& ref) {
+    for (size_t i = 0; i < N; ++i)
+        REQUIRE( x[i] == Catch::Approx(ref[i]).margin(1e-12) );
+}
+
+TEST_CASE( "small linear solvers", "[solve]" ) {
+    // Needs pivoting: a[0][0] == 0.
+    const tpa::mat<double, 3> a{{ {0, 2, 1}, {1, 1, 1}, {2, 1, 3} }};
+    const std::array x{1.0, -2.0, 3.0};
+    const auto b = tpa::matmul(a, x);
+
+    SECTION( "lu" ) {
+        const auto f = tpa::lu_factor(a);
+        REQUIRE( not f.singular );
+        require_solution(tpa::lu_solve(f, b), x);
+        const tpa::mat<double, 3> s{{ {1, 2, 3}, {2, 4, 6}, {1, 0, 1} }};
+        REQUIRE( tpa::lu_factor(s).singular );
+    }
+
+    SECTION( "cholesky" ) {
+        const auto spd = tpa::matmul(tpa::transpose(a), a);
+        const auto f = tpa::cholesky_factor(spd);
+        REQUIRE( not f.singular );
+        REQUIRE( f.l[0][1] == 0.0 );
+        require_solution(tpa::cholesky_solve(f, tpa::matmul(spd, x)), x);
+        const tpa::mat<double, 2> indefinite{{ {1, 2}, {2, 1} }};
+        REQUIRE( tpa::cholesky_factor(indefinite).singular );
+    }
+
+    SECTION( "qr" ) {
+        const auto f = tpa::qr_factor(a);
+        REQUIRE( not f.singular );
+        require_solution(tpa::qr_solve(f, b), x);
+
+        // Least squares line fit through (0, 1), (1, 3), (2, 5), (3, 7.5)
+        const tpa::mat<double, 4, 2> v{{ {1, 0}, {1, 1}, {1, 2}, {1, 3} }};
+        const auto c = tpa::qr_solve(tpa::qr_factor(v), std::array{1.0, 3.0, 5.0, 7.5});
+        require_solution(c, std::array{0.9, 2.15});
+        const tpa::mat<double, 3, 2> rank1{{ {1, 2}, {2, 4}, {3, 6} }};
+        REQUIRE( tpa::qr_factor(rank1).singular );
+    }
+
+    SECTION( "bulk" ) {
+        const size_t n = 11;
+        std::vector<double> av[9], bv[3], xv[3];
+        for (auto& c : av) c.resize(n);
+        for (auto& c : bv) c.resize(n);
+        for (auto& c : xv) c.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t e = 0; e < 9; ++e)
+                av[e][i] = a[e / 3][e % 3] + (e % 4 == 0 ? 10.0 + double(i) : 0.0);
+            for (size_t r = 0; r < 3; ++r)
+                bv[r][i] = double(r + i);
+        }
+        // System 0 is made singular.
+        for (size_t e = 0; e < 9; ++e)
+            av[e][0] = double(e % 3);
+        std::array<double*, 9> ac;
+        for (size_t e = 0; e < 9; ++e) ac[e] = av[e].data();
+        bool singular[n];
+        const size_t count = tpa::solve_systems<tpa::solver::lu>(ac, std::array{bv[0].data(), bv[1].data(), bv[2].data()},
+                std::array{xv[0].data(), xv[1].data(), xv[2].data()}, n, singular);
+        REQUIRE( count == 1 );
+        REQUIRE( singular[0] );
+        for (size_t i = 1; i < n; ++i) {
+            REQUIRE( not singular[i] );
+            tpa::mat<double, 3> m;
+            for (size_t e = 0; e < 9; ++e) m[e / 3][e % 3] = av[e][i];
+            const auto r = tpa::matmul(m, std::array{xv[0][i], xv[1][i], xv[2][i]});
+            for (size_t k = 0; k < 3; ++k)
+                REQUIRE( r[k] == Catch::Approx(bv[k][i]).margin(1e-12) );
+        }
+    }
+}
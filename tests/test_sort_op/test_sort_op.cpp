@@ -0,0 +1,50 @@
+#include <tuple_arithmetic.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <type_traits>
+
+template<size_t N>
+void check_sort(std::mt19937& gen) {
+    std::uniform_int_distribution<int> dist(-5, 5);
+    for (int rep = 0; rep < 50; ++rep) {
+        std::array<int, N> a;
+        for (auto& v : a) v = dist(gen);
+        auto ref = a;
+        std::sort(ref.begin(), ref.end());
+        REQUIRE( tpa::sort(a) == ref );
+        auto idx = tpa::argsort(a);
+        for (size_t k = 0; k < N; ++k) REQUIRE( a[idx[k]] == ref[k] );
+        REQUIRE( tpa::nth_element<N/3>(a) == ref[N/3] );
+    }
+}
+
+TEST_CASE( "sorting networks", "[sort op]" ) {
+    std::mt19937 gen(42);
+
+    SECTION( "every size up to 32" ) {
+        []<size_t...N>(std::mt19937& g, std::index_sequence<N...>) {
+            (check_sort<N + 1>(g), ...);
+        }(gen, std::make_index_sequence<32>{});
+    }
+
+    SECTION( "tuple input" ) {
+        auto a = tpa::sort(std::make_tuple(3.0, 1.0, 2.0));
+        REQUIRE( std::is_same_v<decltype(a), std::array<double, 3>> );
+        REQUIRE( a == std::array{1.0, 2.0, 3.0} );
+    }
+
+    SECTION( "median" ) {
+        REQUIRE( tpa::median(std::array{5, 1, 4, 2, 3}) == 3 );
+        REQUIRE( tpa::median(std::array{4.0, 1.0, 3.0, 2.0}) == 2.5 );
+    }
+
+    SECTION( "NaN keeps a permutation" ) {
+        auto a = tpa::sort(std::array{2.0, std::nan(""), 1.0});
+        REQUIRE( std::count_if(a.begin(), a.end(), [](double v) { return std::isnan(v); }) == 1 );
+        REQUIRE( std::count(a.begin(), a.end(), 1.0) == 1 );
+        REQUIRE( std::count(a.begin(), a.end(), 2.0) == 1 );
+    }
+}
@@ -0,0 +1,125 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <tuple>
+#include <vector>
+
+// De Casteljau reference for one Bézier segment.
+template<size_t N>
+std::array<double, 2> casteljau(std::array<std::array<double, 2>, N> p, double t) {
+    for (size_t k = N - 1; k > 0; --k)
+        for (size_t j = 0; j < k; ++j)
+            for (size_t d = 0; d < 2; ++d)
+                p[j][d] = (1 - t) * p[j][d] + t * p[j + 1][d];
+    return p[0];
+}
+
+TEST_CASE( "splines", "[spline]" ) {
+    const std::vector<std::tuple<double, double>> pts{
+        {0, 0}, {1, 2}, {3, 3}, {4, 0}, {5, -2}, {7, -1}, {8, 1}, {8, 3}, {6, 4} };
+
+    SECTION( "bezier splines" ) {
+        // Two cubic segments; the last two points are ignored.
+        tpa::bezier_spline<std::tuple<double, double>> c(pts.data(), pts.size());
+        REQUIRE( c.segments() == 2 );
+        REQUIRE( c.size() == 9 );
+        std::array<std::array<double, 2>, 4> s0, s1;
+        for (size_t j = 0; j < 4; ++j) {
+            s0[j] = tpa::detail::to_elems<double>(pts[j]);
+            s1[j] = tpa::detail::to_elems<double>(pts[3 + j]);
+        }
+        for (double t : {0.0, 0.1, 0.25, 0.5, 0.6, 0.99, 1.0}) {
+            const auto ref = t < 0.5 ? casteljau(s0, 2 * t) : casteljau(s1, 2 * t - 1);
+            const auto p = c(t);
+            REQUIRE( p[0] == Catch::Approx(ref[0]).margin(1e-12) );
+            REQUIRE( p[1] == Catch::Approx(ref[1]).margin(1e-12) );
+        }
+        REQUIRE( c(-1.0) == c(0.0) );
+        REQUIRE( c(1.0) == c.control_point(6) );
+
+        // Derivatives against central differences, and at the ends.
+        for (double t : {0.1, 0.3, 0.7, 0.9}) {
+            const double h = 1e-6;
+            const auto d = c.derivative(t);
+            const auto fd = (c(t + h) - c(t - h)) / (2 * h);
+            REQUIRE( d[0] == Catch::Approx(fd[0]).epsilon(1e-6) );
+            REQUIRE( d[1] == Catch::Approx(fd[1]).epsilon(1e-6) );
+        }
+        REQUIRE( c.derivative(0.0)[1] == Catch::Approx(2 * 3 * 2.0) );
+
+        // Quadratic and linear degrees.
+        tpa::bezier_spline<std::tuple<double, double>, 2> q(pts.data(), 3);
+        const auto ref = casteljau<3>({{ {0, 0}, {1, 2}, {3, 3} }}, 0.3);
+        REQUIRE( q(0.3)[0] == Catch::Approx(ref[0]) );
+        tpa::bezier_spline<std::array<int, 2>, 1> l(std::vector<std::array<int, 2>>{{0, 0}, {2, 4}}.data(), 2);
+        REQUIRE( l(0.25) == std::array{0.5, 1.0} );
+    }
+
+    SECTION( "uniform b-splines" ) {
+        tpa::bspline<std::tuple<double, double>> c(pts.data(), pts.size());
+        REQUIRE( c.segments() == 6 );
+        // Start of segment s: (P_s + 4 P_{s+1} + P_{s+2}) / 6.
+        for (size_t s = 0; s <= 6; ++s) {
+            const auto p = c(double(s) / 6);
+            const auto ref = (c.control_point(s) + 4 * c.control_point(s + 1) + c.control_point(s + 2)) / 6.0;
+            REQUIRE( p[0] == Catch::Approx(ref[0]).margin(1e-12) );
+            REQUIRE( p[1] == Catch::Approx(ref[1]).margin(1e-12) );
+            const auto d = c.derivative(double(s) / 6);
+            const auto dref = (c.control_point(s + 2) - c.control_point(s)) / 2.0 * 6.0;
+            REQUIRE( d[0] == Catch::Approx(dref[0]).margin(1e-12) );
+        }
+        // Weights of every degree sum to one.
+        tpa::bspline<std::array<double, 1>, 5> q(std::vector<std::array<double, 1>>(8, {2.5}).data(), 8);
+        REQUIRE( q.segments() == 3 );
+        for (double t = 0; t <= 1; t += 0.05) {
+            REQUIRE( q(t)[0] == Catch::Approx(2.5) );
+            REQUIRE( q.derivative(t)[0] == Catch::Approx(0).margin(1e-12) );
+        }
+    }
+
+    SECTION( "arc length" ) {
+        // A quarter circle of radius 2 as a fine uniform B-spline of a polyline.
+        std::vector<std::array<double, 2>> arc(200);
+        for (size_t i = 0; i < arc.size(); ++i) {
+            const double a = std::numbers::pi / 2 * double(i) / double(arc.size() - 1);
+            arc[i] = { 2 * std::cos(a), 2 * std::sin(a) };
+        }
+        tpa::bspline<std::array<double, 2>, 1> line(arc.data(), arc.size());
+        tpa::arc_length_table table(line, 1000);
+        static_assert(std::is_same_v<decltype(table)::value_type, double>);
+        REQUIRE( table.length() == Catch::Approx(std::numbers::pi).epsilon(1e-4) );
+        REQUIRE( table.length_at(0.0) == 0 );
+        REQUIRE( table.length_at(0.5) == Catch::Approx(table.length() / 2).epsilon(1e-6) );
+        REQUIRE( table.param_at(table.length_at(0.3)) == Catch::Approx(0.3).epsilon(1e-6) );
+        REQUIRE( table.param_at(1e9) == 1.0 );
+
+        // A straight cubic with uneven speed.
+        const std::vector<std::array<double, 1>> s{{0}, {0.1}, {0.2}, {3}};
+        tpa::bezier_spline<std::array<double, 1>> c(s.data(), s.size());
+        tpa::arc_length_table ct(c);
+        REQUIRE( ct.length() == Catch::Approx(3) );
+        for (double t : {0.2, 0.5, 0.8})
+            REQUIRE( ct.length_at(t) == Catch::Approx(c(t)[0]).epsilon(1e-4) );
+        REQUIRE( c(ct.param_at(1.5))[0] == Catch::Approx(1.5).epsilon(1e-3) );
+    }
+
+    SECTION( "sampling to columns" ) {
+        tpa::bspline<std::tuple<double, double>> c(pts.data(), pts.size());
+        const size_t n = 10001;
+        std::vector<double> t(n), x(n), y(n), dx(n), dy(n);
+        for (size_t i = 0; i < n; ++i)
+            t[i] = double(i) / double(n - 1);
+        c.sample(t.data(), n, std::array{x.data(), y.data()}, 3);
+        c.sample_derivative(t.data(), n, std::tuple{dx.data(), dy.data()});
+        for (size_t i = 0; i < n; i += 97) {
+            REQUIRE( x[i] == Catch::Approx(c(t[i])[0]) );
+            REQUIRE( y[i] == Catch::Approx(c(t[i])[1]) );
+            REQUIRE( dy[i] == Catch::Approx(c.derivative(t[i])[1]) );
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <array>
+#include <cmath>
+#include <random>
+#include <tuple>
+#include <vector>
+
+TEST_CASE( "running statistics", "[stats]" ) {
+    // Records with a large offset, where sums of squares lose all precision:
+    // Welford agrees with two passes to the rounding of the offset, about 1e-7.
+    const size_t n = 10007;
+    std::mt19937 rng(5);
+    std::normal_distribution<double> dist;
+    std::vector<double> x(n), y(n), z(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = 1e9 + dist(rng);
+        y[i] = 2 * (x[i] - 1e9) + 0.5 * dist(rng);
+        z[i] = -3 + 0.1 * dist(rng);
+    }
+    auto two_pass = [&](const std::vector<double>& a, const std::vector<double>& b) {
+        double ma = 0, mb = 0;
+        for (size_t i = 0; i < n; ++i) {
+            ma += a[i];
+            mb += b[i];
+        }
+        ma /= double(n);
+        mb /= double(n);
+        double c = 0;
+        for (size_t i = 0; i < n; ++i)
+            c += (a[i] - ma) * (b[i] - mb);
+        return std::pair{ma, c / double(n)};
+    };
+
+    SECTION( "one record at a time" ) {
+        tpa::running_stats<std::tuple<double, double, double>, true> s;
+        REQUIRE( s.count() == 0 );
+        for (size_t i = 0; i < n; ++i)
+            s.push(std::tuple{x[i], y[i], z[i]});
+        REQUIRE( s.count() == n );
+        const auto [mx, vx] = two_pass(x, x);
+        const auto [my, cxy] = two_pass(x, y);
+        REQUIRE( s.mean()[0] == Catch::Approx(mx).epsilon(1e-14) );
+        REQUIRE( s.mean()[1] == Catch::Approx(two_pass(y, y).first) );
+        REQUIRE( s.variance()[0] == Catch::Approx(vx).epsilon(1e-6) );
+        REQUIRE( s.variance(1)[2] == Catch::Approx(two_pass(z, z).second * double(n) / double(n - 1)) );
+        REQUIRE( s.stddev()[1] == Catch::Approx(std::sqrt(two_pass(y, y).second)) );
+        const auto c = s.covariance();
+        REQUIRE( c[0][1] == Catch::Approx(cxy).epsilon(1e-6) );
+        REQUIRE( c[1][0] == Catch::Approx(cxy).epsilon(1e-6) );
+        REQUIRE( c[0][0] == Catch::Approx(s.variance()[0]) );
+        REQUIRE( c[0][2] == Catch::Approx(two_pass(x, z).second).margin(1e-12) );
+        REQUIRE( s.min()[2] == *std::min_element(z.begin(), z.end()) );
+        REQUIRE( s.max()[0] == *std::max_element(x.begin(), x.end()) );
+    }
+
+    SECTION( "merge" ) {
+        tpa::running_stats<std::array<double, 3>, true> all, a, b, empty;
+        for (size_t i = 0; i < n; ++i) {
+            all.push(std::array{x[i], y[i], z[i]});
+            (i < 1234 ? a : b).push(std::array{x[i], y[i], z[i]});
+        }
+        a.merge(empty);
+        empty.merge(a);
+        REQUIRE( empty.count() == a.count() );
+        a.merge(b);
+        REQUIRE( a.count() == n );
+        for (size_t k = 0; k < 3; ++k) {
+            REQUIRE( a.mean()[k] == Catch::Approx(all.mean()[k]).epsilon(1e-14) );
+            REQUIRE( a.variance()[k] == Catch::Approx(all.variance()[k]).epsilon(1e-6) );
+            REQUIRE( a.min()[k] == all.min()[k] );
+            REQUIRE( a.max()[k] == all.max()[k] );
+            for (size_t j = 0; j < 3; ++j)
+                REQUIRE( a.covariance()[k][j] == Catch::Approx(all.covariance()[k][j]).epsilon(1e-6).margin(1e-7) );
+        }
+    }
+
+    SECTION( "column sets and threads" ) {
+        tpa::running_stats<std::array<double, 3>> one;
+        for (size_t i = 0; i < n; ++i)
+            one.push(std::array{x[i], y[i], z[i]});
+        const std::array<const double*, 3> cols{x.data(), y.data(), z.data()};
+        for (unsigned threads : {1u, 3u}) {
+            tpa::running_stats<std::array<double, 3>> s;
+            s.push(cols, n, threads);
+            REQUIRE( s.count() == n );
+            for (size_t k = 0; k < 3; ++k) {
+                REQUIRE( s.mean()[k] == Catch::Approx(one.mean()[k]).epsilon(1e-14) );
+                REQUIRE( s.variance()[k] == Catch::Approx(one.variance()[k]).epsilon(1e-6) );
+                REQUIRE( s.min()[k] == one.min()[k] );
+                REQUIRE( s.max()[k] == one.max()[k] );
+            }
+        }
+    }
+
+    SECTION( "integer records" ) {
+        tpa::running_stats<std::array<int, 2>> s;
+        static_assert(std::is_same_v<decltype(s)::value_type, double>);
+        s.push(std::array{1, 10});
+        s.push(std::array{2, 20});
+        s.push(std::array{6, 30});
+        REQUIRE( s.mean()[0] == Catch::Approx(3.0) );
+        REQUIRE( s.variance(1)[1] == Catch::Approx(100.0) );
+        REQUIRE( s.min()[0] == 1.0 );
+        REQUIRE( s.max()[1] == 30.0 );
+    }
+}
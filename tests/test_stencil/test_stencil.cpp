@@ -0,0 +1,155 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+using boundary = tpa::stencil_boundary;
+
+// Pixel (x, y) of component c of a width x height image, or the boundary value.
+template<boundary B, size_t C>
+double pixel(const std::vector<double>& img, std::ptrdiff_t w, std::ptrdiff_t h,
+        std::ptrdiff_t x, std::ptrdiff_t y, size_t c) {
+    auto map = [](std::ptrdiff_t i, std::ptrdiff_t n) -> std::ptrdiff_t {
+        if (i >= 0 and i < n)
+            return i;
+        if (B == boundary::clamp)
+            return i < 0 ? 0 : n - 1;
+        if (B == boundary::wrap)
+            return ((i % n) + n) % n;
+        if (B == boundary::mirror) {
+            if (n == 1)
+                return 0;
+            while (i < 0 or i >= n)
+                i = i < 0 ? -i : 2 * (n - 1) - i;
+            return i;
+        }
+        return -1;
+    };
+    x = map(x, w);
+    y = map(y, h);
+    if (x < 0 or y < 0)
+        return 0;
+    return img[size_t(y * w + x) * C + c];
+}
+
+template<boundary B, size_t C, size_t KY, size_t KX>
+std::vector<double> naive_stencil(const std::vector<double>& img, size_t w, size_t h,
+        const std::array<std::array<double, KX>, KY>& k) {
+    std::vector<double> ret(img.size());
+    for (size_t y = 0; y < h; ++y)
+        for (size_t x = 0; x < w; ++x)
+            for (size_t c = 0; c < C; ++c) {
+                double acc = 0;
+                for (size_t i = 0; i < KY; ++i)
+                    for (size_t j = 0; j < KX; ++j)
+                        acc += k[i][j] * pixel<B, C>(img, w, h,
+                            std::ptrdiff_t(x + j) - std::ptrdiff_t(KX / 2),
+                            std::ptrdiff_t(y + i) - std::ptrdiff_t(KY / 2), c);
+                ret[(y * w + x) * C + c] = acc;
+            }
+    return ret;
+}
+
+std::vector<double> image(size_t n) {
+    std::vector<double> ret(n);
+    for (size_t i = 0; i < n; ++i)
+        ret[i] = std::sin(double(i * 7 % 31)) + double(i % 3);
+    return ret;
+}
+
+template<boundary B>
+void check_boundary() {
+    // 1D, scalar pixels, including signals shorter than the stencil.
+    for (size_t n : {1, 2, 3, 5, 17, 40}) {
+        const auto in = image(n);
+        std::vector<double> out(n);
+        tpa::stencil1d<B>(in.data(), out.data(), n, std::tuple{0.25, 0.5f, 0.25, -1.0, 2.0});
+        const auto ref = naive_stencil<B, 1, 1, 5>(in, n, 1, {{{0.25, 0.5, 0.25, -1.0, 2.0}}});
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE( out[i] == Catch::Approx(ref[i]) );
+    }
+
+    // 2D, three-component pixels, with an even width kernel.
+    const size_t w = 13, h = 7;
+    const auto flat = image(3 * w * h);
+    std::vector<std::array<double, 3>> in(w * h), out(w * h);
+    std::copy_n(flat.data(), flat.size(), in[0].data());
+    const auto k = std::tuple{
+        std::tuple{1.0, 2.0, 0.5, -1.0},
+        std::array{0.0, 3.0, 1.0, 1.0},
+        std::tuple{0.5, -2.0, 1.0, 0.25},
+    };
+    tpa::stencil2d<B>(in.data(), out.data(), w, h, k);
+    const auto ref = naive_stencil<B, 3, 3, 4>(flat, w, h,
+        {{{1.0, 2.0, 0.5, -1.0}, {0.0, 3.0, 1.0, 1.0}, {0.5, -2.0, 1.0, 0.25}}});
+    for (size_t i = 0; i < w * h; ++i)
+        for (size_t c = 0; c < 3; ++c)
+            REQUIRE( out[i][c] == Catch::Approx(ref[3 * i + c]) );
+}
+
+TEST_CASE( "stencils", "[stencil]" ) {
+    SECTION( "clamp" ) { check_boundary<boundary::clamp>(); }
+    SECTION( "wrap" ) { check_boundary<boundary::wrap>(); }
+    SECTION( "mirror" ) { check_boundary<boundary::mirror>(); }
+    SECTION( "zero" ) { check_boundary<boundary::zero>(); }
+
+    SECTION( "box blur" ) {
+        const size_t w = 5, h = 4;
+        std::vector<float> in(w * h, 2.0f), out(w * h);
+        const auto row = std::tuple{1.0f / 9, 1.0f / 9, 1.0f / 9};
+        tpa::stencil2d(in.data(), out.data(), w, h, std::tuple{row, row, row});
+        for (float v : out)
+            REQUIRE( v == Catch::Approx(2.0f) );
+    }
+
+    SECTION( "integer pixels" ) {
+        // Sums are taken in floating point, then rounded and saturated.
+        std::vector<uint8_t> in(7, 200), out(7);
+        tpa::stencil1d(in.data(), out.data(), in.size(), std::tuple{0.25, 0.5, 0.25});
+        for (auto v : out)
+            REQUIRE( v == 200 );
+        tpa::stencil1d(in.data(), out.data(), in.size(), std::tuple{1, 1, 1});
+        for (auto v : out)
+            REQUIRE( v == 255 );
+
+        const std::vector<int16_t> s{ -30000, 100, 30000, 7, -3 };
+        std::vector<int16_t> d(s.size());
+        tpa::stencil1d<boundary::zero>(s.data(), d.data(), s.size(), std::tuple{-1.0f, 1.5f, 0.0f});
+        REQUIRE( (d == std::vector<int16_t>{ -32768, 30150, 32767, -29990, -12 }) );
+
+        const size_t w = 6, h = 5;
+        std::vector<std::array<uint8_t, 3>> rgb(w * h), blurred(w * h);
+        for (size_t i = 0; i < rgb.size(); ++i)
+            rgb[i] = { uint8_t(i * 37 % 256), uint8_t(i * 11 % 256), uint8_t(255 - i) };
+        const auto row = std::tuple{1.0, 2.0, 1.0};
+        tpa::stencil2d<boundary::wrap>(rgb.data(), blurred.data(), w, h, std::tuple{row / 16.0, row / 8.0, row / 16.0});
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                for (size_t c = 0; c < 3; ++c) {
+                    double acc = 0;
+                    for (size_t i = 0; i < 3; ++i)
+                        for (size_t j = 0; j < 3; ++j)
+                            acc += (i == 1 ? 2 : 1) * (j == 1 ? 2 : 1) / 16.0 * rgb[(y + h + i - 1) % h * w + (x + w + j - 1) % w][c];
+                    REQUIRE( blurred[y * w + x][c] == std::nearbyint(acc) );
+                }
+    }
+
+    SECTION( "threads" ) {
+        const size_t w = 300, h = 200;
+        const auto in = image(w * h);
+        std::vector<double> a(w * h), b(w * h);
+        const auto k = std::tuple{std::tuple{1.0, 2.0, 1.0}, std::tuple{0.0, 0.0, 0.0}, std::tuple{-1.0, -2.0, -1.0}};
+        tpa::stencil2d<boundary::mirror>(in.data(), a.data(), w, h, k);
+        tpa::stencil2d<boundary::mirror>(in.data(), b.data(), w, h, k, 4);
+        REQUIRE( (a == b) );
+        tpa::stencil1d(in.data(), a.data(), w * h, std::tuple{1.0, -2.0, 1.0});
+        tpa::stencil1d(in.data(), b.data(), w * h, std::tuple{1.0, -2.0, 1.0}, 4);
+        REQUIRE( (a == b) );
+    }
+}
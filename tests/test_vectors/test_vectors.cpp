@@ -0,0 +1,68 @@
+#include <tuple_arithmetic.hpp>
+#include <tuple_algorithm.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+TEST_CASE( "bulk vector operations", "[vectors]" ) {
+    const size_t n = 13;
+    std::vector<std::array<double, 3>> a(n), b(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = {double(i), 1.0, -0.5 * double(i)};
+        b[i] = {2.0, double(i % 3), 1.0};
+    }
+    a[4] = {0, 0, 0};
+
+    SECTION( "dot and norms" ) {
+        std::vector<double> d(n), s(n), l(n);
+        tpa::dot(a.data(), b.data(), d.data(), n);
+        tpa::squared_norm(a.data(), s.data(), n);
+        tpa::norm(a.data(), l.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            REQUIRE( d[i] == Catch::Approx(tpa::dot(a[i], b[i])) );
+            REQUIRE( s[i] == Catch::Approx(tpa::dot(a[i], a[i])) );
+            REQUIRE( l[i] == Catch::Approx(std::sqrt(s[i])) );
+        }
+    }
+
+    SECTION( "cross" ) {
+        // SoA output from AoS inputs
+        std::vector<float> x(n), y(n), z(n);
+        tpa::cross(a.data(), b.data(), std::array{x.data(), y.data(), z.data()}, n);
+        for (size_t i = 0; i < n; ++i) {
+            const auto c = tpa::cross(a[i], b[i]);
+            REQUIRE( x[i] == Catch::Approx(c[0]) );
+            REQUIRE( y[i] == Catch::Approx(c[1]) );
+            REQUIRE( z[i] == Catch::Approx(c[2]) );
+        }
+        // 2-vectors give a scalar
+        std::vector<double> c2(n);
+        tpa::cross(std::array{x.data(), y.data()}, std::array{y.data(), z.data()}, c2.data(), n);
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE( c2[i] == Catch::Approx(double(x[i]) * z[i] - double(y[i]) * y[i]) );
+    }
+
+    SECTION( "normalize" ) {
+        std::vector<std::array<double, 3>> u(n);
+        tpa::normalize(a.data(), u.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            if (i == 4) {
+                REQUIRE( u[i] == std::array{0.0, 0.0, 0.0} );
+                continue;
+            }
+            REQUIRE( tpa::dot(u[i], u[i]) == Catch::Approx(1.0) );
+            REQUIRE( u[i][0] * tpa::norm(a[i]) == Catch::Approx(a[i][0]) );
+        }
+        // Records that are not std::arrays, in place
+        std::vector<std::tuple<float, float>> t(n, std::tuple{3.0f, 4.0f});
+        t[1] = {0.0f, 0.0f};
+        tpa::normalize<tpa::degenerate::keep>(t.data(), t.data(), n);
+        REQUIRE( t[0] == std::tuple{0.6f, 0.8f} );
+        REQUIRE( t[1] == std::tuple{0.0f, 0.0f} );
+        tpa::normalize<tpa::degenerate::nan>(a.data(), u.data(), n);
+        REQUIRE( std::isnan(u[4][0]) );
+    }
+}
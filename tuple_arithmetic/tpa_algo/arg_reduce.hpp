@@ -0,0 +1,129 @@
+/**
+ * Bulk reductions with index over arrays and column sets.
+ *
+ * min_element(p, n) returns (value, index) of the first minimum of p[0..n),
+ * or of the first NaN if there is one; max_element likewise. For a column set
+ * (see soa.hpp) every column is reduced independently and a tuple of results
+ * is returned. n must be positive.
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    template<bool Max, typename T>
+    FORCE_INLINE constexpr void update_extremum(std::pair<T, size_t>& best, const T& v, size_t i) {
+        if (extremum_better<Max>(v, best.first) or
+            (not extremum_better<Max>(best.first, v) and i < best.second))
+            best = {v, i};
+    }
+
+    /**
+     * One pass over p[0..n) for every extremum in Max...
+     * Each lane keeps its best value and the iteration it was found in. The
+     * iteration counter is an integer of the same width as T, so the loop runs in
+     * blocks short enough not to overflow it, and lanes are folded after each block.
+     */
+    template<bool...Max, typename T>
+    std::array<std::pair<T, size_t>, sizeof...(Max)> column_extrema(const T* p, size_t n) {
+        constexpr size_t K = sizeof...(Max);
+        std::array<std::pair<T, size_t>, K> best;
+        best.fill({p[0], 0});
+        size_t i = 1;
+        if constexpr (simd_scalar<T>) {
+            using simd_t = xsimd::batch<T>;
+            using int_t = xsimd::as_integer_t<T>;
+            using ib_t = xsimd::batch<int_t>;
+            constexpr size_t W = simd_t::size;
+            constexpr size_t block = size_t(std::numeric_limits<int_t>::max());
+            i = 0;
+            while (i + W <= n) {
+                const size_t base = i;
+                const size_t iters = std::min((n - base) / W, block);
+                std::array<simd_t, K> bv;
+                std::array<ib_t, K> bi;
+                bv.fill(simd_t::load_unaligned(p + base));
+                bi.fill(ib_t(int_t(0)));
+                for (size_t j = 1; j < iters; ++j) {
+                    const auto v = simd_t::load_unaligned(p + base + j * W);
+                    const auto jb = ib_t(int_t(j));
+                    constexpr_for<0, K, 1>([&](auto k) {
+                        constexpr bool M = std::array{Max...}[decltype(k)::value];
+                        const auto take = extremum_better<M>(v, bv[k]);
+                        bv[k] = xsimd::select(take, v, bv[k]);
+                        bi[k] = xsimd::select(xsimd::batch_bool_cast<int_t>(take), jb, bi[k]);
+                    });
+                }
+                constexpr_for<0, K, 1>([&](auto k) {
+                    constexpr bool M = std::array{Max...}[decltype(k)::value];
+                    const auto va = to_array(bv[k]);
+                    const auto ia = to_array(bi[k]);
+                    for (size_t l = 0; l < W; ++l)
+                        update_extremum<M>(best[k], va[l], base + size_t(ia[l]) * W + l);
+                });
+                i = base + iters * W;
+            }
+        }
+        for (; i < n; ++i)
+            constexpr_for<0, K, 1>([&](auto k) {
+                update_extremum<std::array{Max...}[decltype(k)::value]>(best[k], p[i], i);
+            });
+        return best;
+    }
+
+    // pick(column_extrema<Max...>(p, n)) for a column, or for every column of a column set.
+    template<bool...Max, typename Src, typename Pick>
+    FORCE_INLINE auto bulk_extrema(Src&& src, size_t n, Pick&& pick) {
+        if constexpr (soa_columns<Src>)
+            return apply_unary_op([n, &pick](auto p) { return pick(column_extrema<Max...>(p, n)); }, std::forward<Src>(src));
+        else
+            return pick(column_extrema<Max...>(src, n));
+    }
+
+    template<typename Src>
+    concept extremum_range = soa_columns<Src> or column_pointer<Src>;
+}
+
+// (value, index) of the first minimum of p[0..n), or a tuple of them for a column set.
+template<typename Src>
+    requires( detail::extremum_range<Src> )
+auto min_element(Src&& src, size_t n) {
+    return detail::bulk_extrema<false>(std::forward<Src>(src), n, [](auto&& r) { return r[0]; });
+}
+
+template<typename Src>
+    requires( detail::extremum_range<Src> )
+auto max_element(Src&& src, size_t n) {
+    return detail::bulk_extrema<true>(std::forward<Src>(src), n, [](auto&& r) { return r[0]; });
+}
+
+// ((min, index), (max, index)) in a single pass.
+template<typename Src>
+    requires( detail::extremum_range<Src> )
+auto minmax_element(Src&& src, size_t n) {
+    return detail::bulk_extrema<false, true>(std::forward<Src>(src), n, [](auto&& r) { return std::pair{r[0], r[1]}; });
+}
+
+template<typename Src>
+    requires( detail::extremum_range<Src> )
+auto argmin(Src&& src, size_t n) {
+    return detail::bulk_extrema<false>(std::forward<Src>(src), n, [](auto&& r) { return r[0].second; });
+}
+
+template<typename Src>
+    requires( detail::extremum_range<Src> )
+auto argmax(Src&& src, size_t n) {
+    return detail::bulk_extrema<true>(std::forward<Src>(src), n, [](auto&& r) { return r[0].second; });
+}
+
+}
@@ -0,0 +1,523 @@
+/**
+ * Forward-mode automatic differentiation with dual numbers.
+ *
+ * A dual<T, N> carries a value and its N partial derivatives as a
+ * std::array<T, N>; for scalar T the derivative part is updated with tuple
+ * operators, SIMD-backed where the array fits a batch. T is a scalar, or a
+ * batch to differentiate at W points at once, one per lane. Arithmetic and
+ * the math functions mapped in tuple_math.hpp apply the chain rule; they are
+ * found by ADL, so code written with `using std::sin; sin(x)`, or with tuple
+ * operators on tuples of duals, differentiates unchanged.
+ *
+ * gradient and jacobian seed one dual variable per input and evaluate the
+ * function once, which yields all partials in a single pass.
+ */
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <numbers>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+
+#pragma once
+
+namespace tpa {
+
+// value + sum deriv[k] e_k, where the e_k are infinitesimal and e_j e_k = 0.
+template<typename T, size_t N>
+struct dual {
+    using value_type = T;
+    static constexpr size_t dim = N;
+
+    T value;
+    std::array<T, N> deriv;
+
+    dual() = default;
+
+    // A constant: all partials are zero.
+    constexpr dual(const T& v) : value(v) {
+        constexpr_for<0, N, 1>([&](auto K) { deriv[K] = T(0); });
+    }
+
+    constexpr dual(const T& v, const std::array<T, N>& d) : value(v), deriv(d) {}
+
+    // The k-th variable: its partial with respect to itself is one.
+    static constexpr dual variable(const T& v, size_t k) {
+        dual ret(v);
+        ret.deriv[k] = T(1);
+        return ret;
+    }
+
+    constexpr dual& operator+=(const dual& b) { return *this = *this + b; }
+    constexpr dual& operator-=(const dual& b) { return *this = *this - b; }
+    constexpr dual& operator*=(const dual& b) { return *this = *this * b; }
+    constexpr dual& operator/=(const dual& b) { return *this = *this / b; }
+};
+
+namespace detail {
+    template<typename T> struct is_dual : std::false_type {};
+    template<typename T, size_t N> struct is_dual<dual<T, N>> : std::true_type {};
+
+    template<typename T>
+    static constexpr bool is_dual_v = is_dual<std::remove_cvref_t<T>>::value;
+
+    template<typename...A> struct first_dual { using type = void; };
+    template<typename A, typename...B> struct first_dual<A, B...> {
+        using type = std::conditional_t<is_dual_v<A>, std::remove_cvref_t<A>, typename first_dual<B...>::type>;
+    };
+
+    // The dual type of a mixed argument list.
+    template<typename...A>
+    using dual_result_t = typename first_dual<A...>::type;
+
+    template<typename A, typename D>
+    concept dual_compatible = std::same_as<std::remove_cvref_t<A>, D> or
+        (not is_dual_v<A> and std::is_convertible_v<const A&, typename D::value_type>);
+
+    // At least one dual, and the other arguments are duals of the same type
+    // or constants convertible to its value type.
+    template<typename...A>
+    concept dual_args = (is_dual_v<A> or ...) and (dual_compatible<A, dual_result_t<A...>> and ...);
+
+    // Variables are stored in floating point.
+    template<typename T>
+    using dual_value_t = std::conditional_t<std::is_integral_v<T>, double, T>;
+
+    template<typename T, typename A>
+    FORCE_INLINE constexpr T dual_value(const A& a) {
+        if constexpr (is_dual_v<A>)
+            return a.value;
+        else
+            return T(a);
+    }
+
+    // Operations on derivative parts. Scalar partials use the tuple operators,
+    // vectorized when the array fits a batch; arrays of batches go element by
+    // element, as the tuple operators could take W batches for W lanes.
+    template<typename T, size_t N>
+    FORCE_INLINE constexpr std::array<T, N> deriv_scale(const std::array<T, N>& d, const T& s) {
+        if constexpr (std::is_arithmetic_v<T>)
+            return d * s;
+        else {
+            std::array<T, N> ret;
+            constexpr_for<0, N, 1>([&](auto K) { ret[K] = d[K] * s; });
+            return ret;
+        }
+    }
+
+    // d s + acc
+    template<typename T, size_t N>
+    FORCE_INLINE constexpr std::array<T, N> deriv_fma(const std::array<T, N>& d, const T& s, const std::array<T, N>& acc) {
+        if constexpr (std::is_arithmetic_v<T>)
+            return d * s + acc;
+        else {
+            std::array<T, N> ret;
+            constexpr_for<0, N, 1>([&](auto K) { ret[K] = fma_elem(d[K], s, acc[K]); });
+            return ret;
+        }
+    }
+
+    template<typename T, size_t N>
+    FORCE_INLINE constexpr std::array<T, N> deriv_add(const std::array<T, N>& a, const std::array<T, N>& b) {
+        if constexpr (std::is_arithmetic_v<T>)
+            return a + b;
+        else {
+            std::array<T, N> ret;
+            constexpr_for<0, N, 1>([&](auto K) { ret[K] = a[K] + b[K]; });
+            return ret;
+        }
+    }
+
+    template<typename T, size_t N>
+    FORCE_INLINE constexpr std::array<T, N> deriv_sub(const std::array<T, N>& a, const std::array<T, N>& b) {
+        if constexpr (std::is_arithmetic_v<T>)
+            return a - b;
+        else {
+            std::array<T, N> ret;
+            constexpr_for<0, N, 1>([&](auto K) { ret[K] = a[K] - b[K]; });
+            return ret;
+        }
+    }
+
+    // sum p[k] a_k' over the dual arguments a_k.
+    template<typename T, size_t N, size_t K = 0, size_t M, typename A, typename...B>
+    FORCE_INLINE constexpr std::array<T, N> dual_sum(const std::array<T, M>& p, const A& a, const B&...b) {
+        if constexpr (not is_dual_v<A>)
+            return dual_sum<T, N, K + 1>(p, b...);
+        else if constexpr (not (is_dual_v<B> or ...))
+            return deriv_scale(a.deriv, p[K]);
+        else
+            return deriv_fma(a.deriv, p[K], dual_sum<T, N, K + 1>(p, b...));
+    }
+
+    // f(a...) with value y and partials p: the chain rule.
+    template<typename...A>
+    FORCE_INLINE constexpr auto dual_chain(const typename dual_result_t<A...>::value_type& y,
+            const std::array<typename dual_result_t<A...>::value_type, sizeof...(A)>& p, const A&...a) {
+        using D = dual_result_t<A...>;
+        return D{y, dual_sum<typename D::value_type, D::dim>(p, a...)};
+    }
+
+    // cond ? a : b, lane by lane.
+    template<typename T, size_t N>
+    FORCE_INLINE dual<T, N> dual_pick(const lane_mask_t<T>& cond, const dual<T, N>& a, const dual<T, N>& b) {
+        dual<T, N> ret;
+        ret.value = lane_select<T>(cond, a.value, b.value);
+        constexpr_for<0, N, 1>([&](auto K) { ret.deriv[K] = lane_select<T>(cond, a.deriv[K], b.deriv[K]); });
+        return ret;
+    }
+
+    // Partials of y, or zeros if y does not depend on the variables.
+    template<typename T, size_t N, typename Y>
+    FORCE_INLINE constexpr std::array<T, N> dual_deriv(const Y& y) {
+        if constexpr (is_dual_v<Y>)
+            return y.deriv;
+        else
+            return dual<T, N>(T(y)).deriv;
+    }
+
+    // The digamma function psi = Gamma' / Gamma, for the derivatives of tgamma
+    // and lgamma: reflection below 1/2, upward recurrence to y >= 8.5 and the
+    // asymptotic series there.
+    template<typename U>
+    FORCE_INLINE U digamma(const U& x) {
+        using S = max_type_t<U>;
+        using std::log;
+        using std::tan;
+        constexpr S pi = std::numbers::pi_v<S>;
+        const auto reflect = x < U(S(0.5));
+        U y = lane_select<U>(reflect, U(S(1)) - x, x);
+        U acc = U(S(0));
+        for (int k = 0; k < 8; ++k) {
+            acc = acc - U(S(1)) / y;
+            y = y + U(S(1));
+        }
+        const U r = U(S(1)) / y;
+        const U r2 = r * r;
+        const U series = r2 * (S(1) / 12 - r2 * (S(1) / 120 - r2 * (S(1) / 252 - r2 * (S(1) / 240 - r2 * (S(1) / 132)))));
+        acc = acc + log(y) - U(S(0.5)) * r - series;
+        return lane_select<U>(reflect, acc - U(pi) / tan(U(pi) * x), acc);
+    }
+}
+
+// Arithmetic
+
+template<typename T, size_t N>
+FORCE_INLINE constexpr dual<T, N> operator+(const dual<T, N>& a) { return a; }
+
+template<typename T, size_t N>
+FORCE_INLINE constexpr dual<T, N> operator-(const dual<T, N>& a) { return dual<T, N>{-a.value, detail::deriv_scale(a.deriv, T(-1))}; }
+
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE constexpr auto operator+(const A& a, const B& b) {
+    using D = detail::dual_result_t<A, B>;
+    using T = typename D::value_type;
+    const T y = detail::dual_value<T>(a) + detail::dual_value<T>(b);
+    if constexpr (not detail::is_dual_v<A>)
+        return D{y, b.deriv};
+    else if constexpr (not detail::is_dual_v<B>)
+        return D{y, a.deriv};
+    else
+        return D{y, detail::deriv_add(a.deriv, b.deriv)};
+}
+
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE constexpr auto operator-(const A& a, const B& b) {
+    using D = detail::dual_result_t<A, B>;
+    using T = typename D::value_type;
+    const T y = detail::dual_value<T>(a) - detail::dual_value<T>(b);
+    if constexpr (not detail::is_dual_v<A>)
+        return D{y, detail::deriv_scale(b.deriv, T(-1))};
+    else if constexpr (not detail::is_dual_v<B>)
+        return D{y, a.deriv};
+    else
+        return D{y, detail::deriv_sub(a.deriv, b.deriv)};
+}
+
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE constexpr auto operator*(const A& a, const B& b) {
+    using T = typename detail::dual_result_t<A, B>::value_type;
+    const T x = detail::dual_value<T>(a), y = detail::dual_value<T>(b);
+    return detail::dual_chain(x * y, {y, x}, a, b);
+}
+
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE constexpr auto operator/(const A& a, const B& b) {
+    using T = typename detail::dual_result_t<A, B>::value_type;
+    const T r = T(1) / detail::dual_value<T>(b);
+    const T q = detail::dual_value<T>(a) * r;
+    return detail::dual_chain(q, {r, -q * r}, a, b);
+}
+
+// Comparisons look at the values only.
+#define TP_DUAL_COMPARE(OP) \
+template<typename A, typename B> \
+    requires( detail::dual_args<A, B> ) \
+FORCE_INLINE constexpr auto operator OP(const A& a, const B& b) { \
+    using T = typename detail::dual_result_t<A, B>::value_type; \
+    return detail::dual_value<T>(a) OP detail::dual_value<T>(b); \
+}
+
+TP_DUAL_COMPARE(==)
+TP_DUAL_COMPARE(!=)
+TP_DUAL_COMPARE(<)
+TP_DUAL_COMPARE(<=)
+TP_DUAL_COMPARE(>)
+TP_DUAL_COMPARE(>=)
+
+#undef TP_DUAL_COMPARE
+
+// Unary functions
+
+// FN_NAME(a) = FN_NAME(x) and FN_NAME'(a) = DERIV, an expression in x = a.value,
+// y = FN_NAME(x) and the scalar type S.
+#define TP_DUAL_UNARY_FN(FN_NAME, DERIV) \
+template<typename T, size_t N> \
+FORCE_INLINE dual<T, N> FN_NAME(const dual<T, N>& a) { \
+    using S [[maybe_unused]] = max_type_t<T>; \
+    using std::FN_NAME; \
+    const T& x = a.value; \
+    const T y = FN_NAME(x); \
+    return dual<T, N>{y, detail::deriv_scale(a.deriv, T(DERIV))}; \
+}
+
+// Piecewise constant: the derivative is zero almost everywhere.
+#define TP_DUAL_STEP_FN(FN_NAME) \
+template<typename T, size_t N> \
+FORCE_INLINE dual<T, N> FN_NAME(const dual<T, N>& a) { \
+    using std::FN_NAME; \
+    return dual<T, N>(FN_NAME(a.value)); \
+}
+
+// Functions of the value only, returning no dual.
+#define TP_DUAL_VALUE_FN(FN_NAME) \
+template<typename T, size_t N> \
+FORCE_INLINE auto FN_NAME(const dual<T, N>& a) { \
+    using std::FN_NAME; \
+    return FN_NAME(a.value); \
+}
+
+TP_DUAL_VALUE_FN(fpclassify)
+TP_DUAL_VALUE_FN(isfinite)
+TP_DUAL_VALUE_FN(isnan)
+TP_DUAL_VALUE_FN(isnormal)
+TP_DUAL_VALUE_FN(lrint)
+TP_DUAL_VALUE_FN(llrint)
+
+// |x|' is taken as 1 at 0.
+TP_DUAL_UNARY_FN(abs, detail::lane_select<T>(x < T(S(0)), T(S(-1)), T(S(1))))
+TP_DUAL_UNARY_FN(fabs, detail::lane_select<T>(x < T(S(0)), T(S(-1)), T(S(1))))
+
+TP_DUAL_UNARY_FN(exp, y)
+TP_DUAL_UNARY_FN(exp2, y * T(std::numbers::ln2_v<S>))
+TP_DUAL_UNARY_FN(expm1, y + T(S(1)))
+TP_DUAL_UNARY_FN(log, T(S(1)) / x)
+TP_DUAL_UNARY_FN(log10, T(S(1) / std::numbers::ln10_v<S>) / x)
+TP_DUAL_UNARY_FN(log2, T(S(1) / std::numbers::ln2_v<S>) / x)
+TP_DUAL_UNARY_FN(log1p, T(S(1)) / (T(S(1)) + x))
+
+TP_DUAL_UNARY_FN(sqrt, T(S(0.5)) / y)
+TP_DUAL_UNARY_FN(cbrt, T(S(1)) / (T(S(3)) * y * y))
+
+TP_DUAL_UNARY_FN(sin, [&] { using std::cos; return cos(x); }())
+TP_DUAL_UNARY_FN(cos, [&] { using std::sin; return -sin(x); }())
+TP_DUAL_UNARY_FN(tan, T(S(1)) + y * y)
+TP_DUAL_UNARY_FN(asin, [&] { using std::sqrt; return T(S(1)) / sqrt(T(S(1)) - x * x); }())
+TP_DUAL_UNARY_FN(acos, [&] { using std::sqrt; return T(S(-1)) / sqrt(T(S(1)) - x * x); }())
+TP_DUAL_UNARY_FN(atan, T(S(1)) / (T(S(1)) + x * x))
+
+TP_DUAL_UNARY_FN(sinh, [&] { using std::cosh; return cosh(x); }())
+TP_DUAL_UNARY_FN(cosh, [&] { using std::sinh; return sinh(x); }())
+TP_DUAL_UNARY_FN(tanh, T(S(1)) - y * y)
+TP_DUAL_UNARY_FN(asinh, [&] { using std::sqrt; return T(S(1)) / sqrt(x * x + T(S(1))); }())
+TP_DUAL_UNARY_FN(acosh, [&] { using std::sqrt; return T(S(1)) / (sqrt(x - T(S(1))) * sqrt(x + T(S(1)))); }())
+TP_DUAL_UNARY_FN(atanh, T(S(1)) / (T(S(1)) - x * x))
+
+TP_DUAL_UNARY_FN(erf, [&] { using std::exp; return T(S(2) * std::numbers::inv_sqrtpi_v<S>) * exp(-x * x); }())
+TP_DUAL_UNARY_FN(erfc, [&] { using std::exp; return T(S(-2) * std::numbers::inv_sqrtpi_v<S>) * exp(-x * x); }())
+TP_DUAL_UNARY_FN(tgamma, y * detail::digamma(x))
+TP_DUAL_UNARY_FN(lgamma, detail::digamma(x))
+
+TP_DUAL_STEP_FN(ceil)
+TP_DUAL_STEP_FN(floor)
+TP_DUAL_STEP_FN(trunc)
+TP_DUAL_STEP_FN(round)
+TP_DUAL_STEP_FN(nearbyint)
+TP_DUAL_STEP_FN(rint)
+
+#undef TP_DUAL_UNARY_FN
+#undef TP_DUAL_STEP_FN
+#undef TP_DUAL_VALUE_FN
+
+// Binary and ternary functions: any argument may be a constant.
+
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE auto pow(const A& a, const B& b) {
+    using D = detail::dual_result_t<A, B>;
+    using T = typename D::value_type;
+    using std::pow;
+    using std::log;
+    const T x = detail::dual_value<T>(a), e = detail::dual_value<T>(b);
+    const T y = pow(x, e);
+    // The exponent's partial is only formed when it is a variable: it is NaN for x <= 0.
+    if constexpr (not detail::is_dual_v<A>)
+        return D{y, detail::deriv_scale(b.deriv, y * log(x))};
+    else if constexpr (not detail::is_dual_v<B>)
+        return D{y, detail::deriv_scale(a.deriv, e * pow(x, e - T(1)))};
+    else
+        return detail::dual_chain(y, {e * pow(x, e - T(1)), y * log(x)}, a, b);
+}
+
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE auto atan2(const A& a, const B& b) {
+    using T = typename detail::dual_result_t<A, B>::value_type;
+    using std::atan2;
+    const T y = detail::dual_value<T>(a), x = detail::dual_value<T>(b);
+    const T r = T(1) / (x * x + y * y);
+    return detail::dual_chain(atan2(y, x), {x * r, -y * r}, a, b);
+}
+
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE auto hypot(const A& a, const B& b) {
+    using T = typename detail::dual_result_t<A, B>::value_type;
+    using std::hypot;
+    const T x = detail::dual_value<T>(a), y = detail::dual_value<T>(b);
+    const T h = hypot(x, y);
+    const T r = T(1) / h;
+    return detail::dual_chain(h, {x * r, y * r}, a, b);
+}
+
+template<typename A, typename B, typename C>
+    requires( detail::dual_args<A, B, C> )
+FORCE_INLINE auto hypot(const A& a, const B& b, const C& c) {
+    using T = typename detail::dual_result_t<A, B, C>::value_type;
+    using std::sqrt;
+    const T x = detail::dual_value<T>(a), y = detail::dual_value<T>(b), z = detail::dual_value<T>(c);
+    const T h = sqrt(x * x + y * y + z * z);
+    const T r = T(1) / h;
+    return detail::dual_chain(h, {x * r, y * r, z * r}, a, b, c);
+}
+
+// min and max follow the argument they return; the first one on ties. fmin
+// and fmax return the other argument when one of them is NaN. PICK_B tells
+// when to return b, in terms of x = a.value and y = b.value. The overloads on
+// two duals are preferred over std::min and std::max.
+#define TP_DUAL_SELECT_FN(FN_NAME, PICK_B) \
+template<typename T, size_t N> \
+FORCE_INLINE dual<T, N> FN_NAME(const dual<T, N>& a, const dual<T, N>& b) { \
+    const T& x = a.value; \
+    const T& y = b.value; \
+    const detail::lane_mask_t<T> pick = PICK_B; \
+    return detail::dual_pick(pick, b, a); \
+} \
+template<typename A, typename B> \
+    requires( detail::dual_args<A, B> ) \
+FORCE_INLINE auto FN_NAME(const A& a, const B& b) { \
+    using D = detail::dual_result_t<A, B>; \
+    return FN_NAME(D(a), D(b)); \
+}
+
+TP_DUAL_SELECT_FN(min, y < x)
+TP_DUAL_SELECT_FN(max, y > x)
+TP_DUAL_SELECT_FN(fmin, (y < x) | (x != x))
+TP_DUAL_SELECT_FN(fmax, (y > x) | (x != x))
+
+#undef TP_DUAL_SELECT_FN
+
+// max(a - b, 0)
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE auto fdim(const A& a, const B& b) {
+    using D = detail::dual_result_t<A, B>;
+    return max(a - b, D(typename D::value_type(0)));
+}
+
+// a - n b, n = trunc(a / b): the partials are 1 and -n.
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE auto fmod(const A& a, const B& b) {
+    using T = typename detail::dual_result_t<A, B>::value_type;
+    using std::fmod;
+    using std::trunc;
+    const T x = detail::dual_value<T>(a), y = detail::dual_value<T>(b);
+    return detail::dual_chain(fmod(x, y), {T(1), -trunc(x / y)}, a, b);
+}
+
+// a - n b, n = a / b rounded to nearest even.
+template<typename A, typename B>
+    requires( detail::dual_args<A, B> )
+FORCE_INLINE auto remainder(const A& a, const B& b) {
+    using T = typename detail::dual_result_t<A, B>::value_type;
+    using std::remainder;
+    using std::nearbyint;
+    const T x = detail::dual_value<T>(a), y = detail::dual_value<T>(b);
+    const T r = remainder(x, y);
+    return detail::dual_chain(r, {T(1), -nearbyint((x - r) / y)}, a, b);
+}
+
+template<typename A, typename B, typename C>
+    requires( detail::dual_args<A, B, C> )
+FORCE_INLINE auto fma(const A& a, const B& b, const C& c) {
+    using T = typename detail::dual_result_t<A, B, C>::value_type;
+    const T x = detail::dual_value<T>(a), y = detail::dual_value<T>(b), z = detail::dual_value<T>(c);
+    return detail::dual_chain(detail::fma_elem(x, y, z), {y, x, T(1)}, a, b, c);
+}
+
+// a + t (b - a)
+template<typename A, typename B, typename C>
+    requires( detail::dual_args<A, B, C> )
+FORCE_INLINE auto lerp(const A& a, const B& b, const C& t) {
+    using T = typename detail::dual_result_t<A, B, C>::value_type;
+    const T x = detail::dual_value<T>(a), y = detail::dual_value<T>(b), s = detail::dual_value<T>(t);
+    return detail::dual_chain(detail::fma_elem(s, y - x, x), {T(1) - s, s, y - x}, a, b, t);
+}
+
+// Differentiation
+
+// x as N dual variables: element k has a unit partial with respect to itself.
+template<tuple_like X>
+FORCE_INLINE auto dual_variables(const X& x) {
+    using T = detail::dual_value_t<std::remove_cvref_t<tuple_max_type_t<X>>>;
+    constexpr size_t N = tpa_tuple_size_v<X>;
+    std::array<dual<T, N>, N> ret;
+    constexpr_for<0, N, 1>([&](auto K) { ret[K] = dual<T, N>::variable(T(get<K>(x)), K); });
+    return ret;
+}
+
+/**
+ * Gradient of the scalar function f at x: f is called once with the
+ * std::array of dual variables of x, and the partials of its result are
+ * returned as a std::array. With batch elements, each lane is a point.
+ */
+template<tuple_like X, typename F>
+FORCE_INLINE auto gradient(F&& f, const X& x) {
+    using T = detail::dual_value_t<std::remove_cvref_t<tuple_max_type_t<X>>>;
+    constexpr size_t N = tpa_tuple_size_v<X>;
+    return detail::dual_deriv<T, N>(f(dual_variables(x)));
+}
+
+// Jacobian of the vector function f at x, as a row-major mat: row i holds the
+// partials of element i of f(x). f is called once.
+template<tuple_like X, typename F>
+FORCE_INLINE auto jacobian(F&& f, const X& x) {
+    using T = detail::dual_value_t<std::remove_cvref_t<tuple_max_type_t<X>>>;
+    constexpr size_t N = tpa_tuple_size_v<X>;
+    const auto y = f(dual_variables(x));
+    using Y = std::remove_cvref_t<decltype(y)>;
+    mat<T, tpa_tuple_size_v<Y>, N> ret;
+    constexpr_for<0, tpa_tuple_size_v<Y>, 1>([&](auto I) { ret[I] = detail::dual_deriv<T, N>(get<I>(y)); });
+    return ret;
+}
+
+}
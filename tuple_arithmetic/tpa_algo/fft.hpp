@@ -0,0 +1,238 @@
+/**
+ * Fixed-size FFT codelets for N = 2, 4, ..., 64 complex points.
+ *
+ * Signals are tuples: split, as a tuple of real parts and a tuple of
+ * imaginary parts, or interleaved, as one tuple (re0, im0, re1, im1, ...).
+ * Elements are scalars, or batches to transform one signal per lane. Each
+ * size is a fully unrolled radix-2 decimation in time: the bit reversal is a
+ * compile-time permutation and the twiddles are constexpr, so the butterflies
+ * by 1 and -i cost no multiplication. fft_many transforms arrays of
+ * interleaved records a batch of records at a time.
+ */
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <numbers>
+#include <type_traits>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Minimum number of records per chunk in threaded transforms.
+    inline constexpr size_t fft_grain = 64;
+
+    template<size_t N>
+    inline constexpr bool fft_size = std::has_single_bit(N) and N >= 2 and N <= 64;
+
+    // sin and cos for |x| <= pi / 4, by their Taylor series.
+    constexpr double fft_sin(double x) {
+        double term = x, sum = x;
+        for (int k = 1; k < 12; ++k) {
+            term *= -x * x / double((2 * k) * (2 * k + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double fft_cos(double x) {
+        double term = 1, sum = 1;
+        for (int k = 1; k < 12; ++k) {
+            term *= -x * x / double((2 * k - 1) * (2 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // (cos, sin) of 2 pi k / N for k <= N / 2, reduced to the first octant.
+    constexpr std::array<double, 2> fft_unit_root(size_t k, size_t N) {
+        if (4 * k > N) {
+            const auto r = fft_unit_root(N / 2 - k, N);
+            return { -r[0], r[1] };
+        }
+        if (8 * k > N) {
+            const auto r = fft_unit_root(N / 4 - k, N);
+            return { r[1], r[0] };
+        }
+        const double x = 2 * std::numbers::pi * double(k) / double(N);
+        return { fft_cos(x), fft_sin(x) };
+    }
+
+    template<size_t N>
+    constexpr size_t bit_reverse(size_t i) {
+        size_t r = 0;
+        for (size_t b = 1; b < N; b <<= 1) {
+            r = (r << 1) | (i & 1);
+            i >>= 1;
+        }
+        return r;
+    }
+
+    // x[a], x[b] = x[a] + w x[b], x[a] - w x[b] with w = exp(-+2 pi i K / N).
+    template<size_t N, size_t K, bool Inverse, typename U>
+    FORCE_INLINE void fft_butterfly(std::array<U, N>& re, std::array<U, N>& im, size_t a, size_t b) {
+        using T = max_type_t<U>;
+        U tr, ti;
+        if constexpr (K == 0) {
+            tr = re[b];
+            ti = im[b];
+        }
+        else if constexpr (4 * K == N) {
+            // w = -i, or i for the inverse.
+            tr = Inverse ? -im[b] : im[b];
+            ti = Inverse ? re[b] : -re[b];
+        }
+        else {
+            constexpr auto w = fft_unit_root(K, N);
+            const U c = U(T(w[0]));
+            const U s = U(T(Inverse ? w[1] : -w[1]));
+            tr = fma_elem(re[b], c, -(im[b] * s));
+            ti = fma_elem(re[b], s, im[b] * c);
+        }
+        re[b] = re[a] - tr;
+        im[b] = im[a] - ti;
+        re[a] = re[a] + tr;
+        im[a] = im[a] + ti;
+    }
+
+    // In-place transform of a signal stored in bit-reversed order.
+    template<size_t N, bool Inverse, typename U>
+    FORCE_INLINE void fft_kernel(std::array<U, N>& re, std::array<U, N>& im) {
+        constexpr_for<1, std::bit_width(N), 1>([&](auto S) {
+            constexpr size_t m = size_t(1) << S;
+            constexpr_for<0, m / 2, 1>([&](auto J) {
+                for (size_t g = 0; g < N; g += m)
+                    fft_butterfly<N, J * (N / m), Inverse>(re, im, g + J, g + J + m / 2);
+            });
+        });
+        if constexpr (Inverse) {
+            const U scale(max_type_t<U>(1) / max_type_t<U>(N));
+            for (size_t k = 0; k < N; ++k) {
+                re[k] = re[k] * scale;
+                im[k] = im[k] * scale;
+            }
+        }
+    }
+
+    template<bool Inverse, typename Re, typename Im>
+    FORCE_INLINE void fft_split(Re& re, Im& im) {
+        constexpr size_t N = tpa_tuple_size_v<Re>;
+        static_assert(tpa_tuple_size_v<Im> == N, "fft: real and imaginary parts must have the same size");
+        static_assert(fft_size<N>, "fft: the size must be a power of two from 2 to 64");
+        using U = std::remove_cvref_t<tuple_max_type_t<Re>>;
+        std::array<U, N> r, i;
+        constexpr_for<0, N, 1>([&](auto K) {
+            r[bit_reverse<N>(K)] = U(get<K>(re));
+            i[bit_reverse<N>(K)] = U(get<K>(im));
+        });
+        fft_kernel<N, Inverse>(r, i);
+        constexpr_for<0, N, 1>([&](auto K) {
+            get<K>(re) = std::remove_cvref_t<decltype(get<K>(re))>(r[K]);
+            get<K>(im) = std::remove_cvref_t<decltype(get<K>(im))>(i[K]);
+        });
+    }
+
+    template<bool Inverse, typename X>
+    FORCE_INLINE void fft_interleaved(X& x) {
+        constexpr size_t N = tpa_tuple_size_v<X> / 2;
+        static_assert(tpa_tuple_size_v<X> % 2 == 0, "fft_interleaved: the signal must have an even number of elements");
+        static_assert(fft_size<N>, "fft_interleaved: the size must be a power of two from 2 to 64");
+        using U = std::remove_cvref_t<tuple_max_type_t<X>>;
+        std::array<U, N> r, i;
+        constexpr_for<0, N, 1>([&](auto K) {
+            r[bit_reverse<N>(K)] = U(get<2 * K>(x));
+            i[bit_reverse<N>(K)] = U(get<2 * K + 1>(x));
+        });
+        fft_kernel<N, Inverse>(r, i);
+        constexpr_for<0, N, 1>([&](auto K) {
+            get<2 * K>(x) = std::remove_cvref_t<decltype(get<2 * K>(x))>(r[K]);
+            get<2 * K + 1>(x) = std::remove_cvref_t<decltype(get<2 * K + 1>(x))>(i[K]);
+        });
+    }
+
+    // Records [begin, end) of N interleaved complex values, W records at a time.
+    template<size_t N, bool Inverse, typename T>
+    void fft_records(T* data, size_t begin, size_t end) {
+        size_t j = begin;
+        if constexpr (simd_scalar<T>) {
+            using simd_t = xsimd::batch<T>;
+            using ib_t = xsimd::batch<xsimd::as_integer_t<T>>;
+            using int_t = typename ib_t::value_type;
+            constexpr size_t W = simd_t::size;
+            std::array<int_t, W> offsets;
+            for (size_t l = 0; l < W; ++l)
+                offsets[l] = int_t(2 * N * l);
+            const ib_t idx = ib_t::load_unaligned(offsets.data());
+            for (; j + W <= end; j += W) {
+                T* p = data + 2 * N * j;
+                std::array<simd_t, N> r, i;
+                constexpr_for<0, N, 1>([&](auto K) {
+                    r[bit_reverse<N>(K)] = simd_t::gather(p + 2 * K, idx);
+                    i[bit_reverse<N>(K)] = simd_t::gather(p + 2 * K + 1, idx);
+                });
+                fft_kernel<N, Inverse>(r, i);
+                for (size_t k = 0; k < N; ++k) {
+                    r[k].scatter(p + 2 * k, idx);
+                    i[k].scatter(p + 2 * k + 1, idx);
+                }
+            }
+        }
+        for (; j < end; ++j) {
+            T* p = data + 2 * N * j;
+            std::array<T, N> r, i;
+            constexpr_for<0, N, 1>([&](auto K) {
+                r[bit_reverse<N>(K)] = p[2 * K];
+                i[bit_reverse<N>(K)] = p[2 * K + 1];
+            });
+            fft_kernel<N, Inverse>(r, i);
+            for (size_t k = 0; k < N; ++k) {
+                p[2 * k] = r[k];
+                p[2 * k + 1] = i[k];
+            }
+        }
+    }
+}
+
+/**
+ * In-place DFT X[j] = sum_k x[k] exp(-2 pi i j k / N) of the complex signal
+ * x[k] = re[k] + i im[k]. ifft is its inverse, scaled by 1 / N.
+ */
+template<tuple_like Re, tuple_like Im>
+FORCE_INLINE void fft(Re&& re, Im&& im) { detail::fft_split<false>(re, im); }
+
+template<tuple_like Re, tuple_like Im>
+FORCE_INLINE void ifft(Re&& re, Im&& im) { detail::fft_split<true>(re, im); }
+
+// The same on a signal of 2 N elements (re[0], im[0], re[1], im[1], ...).
+template<tuple_like X>
+FORCE_INLINE void fft_interleaved(X&& x) { detail::fft_interleaved<false>(x); }
+
+template<tuple_like X>
+FORCE_INLINE void ifft_interleaved(X&& x) { detail::fft_interleaved<true>(x); }
+
+/**
+ * In-place transforms of count consecutive records of N interleaved complex
+ * values, e.g. std::complex<T>[count][N] viewed as T*.
+ */
+template<size_t N, typename T>
+void fft_many(T* data, size_t count, unsigned threads = 1) {
+    static_assert(detail::fft_size<N>, "fft_many: the size must be a power of two from 2 to 64");
+    parallel_chunks(count, threads, [&](size_t, size_t begin, size_t end) {
+        detail::fft_records<N, false>(data, begin, end);
+    }, detail::fft_grain);
+}
+
+template<size_t N, typename T>
+void ifft_many(T* data, size_t count, unsigned threads = 1) {
+    static_assert(detail::fft_size<N>, "ifft_many: the size must be a power of two from 2 to 64");
+    parallel_chunks(count, threads, [&](size_t, size_t begin, size_t end) {
+        detail::fft_records<N, true>(data, begin, end);
+    }, detail::fft_grain);
+}
+
+}
@@ -0,0 +1,425 @@
+/**
+ * Multichannel recursive filters: biquad cascades, one-pole smoothers (EMA)
+ * and DC blockers, where every element of a frame is a channel.
+ *
+ * A frame holds one sample of every channel. Its elements are scalars, or
+ * batches for channels packed into lanes, so a frame of two batches of 8
+ * floats advances 16 channels with a few vector instructions. State and
+ * coefficients are kept per channel in the element type, and a sample of all
+ * channels is advanced element by element with fma, as a single recurrence.
+ * Block functions run filters in sequence over interleaved or planar buffers.
+ */
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <tuple>
+#include <type_traits>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Scalar or batch type of the elements of a frame.
+    template<typename Frame>
+    using frame_elem_t = std::remove_cvref_t<tuple_max_type_t<std::remove_cvref_t<Frame>>>;
+
+    // Number of channels in an element of type E.
+    template<typename E>
+    inline constexpr size_t frame_lanes = 1;
+    template<typename E> requires( requires { E::size; } )
+    inline constexpr size_t frame_lanes<E> = E::size;
+
+    template<typename E, size_t D>
+    FORCE_INLINE std::array<E, D> frame_fill(max_type_t<E> v) {
+        std::array<E, D> ret;
+        ret.fill(E(v));
+        return ret;
+    }
+
+    template<typename Frame, typename E, size_t D>
+    FORCE_INLINE Frame frame_from(const std::array<E, D>& a) {
+        Frame ret;
+        constexpr_for<0, D, 1>([&](auto K) {
+            using F = std::remove_cvref_t<std::tuple_element_t<K, Frame>>;
+            get<K>(ret) = F(a[K]);
+        });
+        return ret;
+    }
+
+    // Set channel ch of a frame stored as elements.
+    template<typename E, size_t D>
+    void frame_set(std::array<E, D>& a, size_t ch, max_type_t<E> v) {
+        constexpr size_t W = frame_lanes<E>;
+        if constexpr (W == 1)
+            a[ch] = v;
+        else {
+            auto l = to_array(a[ch / W]);
+            l[ch % W] = v;
+            a[ch / W] = E::load_unaligned(l.data());
+        }
+    }
+
+    // Frame i of an interleaved buffer of frames of D * W values.
+    template<typename E, size_t D, typename T>
+    FORCE_INLINE std::array<E, D> load_frame(const T* p, size_t i) {
+        constexpr size_t W = frame_lanes<E>;
+        p += i * D * W;
+        std::array<E, D> ret;
+        constexpr_for<0, D, 1>([&](auto K) {
+            if constexpr (W == 1)
+                ret[K] = E(p[K]);
+            else
+                ret[K] = E::load_unaligned(p + K * W);
+        });
+        return ret;
+    }
+
+    template<typename E, size_t D, typename T>
+    FORCE_INLINE void store_frame(T* p, size_t i, const std::array<E, D>& a) {
+        constexpr size_t W = frame_lanes<E>;
+        p += i * D * W;
+        constexpr_for<0, D, 1>([&](auto K) {
+            if constexpr (W == 1)
+                p[K] = T(a[K]);
+            else
+                a[K].store_unaligned(p + K * W);
+        });
+    }
+
+    // Record i of a column set with one column per channel, as frame elements.
+    template<typename E, size_t D, typename C>
+    FORCE_INLINE std::array<E, D> gather_frame(const C& cols, size_t i) {
+        constexpr size_t W = frame_lanes<E>;
+        std::array<E, D> ret;
+        constexpr_for<0, D, 1>([&](auto K) {
+            if constexpr (W == 1)
+                ret[K] = E(get<K>(cols)[i]);
+            else {
+                alignas(E) std::array<max_type_t<E>, W> l;
+                constexpr_for<0, W, 1>([&](auto L) { l[L] = get<K * W + L>(cols)[i]; });
+                ret[K] = E::load_aligned(l.data());
+            }
+        });
+        return ret;
+    }
+
+    template<typename E, size_t D, typename C>
+    FORCE_INLINE void scatter_frame(const C& cols, size_t i, const std::array<E, D>& a) {
+        constexpr size_t W = frame_lanes<E>;
+        constexpr_for<0, D, 1>([&](auto K) {
+            if constexpr (W == 1)
+                get<K>(cols)[i] = a[K];
+            else {
+                alignas(E) std::array<max_type_t<E>, W> l;
+                a[K].store_aligned(l.data());
+                constexpr_for<0, W, 1>([&](auto L) { get<K * W + L>(cols)[i] = l[L]; });
+            }
+        });
+    }
+
+    // Types shared by the filters over frames of type Frame.
+    template<typename Frame>
+    struct frame_traits {
+        using elem_type = frame_elem_t<Frame>;
+        using value_type = max_type_t<elem_type>;
+        static constexpr size_t dim = tpa_tuple_size_v<Frame>;
+        static constexpr size_t channels = dim * frame_lanes<elem_type>;
+        using elems_type = std::array<elem_type, dim>;
+    };
+}
+
+/**
+ * Normalized biquad coefficients, a0 = 1:
+ * H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2).
+ * The biquad_* functions design them for a frequency f at sample rate fs
+ * with the formulas of the RBJ audio EQ cookbook.
+ */
+struct biquad_coeffs {
+    double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+};
+
+namespace detail {
+    struct biquad_design {
+        double cw, alpha, a0;
+
+        biquad_design(double f, double fs, double q) {
+            const double w = 2 * std::numbers::pi * f / fs;
+            cw = std::cos(w);
+            alpha = std::sin(w) / (2 * q);
+            a0 = 1 + alpha;
+        }
+
+        biquad_coeffs make(double b0, double b1, double b2) const {
+            return { b0 / a0, b1 / a0, b2 / a0, -2 * cw / a0, (1 - alpha) / a0 };
+        }
+    };
+}
+
+inline biquad_coeffs biquad_lowpass(double f, double fs, double q = std::numbers::sqrt2 / 2) {
+    const detail::biquad_design d(f, fs, q);
+    return d.make((1 - d.cw) / 2, 1 - d.cw, (1 - d.cw) / 2);
+}
+
+inline biquad_coeffs biquad_highpass(double f, double fs, double q = std::numbers::sqrt2 / 2) {
+    const detail::biquad_design d(f, fs, q);
+    return d.make((1 + d.cw) / 2, -(1 + d.cw), (1 + d.cw) / 2);
+}
+
+// Unit gain at f.
+inline biquad_coeffs biquad_bandpass(double f, double fs, double q) {
+    const detail::biquad_design d(f, fs, q);
+    return d.make(d.alpha, 0, -d.alpha);
+}
+
+inline biquad_coeffs biquad_notch(double f, double fs, double q) {
+    const detail::biquad_design d(f, fs, q);
+    return d.make(1, -2 * d.cw, 1);
+}
+
+// Gain of gain_db decibels at f.
+inline biquad_coeffs biquad_peak(double f, double fs, double q, double gain_db) {
+    const double a = std::pow(10.0, gain_db / 40);
+    detail::biquad_design d(f, fs, q);
+    const double alpha = d.alpha;
+    d.a0 = 1 + alpha / a;
+    d.alpha = alpha / a;
+    return d.make(1 + alpha * a, -2 * d.cw, 1 - alpha * a);
+}
+
+/**
+ * Cascade of Stages biquads in transposed direct form II, one cascade per
+ * channel of Frame. Each stage has its own coefficients for every channel;
+ * all stages start as the identity.
+ */
+template<tuple_like Frame, size_t Stages = 1>
+class biquad_cascade {
+    using traits = detail::frame_traits<Frame>;
+    using E = typename traits::elem_type;
+    using elems_type = typename traits::elems_type;
+
+    public:
+        using frame_type = Frame;
+        using value_type = typename traits::value_type;
+        static constexpr size_t dim = traits::dim;
+        static constexpr size_t channels = traits::channels;
+        static constexpr size_t stages = Stages;
+
+        biquad_cascade() {
+            for (auto& c : m_coeffs)
+                c = {
+                    detail::frame_fill<E, dim>(1), detail::frame_fill<E, dim>(0), detail::frame_fill<E, dim>(0),
+                    detail::frame_fill<E, dim>(0), detail::frame_fill<E, dim>(0)
+                };
+            reset();
+        }
+
+        // Every stage set to c, on every channel.
+        explicit biquad_cascade(const biquad_coeffs& c) : biquad_cascade() {
+            for (size_t s = 0; s < Stages; ++s)
+                set(s, c);
+        }
+
+        // Set the coefficients of a stage on every channel, or on one channel.
+        void set(size_t stage, const biquad_coeffs& c) {
+            m_coeffs[stage] = {
+                detail::frame_fill<E, dim>(value_type(c.b0)), detail::frame_fill<E, dim>(value_type(c.b1)),
+                detail::frame_fill<E, dim>(value_type(c.b2)), detail::frame_fill<E, dim>(value_type(c.a1)),
+                detail::frame_fill<E, dim>(value_type(c.a2))
+            };
+        }
+
+        void set(size_t stage, size_t channel, const biquad_coeffs& c) {
+            auto& k = m_coeffs[stage];
+            detail::frame_set(k.b0, channel, value_type(c.b0));
+            detail::frame_set(k.b1, channel, value_type(c.b1));
+            detail::frame_set(k.b2, channel, value_type(c.b2));
+            detail::frame_set(k.a1, channel, value_type(c.a1));
+            detail::frame_set(k.a2, channel, value_type(c.a2));
+        }
+
+        // Clear the state of all stages.
+        void reset() {
+            m_s1.fill(detail::frame_fill<E, dim>(0));
+            m_s2.fill(detail::frame_fill<E, dim>(0));
+        }
+
+        // Filter one sample of every channel.
+        Frame process(const Frame& x) {
+            return detail::frame_from<Frame>(process_elems(detail::to_elems<E>(x)));
+        }
+
+        // The same on the elements of a frame.
+        elems_type process_elems(elems_type x) {
+            using detail::fma_elem;
+            for (size_t s = 0; s < Stages; ++s) {
+                const auto& k = m_coeffs[s];
+                auto& s1 = m_s1[s];
+                auto& s2 = m_s2[s];
+                constexpr_for<0, dim, 1>([&](auto K) {
+                    const E y = fma_elem(k.b0[K], x[K], s1[K]);
+                    s1[K] = fma_elem(k.b1[K], x[K], fma_elem(-k.a1[K], y, s2[K]));
+                    s2[K] = fma_elem(k.b2[K], x[K], -k.a2[K] * y);
+                    x[K] = y;
+                });
+            }
+            return x;
+        }
+
+    private:
+        struct stage {
+            elems_type b0, b1, b2, a1, a2;
+        };
+
+        std::array<stage, Stages> m_coeffs;
+        std::array<elems_type, Stages> m_s1, m_s2;
+};
+
+/**
+ * One-pole lowpass, the exponential moving average y += alpha (x - y),
+ * with its own alpha on every channel of Frame.
+ */
+template<tuple_like Frame>
+class one_pole {
+    using traits = detail::frame_traits<Frame>;
+    using E = typename traits::elem_type;
+    using elems_type = typename traits::elems_type;
+
+    public:
+        using frame_type = Frame;
+        using value_type = typename traits::value_type;
+        static constexpr size_t dim = traits::dim;
+        static constexpr size_t channels = traits::channels;
+
+        // alpha for a cutoff frequency f at sample rate fs.
+        static value_type alpha_for(double f, double fs) {
+            return value_type(1 - std::exp(-2 * std::numbers::pi * f / fs));
+        }
+
+        explicit one_pole(value_type alpha = value_type(1)) :
+            m_alpha(detail::frame_fill<E, dim>(alpha)), m_y(detail::frame_fill<E, dim>(0)) {}
+
+        void set(value_type alpha) { m_alpha = detail::frame_fill<E, dim>(alpha); }
+        void set(size_t channel, value_type alpha) { detail::frame_set(m_alpha, channel, alpha); }
+
+        // Restart from the output y.
+        void reset(const Frame& y) { m_y = detail::to_elems<E>(y); }
+        void reset() { m_y = detail::frame_fill<E, dim>(0); }
+
+        Frame process(const Frame& x) {
+            return detail::frame_from<Frame>(process_elems(detail::to_elems<E>(x)));
+        }
+
+        elems_type process_elems(const elems_type& x) {
+            constexpr_for<0, dim, 1>([&](auto K) {
+                m_y[K] = detail::fma_elem(m_alpha[K], x[K] - m_y[K], m_y[K]);
+            });
+            return m_y;
+        }
+
+    private:
+        elems_type m_alpha, m_y;
+};
+
+/**
+ * DC blocker y[n] = x[n] - x[n-1] + r y[n-1]: a zero at DC and a pole at r,
+ * with its own r on every channel of Frame.
+ */
+template<tuple_like Frame>
+class dc_blocker {
+    using traits = detail::frame_traits<Frame>;
+    using E = typename traits::elem_type;
+    using elems_type = typename traits::elems_type;
+
+    public:
+        using frame_type = Frame;
+        using value_type = typename traits::value_type;
+        static constexpr size_t dim = traits::dim;
+        static constexpr size_t channels = traits::channels;
+
+        // r for a -3 dB corner at about f, for f much lower than fs.
+        static value_type r_for(double f, double fs) {
+            return value_type(1 - 2 * std::numbers::pi * f / fs);
+        }
+
+        explicit dc_blocker(value_type r = value_type(0.995)) : m_r(detail::frame_fill<E, dim>(r)) { reset(); }
+
+        void set(value_type r) { m_r = detail::frame_fill<E, dim>(r); }
+        void set(size_t channel, value_type r) { detail::frame_set(m_r, channel, r); }
+
+        void reset() {
+            m_x = detail::frame_fill<E, dim>(0);
+            m_y = detail::frame_fill<E, dim>(0);
+        }
+
+        Frame process(const Frame& x) {
+            return detail::frame_from<Frame>(process_elems(detail::to_elems<E>(x)));
+        }
+
+        elems_type process_elems(const elems_type& x) {
+            constexpr_for<0, dim, 1>([&](auto K) {
+                m_y[K] = detail::fma_elem(m_r[K], m_y[K], x[K] - m_x[K]);
+            });
+            m_x = x;
+            return m_y;
+        }
+
+    private:
+        elems_type m_r, m_x, m_y;
+};
+
+namespace detail {
+    // Frame type of the first of a sequence of filters.
+    template<typename...Fs>
+    using filter_frame_t = typename std::tuple_element_t<0, std::tuple<Fs...>>::frame_type;
+
+    template<typename...Fs>
+    concept filter_chain = sizeof...(Fs) > 0 and
+        []<typename F, typename...R>(std::type_identity<F>, std::type_identity<R>...) {
+            return (std::is_same_v<typename F::frame_type, typename R::frame_type> && ...);
+        }(std::type_identity<Fs>{}...);
+
+    template<typename X, typename...Fs>
+    FORCE_INLINE X run_filters(X x, Fs&...fs) {
+        ((x = fs.process_elems(x)), ...);
+        return x;
+    }
+}
+
+/**
+ * Run the filters fs, which share a frame type, in sequence over frames
+ * [0, frames) of an interleaved buffer: frame i is in[i * C], ...,
+ * in[i * C + C - 1] for C channels, with batch elements covering consecutive
+ * channels. out may be in.
+ */
+template<typename T, typename U, typename...Fs>
+    requires( detail::filter_chain<Fs...> )
+void filter_interleaved(const T* in, U* out, size_t frames, Fs&...fs) {
+    using traits = detail::frame_traits<detail::filter_frame_t<Fs...>>;
+    using E = typename traits::elem_type;
+    constexpr size_t D = traits::dim;
+    for (size_t i = 0; i < frames; ++i)
+        detail::store_frame(out, i, detail::run_filters(detail::load_frame<E, D>(in, i), fs...));
+}
+
+/**
+ * Run the filters fs in sequence over records [0, frames) of planar
+ * buffers: column sets with one column per channel. out may be in.
+ */
+template<soa_columns CIn, soa_columns COut, typename...Fs>
+    requires( detail::filter_chain<Fs...> )
+void filter_planar(const CIn& in, const COut& out, size_t frames, Fs&...fs) {
+    using traits = detail::frame_traits<detail::filter_frame_t<Fs...>>;
+    using E = typename traits::elem_type;
+    constexpr size_t D = traits::dim;
+    static_assert(tpa_tuple_size_v<CIn> == traits::channels and tpa_tuple_size_v<COut> == traits::channels,
+                  "filter_planar: one column per channel");
+    for (size_t i = 0; i < frames; ++i)
+        detail::scatter_frame(out, i, detail::run_filters(detail::gather_frame<E, D>(in, i), fs...));
+}
+
+}
@@ -0,0 +1,78 @@
+/**
+ * Bulk scatter-add: bins[idx[i]] += weights[i] for i in [0, n).
+ *
+ * bins can be
+ * - a pointer to scalars,
+ * - a column set (tuple of pointers, see soa.hpp) for tuple-valued SoA bins, or
+ * - a pointer to tuple-like records (AoS bins).
+ * weights is laid out the same way as bins, or is a single value added for
+ * every index. Duplicated indices are always accumulated correctly.
+ */
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    template<typename Wt>
+    FORCE_INLINE constexpr decltype(auto) weight_at(Wt&& w, size_t i) {
+        if constexpr (soa_columns<Wt>)
+            return load_record(w, i);
+        else if constexpr (std::is_pointer_v<std::remove_cvref_t<Wt>>)
+            return w[i];
+        else
+            return std::forward<Wt>(w);
+    }
+
+    template<typename simd_t, typename Wt>
+    FORCE_INLINE auto weight_batch(Wt&& w, size_t i) {
+        if constexpr (soa_columns<Wt>)
+            return load_columns<simd_t>(w, i);
+        else if constexpr (std::is_pointer_v<std::remove_cvref_t<Wt>>)
+            return simd_t::load_unaligned(w + i);
+        else
+            return simd_t(w);
+    }
+
+    // Weights that can be loaded as batches for the given bins.
+    template<typename Bins, typename Wt>
+    constexpr bool histogram_simd() {
+        if constexpr (column_pointer<Bins>)
+            return column_pointer<Wt> or std::is_arithmetic_v<std::remove_cvref_t<Wt>>;
+        else if constexpr (soa_columns<Bins>)
+            return same_type_tuple<Bins> and
+                ( std::is_arithmetic_v<std::remove_cvref_t<Wt>> or
+                  (soa_columns<Wt> and tpa_tuple_size_v<Wt> == tpa_tuple_size_v<Bins>) );
+        else
+            return false;
+    }
+}
+
+template<typename Bins, std::integral I, typename Wt>
+void histogram(Bins&& bins, const I* idx, Wt&& weights, size_t n) {
+    size_t i = 0;
+    if constexpr (detail::histogram_simd<Bins, Wt>()) {
+        using T = column_value_t<Bins>;
+        using simd_t = xsimd::batch<T>;
+        using ib_t = xsimd::batch<xsimd::as_integer_t<T>>;
+        constexpr size_t W = simd_t::size;
+        for (; i + W <= n; i += W)
+            scatter_add(bins, ib_t::load_unaligned(idx + i), detail::weight_batch<simd_t>(weights, i));
+    }
+    for (; i < n; ++i)
+        scatter_add(bins, idx[i], detail::weight_at(weights, i));
+}
+
+// Count occurrences: bins[idx[i]] += 1
+template<typename Bins, std::integral I>
+void histogram(Bins&& bins, const I* idx, size_t n) {
+    histogram(std::forward<Bins>(bins), idx, 1, n);
+}
+
+}
@@ -0,0 +1,204 @@
+/**
+ * Multilinear interpolation into regular grids.
+ *
+ * A grid_view<T, D, C> describes D-dimensional grid nodes holding C values
+ * each, stored consecutively at data + sum(i[k] * strides[k]). Coordinates
+ * are mapped to node indices as (x[k] - origin[k]) / step[k].
+ *
+ * Coordinates are scalars or xsimd batches of T (one point per lane);
+ * interp1 takes a single coordinate, interp2/interp3 a tuple of them.
+ * The result is a value (C == 1) or an std::array of C values, of the
+ * same kind as the coordinates.
+ */
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+
+#pragma once
+
+namespace tpa {
+
+// Handling of coordinates outside of the grid.
+enum class boundary {
+    clamp,  // use the nearest edge node
+    wrap,   // periodic grid: node shape[k] is node 0
+};
+
+template<typename T, size_t D, size_t C = 1>
+class grid_view {
+    static_assert(std::is_floating_point_v<T>, "grid_view: only floating point grids are supported");
+    public:
+        using value_type = T;
+        static constexpr size_t dim = D;
+        static constexpr size_t components = C;
+
+        // Densely packed grid, the first axis varies fastest.
+        grid_view(T* data, const std::array<size_t, D>& shape) : m_data(data), m_shape(shape) {
+            std::ptrdiff_t s = C;
+            for (size_t k = 0; k < D; ++k) {
+                m_strides[k] = s;
+                s *= std::ptrdiff_t(shape[k]);
+            }
+            m_origin.fill(T(0));
+            m_inv_step.fill(T(1));
+        }
+
+        // Strides in elements between neighbouring nodes along each axis.
+        grid_view(T* data, const std::array<size_t, D>& shape, const std::array<std::ptrdiff_t, D>& strides) :
+            m_data(data), m_shape(shape), m_strides(strides) {
+            m_origin.fill(T(0));
+            m_inv_step.fill(T(1));
+        }
+
+        // Node i along axis k is at coordinate origin[k] + i * step[k].
+        grid_view& set_axes(const std::array<T, D>& origin, const std::array<T, D>& step) {
+            m_origin = origin;
+            for (size_t k = 0; k < D; ++k)
+                m_inv_step[k] = T(1) / step[k];
+            return *this;
+        }
+
+        FORCE_INLINE T* data() const { return m_data; }
+        FORCE_INLINE const std::array<size_t, D>& shape() const { return m_shape; }
+        FORCE_INLINE const std::array<std::ptrdiff_t, D>& strides() const { return m_strides; }
+        FORCE_INLINE const std::array<T, D>& origin() const { return m_origin; }
+        FORCE_INLINE const std::array<T, D>& inv_step() const { return m_inv_step; }
+
+        // Values of the node at the given offset, for scalar or batched offsets.
+        FORCE_INLINE auto node(std::ptrdiff_t offset) const {
+            std::array<T, C> ret;
+            constexpr_for<0, C, 1>([&](auto I) { ret[I] = m_data[offset + I]; });
+            return ret;
+        }
+        template<typename I, typename A>
+        FORCE_INLINE auto node(const xsimd::batch<I, A>& offset) const {
+            using simd_t = xsimd::batch<T, A>;
+            std::array<simd_t, C> ret;
+            constexpr_for<0, C, 1>([&](auto J) { ret[J] = simd_t::gather(m_data + J, offset); });
+            return ret;
+        }
+
+    private:
+        T* m_data;
+        std::array<size_t, D> m_shape;
+        std::array<std::ptrdiff_t, D> m_strides;
+        std::array<T, D> m_origin;
+        std::array<T, D> m_inv_step;
+};
+
+template<size_t C = 1, typename T, size_t D>
+FORCE_INLINE auto make_grid_view(T* data, const std::array<size_t, D>& shape) {
+    return grid_view<T, D, C>(data, shape);
+}
+
+namespace detail {
+    template<typename U> struct interp_offset { using type = std::ptrdiff_t; };
+    template<typename T, typename A> struct interp_offset<xsimd::batch<T, A>> {
+        using type = xsimd::batch<xsimd::as_integer_t<T>, A>;
+    };
+
+    // Lower and upper node offsets along one axis, and the weight of the upper node.
+    template<typename U>
+    struct axis_cell {
+        typename interp_offset<U>::type lo, hi;
+        U t;
+    };
+
+    template<boundary B, typename U, typename T>
+    FORCE_INLINE axis_cell<U> locate(U u, size_t n, std::ptrdiff_t stride) {
+        using std::floor;
+        using std::min;
+        using std::max;
+        const T last = T(n - 1);
+        U i0, i1;
+        if constexpr (B == boundary::clamp) {
+            u = min(max(u, U(T(0))), U(last));
+            i0 = min(floor(u), U(n >= 2 ? T(n - 2) : T(0)));
+            i1 = min(i0 + U(T(1)), U(last));
+        }
+        else {
+            const T period = T(n);
+            u = u - U(period) * floor(u * U(T(1) / period));
+            i0 = min(floor(u), U(last));
+            if constexpr (std::is_arithmetic_v<U>)
+                i1 = i0 + 1 >= period ? T(0) : i0 + 1;
+            else
+                i1 = xsimd::select(i0 + U(T(1)) >= U(period), U(T(0)), i0 + U(T(1)));
+        }
+        axis_cell<U> ret;
+        ret.t = u - i0;
+        if constexpr (std::is_arithmetic_v<U>) {
+            ret.lo = std::ptrdiff_t(i0) * stride;
+            ret.hi = std::ptrdiff_t(i1) * stride;
+        }
+        else {
+            using ib_t = typename interp_offset<U>::type;
+            using int_t = typename ib_t::value_type;
+            ret.lo = xsimd::batch_cast<int_t>(i0) * ib_t(int_t(stride));
+            ret.hi = xsimd::batch_cast<int_t>(i1) * ib_t(int_t(stride));
+        }
+        return ret;
+    }
+
+    // Blend the 2^(D-K) corners below base, last axis innermost.
+    template<size_t K, typename Grid, typename U, typename Off>
+    FORCE_INLINE auto blend_corners(const Grid& grid, const std::array<axis_cell<U>, Grid::dim>& cells, const Off& base) {
+        if constexpr (K == Grid::dim)
+            return grid.node(base);
+        else {
+            auto a = blend_corners<K + 1>(grid, cells, base + cells[K].lo);
+            const auto b = blend_corners<K + 1>(grid, cells, base + cells[K].hi);
+            constexpr_for<0, Grid::components, 1>([&](auto J) {
+                a[J] = fma_elem(cells[K].t, b[J] - a[J], a[J]);
+            });
+            return a;
+        }
+    }
+
+    template<boundary B, typename Grid, typename Coords>
+    FORCE_INLINE auto interp(const Grid& grid, Coords&& x) {
+        using T = typename Grid::value_type;
+        using X0 = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Coords>>>;
+        using U = std::conditional_t<std::is_arithmetic_v<X0>, T, X0>;
+        constexpr size_t D = Grid::dim;
+        static_assert(std::tuple_size_v<std::remove_cvref_t<Coords>> == D, "interp: coordinate count must match the grid dimension");
+        static_assert(std::is_same_v<max_type_t<U>, T>,
+                "interp: batched coordinates must have the value type of the grid");
+        std::array<axis_cell<U>, D> cells;
+        constexpr_for<0, D, 1>([&](auto K) {
+            const U u = (U(get<K>(x)) - U(grid.origin()[K])) * U(grid.inv_step()[K]);
+            cells[K] = locate<B, U, T>(u, grid.shape()[K], grid.strides()[K]);
+        });
+        auto ret = blend_corners<0>(grid, cells, typename interp_offset<U>::type(0));
+        if constexpr (Grid::components == 1)
+            return ret[0];
+        else
+            return ret;
+    }
+}
+
+template<boundary B = boundary::clamp, typename T, size_t C, typename X>
+FORCE_INLINE auto interp1(const grid_view<T, 1, C>& grid, X&& x) {
+    if constexpr (tuple_like<X>)
+        return detail::interp<B>(grid, std::forward<X>(x));
+    else
+        return detail::interp<B>(grid, std::forward_as_tuple(x));
+}
+
+// (x, y) -> bilinear interpolation; x and y are scalars or batches.
+template<boundary B = boundary::clamp, typename T, size_t C, tuple_like X>
+FORCE_INLINE auto interp2(const grid_view<T, 2, C>& grid, X&& xy) {
+    return detail::interp<B>(grid, std::forward<X>(xy));
+}
+
+// (x, y, z) -> trilinear interpolation; x, y and z are scalars or batches.
+template<boundary B = boundary::clamp, typename T, size_t C, tuple_like X>
+FORCE_INLINE auto interp3(const grid_view<T, 3, C>& grid, X&& xyz) {
+    return detail::interp<B>(grid, std::forward<X>(xyz));
+}
+
+}
@@ -0,0 +1,213 @@
+/**
+ * Ray/box and ray/triangle intersection.
+ *
+ * ray_box and ray_triangle take tuple-like vectors whose elements are scalars
+ * or batches; the arguments that are batches hold one ray or one object per
+ * lane, the others are broadcast. So W rays can be tested against one object,
+ * or one ray against W objects, with the same code, and the result holds a hit
+ * mask and distances per lane.
+ *
+ * The bulk kernels test one ray against n objects, or n rays against one
+ * object, stored as column sets (see soa.hpp), a batch at a time. They write
+ * the hit distance of each pair, or +inf for a miss, and return the number of
+ * hits.
+ */
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+#include "neighbors.hpp"
+
+#pragma once
+
+namespace tpa {
+
+// Hit flags: bool for scalars, a batch_bool for batches.
+template<typename U>
+using hit_mask_t = detail::lane_mask_t<U>;
+
+// The ray enters the box at t_near and leaves it at t_far.
+template<typename U>
+struct box_hit {
+    hit_mask_t<U> hit;
+    U t_near, t_far;
+};
+
+// The hit point is origin + t dir = (1 - u - v) v0 + u v1 + v v2.
+template<typename U>
+struct triangle_hit {
+    hit_mask_t<U> hit;
+    U t, u, v;
+};
+
+namespace detail {
+    // Minimum number of objects or rays per chunk in threaded kernels.
+    inline constexpr size_t intersect_grain = size_t(1) << 10;
+
+    // Scalar or batch type of a set of tuple-like vectors.
+    template<typename...V>
+    using lane_value_t = std::remove_cvref_t<final_type_t<std::remove_cvref_t<tuple_max_type_t<V>>...>>;
+
+    template<typename U>
+    FORCE_INLINE size_t count_hits(const hit_mask_t<U>& hit) {
+        if constexpr (std::is_arithmetic_v<U>)
+            return hit ? 1 : 0;
+        else
+            return size_t(std::popcount(uint64_t(hit.mask())));
+    }
+
+    /**
+     * t[i] = distance of hit i, or +inf, for i in [0, n), where fn(U{}, i)
+     * returns (hit, t) for element i as a scalar, or elements i, i + 1, ...
+     * as a batch. Returns the number of hits.
+     */
+    template<typename T, typename Fn>
+    size_t intersect_range(size_t n, unsigned threads, T* t, Fn&& fn) {
+        std::vector<size_t> hits(chunk_count(n, threads, intersect_grain), 0);
+        parallel_chunks(n, threads, [&](size_t c, size_t begin, size_t end) {
+            const T inf = std::numeric_limits<T>::infinity();
+            size_t i = begin, count = 0;
+            if constexpr (simd_scalar<T>) {
+                using simd_t = xsimd::batch<T>;
+                constexpr size_t W = simd_t::size;
+                for (; i + W <= end; i += W) {
+                    const auto [hit, d] = fn(simd_t{}, i);
+                    xsimd::select(hit, d, simd_t(inf)).store_unaligned(t + i);
+                    count += count_hits<simd_t>(hit);
+                }
+            }
+            for (; i < end; ++i) {
+                const auto [hit, d] = fn(T{}, i);
+                t[i] = hit ? d : inf;
+                count += hit ? 1 : 0;
+            }
+            hits[c] = count;
+        }, intersect_grain);
+        size_t total = 0;
+        for (size_t h : hits)
+            total += h;
+        return total;
+    }
+}
+
+/**
+ * Slab test of the ray origin + t dir, t in [t_min, t_max], against the box
+ * [lo, hi], in any dimension. inv_dir is 1 / dir, with infinite components for
+ * rays parallel to an axis; a parallel ray lying exactly on a slab plane may
+ * count as a miss.
+ */
+template<tuple_like O, tuple_like I, tuple_like Lo, tuple_like Hi,
+         typename U = detail::lane_value_t<O, I, Lo, Hi>>
+    requires( tpa_tuple_size_v<O> == tpa_tuple_size_v<I> and tpa_tuple_size_v<O> == tpa_tuple_size_v<Lo> and
+              tpa_tuple_size_v<O> == tpa_tuple_size_v<Hi> )
+FORCE_INLINE box_hit<U> ray_box(const O& origin, const I& inv_dir, const Lo& lo, const Hi& hi,
+        const U& t_min = U(0), const U& t_max = U(std::numeric_limits<max_type_t<U>>::infinity())) {
+    using std::min;
+    using std::max;
+    constexpr size_t D = tpa_tuple_size_v<O>;
+    const auto o = detail::to_elems<U>(origin);
+    const auto r = detail::to_elems<U>(inv_dir);
+    const auto a = detail::to_elems<U>(lo);
+    const auto b = detail::to_elems<U>(hi);
+    U t0 = t_min, t1 = t_max;
+    constexpr_for<0, D, 1>([&](auto K) {
+        const U ta = (a[K] - o[K]) * r[K];
+        const U tb = (b[K] - o[K]) * r[K];
+        t0 = max(t0, min(ta, tb));
+        t1 = min(t1, max(ta, tb));
+    });
+    return box_hit<U>{t0 <= t1, t0, t1};
+}
+
+/**
+ * Möller-Trumbore test of the ray origin + t dir, t in [t_min, t_max], against
+ * the triangle (v0, v1, v2), from either side. Degenerate triangles and rays
+ * parallel to the triangle's plane miss.
+ */
+template<tuple_like O, tuple_like Dir, tuple_like V0, tuple_like V1, tuple_like V2,
+         typename U = detail::lane_value_t<O, Dir, V0, V1, V2>>
+    requires( tpa_tuple_size_v<O> == 3 and tpa_tuple_size_v<Dir> == 3 and tpa_tuple_size_v<V0> == 3 and
+              tpa_tuple_size_v<V1> == 3 and tpa_tuple_size_v<V2> == 3 )
+FORCE_INLINE triangle_hit<U> ray_triangle(const O& origin, const Dir& dir, const V0& v0, const V1& v1, const V2& v2,
+        const U& t_min = U(0), const U& t_max = U(std::numeric_limits<max_type_t<U>>::infinity())) {
+    using T = max_type_t<U>;
+    const auto o = detail::to_elems<U>(origin);
+    const auto d = detail::to_elems<U>(dir);
+    const auto p0 = detail::to_elems<U>(v0);
+    const auto e1 = detail::to_elems<U>(v1) - p0;
+    const auto e2 = detail::to_elems<U>(v2) - p0;
+    const auto p = cross(d, e2);
+    const U det = dot(e1, p);
+    const U inv = U(T(1)) / det;
+    const auto s = o - p0;
+    const U u = dot(s, p) * inv;
+    const auto q = cross(s, e1);
+    const U v = dot(d, q) * inv;
+    const U t = dot(e2, q) * inv;
+    const hit_mask_t<U> hit = (det != U(T(0))) & (u >= U(T(0))) & (v >= U(T(0))) & (u + v <= U(T(1))) &
+        (t >= t_min) & (t <= t_max);
+    return triangle_hit<U>{hit, t, u, v};
+}
+
+// t[i] = entry distance of the ray into box i, [lo[i], hi[i]], or +inf.
+template<tuple_like O, tuple_like I, soa_columns Lo, soa_columns Hi, typename T>
+    requires( not soa_columns<O> and detail::point_sets<Lo, Hi> )
+size_t intersect_boxes(const O& origin, const I& inv_dir, const Lo& lo, const Hi& hi, size_t n, T* t, unsigned threads = 1) {
+    static_assert(std::is_floating_point_v<T>, "intersect_boxes: distances must be floating point");
+    const auto o = detail::to_elems<T>(origin);
+    const auto r = detail::to_elems<T>(inv_dir);
+    return detail::intersect_range(n, threads, t, [&]<typename U>(U, size_t i) {
+        const auto h = ray_box(o, r, detail::load_point<U>(lo, i), detail::load_point<U>(hi, i));
+        return std::pair{h.hit, h.t_near};
+    });
+}
+
+// t[i] = distance along ray i, (origin[i], inv_dir[i]), into the box [lo, hi], or +inf.
+template<soa_columns O, soa_columns I, tuple_like Lo, tuple_like Hi, typename T>
+    requires( detail::point_sets<O, I> and not soa_columns<Lo> )
+size_t intersect_rays_box(const O& origin, const I& inv_dir, size_t n, const Lo& lo, const Hi& hi, T* t, unsigned threads = 1) {
+    static_assert(std::is_floating_point_v<T>, "intersect_rays_box: distances must be floating point");
+    const auto a = detail::to_elems<T>(lo);
+    const auto b = detail::to_elems<T>(hi);
+    return detail::intersect_range(n, threads, t, [&]<typename U>(U, size_t i) {
+        const auto h = ray_box(detail::load_point<U>(origin, i), detail::load_point<U>(inv_dir, i), a, b);
+        return std::pair{h.hit, h.t_near};
+    });
+}
+
+// t[i] = distance along the ray to triangle i, (v0[i], v1[i], v2[i]), or +inf.
+template<tuple_like O, tuple_like Dir, soa_columns V0, soa_columns V1, soa_columns V2, typename T>
+    requires( not soa_columns<O> and detail::point_sets<V0, V1> and detail::point_sets<V0, V2> )
+size_t intersect_triangles(const O& origin, const Dir& dir, const V0& v0, const V1& v1, const V2& v2, size_t n, T* t, unsigned threads = 1) {
+    static_assert(std::is_floating_point_v<T>, "intersect_triangles: distances must be floating point");
+    const auto o = detail::to_elems<T>(origin);
+    const auto d = detail::to_elems<T>(dir);
+    return detail::intersect_range(n, threads, t, [&]<typename U>(U, size_t i) {
+        const auto h = ray_triangle(o, d, detail::load_point<U>(v0, i), detail::load_point<U>(v1, i), detail::load_point<U>(v2, i));
+        return std::pair{h.hit, h.t};
+    });
+}
+
+// t[i] = distance along ray i, (origin[i], dir[i]), to the triangle (v0, v1, v2), or +inf.
+template<soa_columns O, soa_columns Dir, tuple_like V0, tuple_like V1, tuple_like V2, typename T>
+    requires( detail::point_sets<O, Dir> and not soa_columns<V0> )
+size_t intersect_rays_triangle(const O& origin, const Dir& dir, size_t n, const V0& v0, const V1& v1, const V2& v2, T* t, unsigned threads = 1) {
+    static_assert(std::is_floating_point_v<T>, "intersect_rays_triangle: distances must be floating point");
+    const auto p0 = detail::to_elems<T>(v0);
+    const auto p1 = detail::to_elems<T>(v1);
+    const auto p2 = detail::to_elems<T>(v2);
+    return detail::intersect_range(n, threads, t, [&]<typename U>(U, size_t i) {
+        const auto h = ray_triangle(detail::load_point<U>(origin, i), detail::load_point<U>(dir, i), p0, p1, p2);
+        return std::pair{h.hit, h.t};
+    });
+}
+
+}
@@ -0,0 +1,275 @@
+/**
+ * k-d tree over tuple-like points, for radius, k-nearest-neighbor and box
+ * queries in any dimension (the tuple size of the point type).
+ *
+ * The tree is built by median splits along the widest axis of each node's
+ * bounding box, so it is balanced, and its nodes are stored depth-first in one
+ * array: the left child follows its parent, and subtrees occupy contiguous
+ * ranges, which lets the build fill them from several threads. Points are
+ * copied into columns in leaf order, so a leaf is a contiguous range of every
+ * column and is tested a batch of points at a time.
+ */
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+#include "neighbors.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Minimum number of points in a subtree built on its own thread.
+    inline constexpr size_t kd_tree_grain = size_t(1) << 12;
+
+    template<typename T>
+    using kd_value_t = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+    // Indices of the set lanes of a batch_bool, lowest first.
+    template<typename B, typename Fn>
+    FORCE_INLINE void for_each_lane(const B& mask, Fn&& fn) {
+        for (uint64_t m = uint64_t(mask.mask()); m != 0; m &= m - 1)
+            fn(size_t(std::countr_zero(m)));
+    }
+}
+
+template<tuple_like Point>
+class kd_tree {
+    public:
+        static constexpr size_t dim = tpa_tuple_size_v<Point>;
+        // Coordinates are stored in the common type of the point, or double for integer points.
+        using value_type = detail::kd_value_t<tuple_common_t<Point>>;
+        using point_type = std::array<value_type, dim>;
+
+        kd_tree() = default;
+
+        // Index points[0..n). Leaves hold at most leaf_size points.
+        kd_tree(const Point* points, size_t n, size_t leaf_size = 16, unsigned threads = 1) :
+            m_size(n), m_leaf_size(std::max<size_t>(leaf_size, 1)) {
+            if (n == 0)
+                return;
+            std::vector<entry> entries(n);
+            for (size_t i = 0; i < n; ++i)
+                entries[i] = entry{detail::to_elems<value_type>(points[i]), i};
+            m_nodes.resize(node_count(n));
+            build(0, 0, n, entries, thread_count(threads));
+            m_index.resize(n);
+            for (size_t k = 0; k < dim; ++k)
+                m_columns[k].resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                m_index[i] = entries[i].id;
+                for (size_t k = 0; k < dim; ++k)
+                    m_columns[k][i] = entries[i].p[k];
+            }
+        }
+
+        size_t size() const { return m_size; }
+        size_t node_count() const { return m_nodes.size(); }
+
+        // Append the indices of the points within distance r of center to out.
+        // Returns the number of indices appended; their order is unspecified.
+        template<tuple_like Q>
+        size_t radius_query(const Q& center, value_type r, std::vector<size_t>& out) const {
+            static_assert(tpa_tuple_size_v<Q> == dim, "kd_tree: query dimension mismatch");
+            const size_t count = out.size();
+            const auto x = detail::to_elems<value_type>(center);
+            const value_type r2 = r * r;
+            const auto cols = columns();
+            traverse([&](const node& nd) { return box_distance(nd, x) <= r2; }, [&](const node& nd) {
+                size_t j = nd.begin;
+                if constexpr (simd_scalar<value_type>) {
+                    using simd_t = xsimd::batch<value_type>;
+                    constexpr size_t W = simd_t::size;
+                    const auto xb = detail::broadcast_point<simd_t>(x);
+                    const simd_t rb(r2);
+                    for (; j + W <= nd.end; j += W)
+                        detail::for_each_lane(detail::lp_sum<2>(xb, detail::load_point<simd_t>(cols, j)) <= rb,
+                                [&](size_t l) { out.push_back(m_index[j + l]); });
+                }
+                for (; j < nd.end; ++j)
+                    if (detail::lp_sum<2>(x, detail::load_point<value_type>(cols, j)) <= r2)
+                        out.push_back(m_index[j]);
+            });
+            return out.size() - count;
+        }
+
+        // Append the indices of the points in the closed box [lo, hi] to out.
+        // Returns the number of indices appended; their order is unspecified.
+        template<tuple_like Lo, tuple_like Hi>
+        size_t box_query(const Lo& lo, const Hi& hi, std::vector<size_t>& out) const {
+            static_assert(tpa_tuple_size_v<Lo> == dim and tpa_tuple_size_v<Hi> == dim, "kd_tree: box dimension mismatch");
+            const size_t count = out.size();
+            const auto a = detail::to_elems<value_type>(lo);
+            const auto b = detail::to_elems<value_type>(hi);
+            const auto cols = columns();
+            traverse([&](const node& nd) {
+                for (size_t k = 0; k < dim; ++k)
+                    if (nd.hi[k] < a[k] or nd.lo[k] > b[k])
+                        return false;
+                return true;
+            }, [&](const node& nd) {
+                size_t j = nd.begin;
+                if constexpr (simd_scalar<value_type>) {
+                    using simd_t = xsimd::batch<value_type>;
+                    constexpr size_t W = simd_t::size;
+                    const auto ab = detail::broadcast_point<simd_t>(a);
+                    const auto bb = detail::broadcast_point<simd_t>(b);
+                    for (; j + W <= nd.end; j += W) {
+                        const auto p = detail::load_point<simd_t>(cols, j);
+                        auto inside = (p[0] >= ab[0]) & (p[0] <= bb[0]);
+                        constexpr_for<1, dim, 1>([&](auto K) { inside = inside & (p[K] >= ab[K]) & (p[K] <= bb[K]); });
+                        detail::for_each_lane(inside, [&](size_t l) { out.push_back(m_index[j + l]); });
+                    }
+                }
+                for (; j < nd.end; ++j) {
+                    const auto p = detail::load_point<value_type>(cols, j);
+                    bool inside = true;
+                    for (size_t k = 0; k < dim; ++k)
+                        inside = inside and p[k] >= a[k] and p[k] <= b[k];
+                    if (inside)
+                        out.push_back(m_index[j]);
+                }
+            });
+            return out.size() - count;
+        }
+
+        /**
+         * The k points nearest to query (Euclidean distance), sorted by distance,
+         * as in tpa::knn. Ties are broken arbitrarily. Returns the number of
+         * neighbors found; the slots after it get index size() and an infinite distance.
+         */
+        template<tuple_like Q>
+        size_t knn(const Q& query, size_t k, size_t* idx, value_type* dist) const {
+            static_assert(tpa_tuple_size_v<Q> == dim, "kd_tree: query dimension mismatch");
+            if (k == 0)
+                return 0;
+            const auto x = detail::to_elems<value_type>(query);
+            const auto cols = columns();
+            detail::knn_list<value_type> list{dist, idx, k};
+            traverse([&](const node& nd) { return not list.full() or box_distance(nd, x) < dist[k - 1]; },
+                     [&](const node& nd) { detail::knn_scan<2>(x, cols, nd.begin, nd.end, list); },
+                     [&](const node& a, const node& b) { return box_distance(a, x) <= box_distance(b, x); });
+            const size_t found = list.template finish<2, true>(m_size);
+            for (size_t p = 0; p < found; ++p)
+                idx[p] = m_index[idx[p]];
+            return found;
+        }
+
+    private:
+        struct node {
+            point_type lo, hi;  // bounding box of the points
+            size_t begin, end;  // range of the points in the columns
+            size_t right;       // index of the right child, 0 for leaves
+        };
+
+        struct entry {
+            point_type p;
+            size_t id;
+        };
+
+        size_t m_size = 0;
+        size_t m_leaf_size = 16;
+        std::vector<node> m_nodes;
+        std::array<std::vector<value_type>, dim> m_columns;
+        std::vector<size_t> m_index;
+
+        std::array<const value_type*, dim> columns() const {
+            std::array<const value_type*, dim> ret;
+            for (size_t k = 0; k < dim; ++k)
+                ret[k] = m_columns[k].data();
+            return ret;
+        }
+
+        // Number of nodes of the subtree holding n points.
+        size_t node_count(size_t n) const {
+            return n <= m_leaf_size ? 1 : 1 + node_count(n / 2) + node_count(n - n / 2);
+        }
+
+        void build(size_t id, size_t begin, size_t end, std::vector<entry>& entries, unsigned threads) {
+            node& nd = m_nodes[id];
+            nd.begin = begin;
+            nd.end = end;
+            nd.lo = entries[begin].p;
+            nd.hi = entries[begin].p;
+            for (size_t i = begin + 1; i < end; ++i) {
+                nd.lo = min(nd.lo, entries[i].p);
+                nd.hi = max(nd.hi, entries[i].p);
+            }
+            if (end - begin <= m_leaf_size) {
+                nd.right = 0;
+                return;
+            }
+            const size_t axis = argmax(nd.hi - nd.lo);
+            const size_t mid = begin + (end - begin) / 2;
+            std::nth_element(entries.begin() + begin, entries.begin() + mid, entries.begin() + end,
+                    [axis](const entry& a, const entry& b) { return a.p[axis] < b.p[axis]; });
+            nd.right = id + 1 + node_count(mid - begin);
+            if (threads > 1 and end - begin >= 2 * detail::kd_tree_grain) {
+                std::thread worker([&, threads, right = nd.right]() { build(right, mid, end, entries, threads / 2); });
+                build(id + 1, begin, mid, entries, threads - threads / 2);
+                worker.join();
+            }
+            else {
+                build(id + 1, begin, mid, entries, 1);
+                build(nd.right, mid, end, entries, 1);
+            }
+        }
+
+        // Squared distance from x to the bounding box of a node.
+        static value_type box_distance(const node& nd, const point_type& x) {
+            value_type acc = 0;
+            for (size_t k = 0; k < dim; ++k) {
+                const value_type d = std::max({nd.lo[k] - x[k], x[k] - nd.hi[k], value_type(0)});
+                acc += d * d;
+            }
+            return acc;
+        }
+
+        // Depth-first traversal: visit(leaf) for the leaves of the nodes that pass
+        // enter(node), entering the child preferred by first(left, right) first.
+        template<typename Enter, typename Visit, typename First>
+        void traverse(Enter&& enter, Visit&& visit, First&& first) const {
+            if (m_nodes.empty())
+                return;
+            // Balanced tree: the depth is below the number of bits of size_t.
+            std::array<size_t, 2 * std::numeric_limits<size_t>::digits> stack;
+            size_t top = 0;
+            stack[top++] = 0;
+            while (top > 0) {
+                const node& nd = m_nodes[stack[--top]];
+                if (not enter(nd))
+                    continue;
+                if (nd.right == 0) {
+                    visit(nd);
+                    continue;
+                }
+                const size_t left = &nd - m_nodes.data() + 1;
+                if (first(m_nodes[left], m_nodes[nd.right])) {
+                    stack[top++] = nd.right;
+                    stack[top++] = left;
+                }
+                else {
+                    stack[top++] = left;
+                    stack[top++] = nd.right;
+                }
+            }
+        }
+
+        template<typename Enter, typename Visit>
+        void traverse(Enter&& enter, Visit&& visit) const {
+            traverse(std::forward<Enter>(enter), std::forward<Visit>(visit), [](const node&, const node&) { return true; });
+        }
+};
+
+}
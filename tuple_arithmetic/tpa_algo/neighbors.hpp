@@ -0,0 +1,283 @@
+/**
+ * Brute-force pairwise distances and k-nearest-neighbor queries over point
+ * sets stored as column sets (see soa.hpp).
+ *
+ * Distances are Minkowski distances as in norm<L> of tuple_math.hpp:
+ * (sum |a_k - b_k|^L)^(1/L), or the sum without the root when Root is false,
+ * e.g. the squared Euclidean distance for L == 2. Computation is done in the
+ * value type of the output, which must be floating point.
+ *
+ * Both kernels are tiled: a tile of points is swept by a block of rows or
+ * queries while it is in cache, and a batch of points is loaded once for
+ * several rows.
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Points per cache tile, rows per register block, and queries per block in knn.
+    inline constexpr size_t distance_tile = size_t(1) << 10;
+    inline constexpr size_t distance_rows = 4;
+    inline constexpr size_t knn_queries = 16;
+
+    // acc + |d|^L
+    template<size_t L, typename U>
+    FORCE_INLINE U lp_accumulate(const U& acc, const U& d) {
+        if constexpr (L == 2)
+            return fma_elem(d, d, acc);
+        else {
+            using std::abs;
+            const U a = abs(d);
+            U p = a;
+            constexpr_for<1, L, 1>([&](auto) { p = p * a; });
+            return acc + p;
+        }
+    }
+
+    // s^(1/L)
+    template<size_t L, typename U>
+    FORCE_INLINE U lp_root(const U& s) {
+        using T = max_type_t<U>;
+        if constexpr (L == 1)
+            return s;
+        else if constexpr (L == 2) {
+            using std::sqrt;
+            return sqrt(s);
+        }
+        else if constexpr (L == 3) {
+            using std::cbrt;
+            return cbrt(s);
+        }
+        else {
+            using std::pow;
+            return pow(s, U(T(1) / T(L)));
+        }
+    }
+
+    // Point j of a column set, as scalars or as the batch of points j, j + 1, ...
+    template<typename U, typename Cols>
+    FORCE_INLINE auto load_point(const Cols& cols, size_t j) {
+        constexpr size_t D = tpa_tuple_size_v<Cols>;
+        std::array<U, D> ret;
+        constexpr_for<0, D, 1>([&](auto K) {
+            if constexpr (std::is_arithmetic_v<U>)
+                ret[K] = U(get<K>(cols)[j]);
+            else
+                ret[K] = U::load_unaligned(get<K>(cols) + j);
+        });
+        return ret;
+    }
+
+    template<typename U, typename T, size_t D>
+    FORCE_INLINE std::array<U, D> broadcast_point(const std::array<T, D>& p) {
+        std::array<U, D> ret;
+        constexpr_for<0, D, 1>([&](auto K) { ret[K] = U(p[K]); });
+        return ret;
+    }
+
+    template<size_t L, typename U, size_t D>
+    FORCE_INLINE U lp_sum(const std::array<U, D>& a, const std::array<U, D>& b) {
+        U acc = lp_accumulate<L>(U(0), a[0] - b[0]);
+        constexpr_for<1, D, 1>([&](auto K) { acc = lp_accumulate<L>(acc, a[K] - b[K]); });
+        return acc;
+    }
+
+    template<size_t L, bool Root, typename U>
+    FORCE_INLINE U lp_finish(const U& s) {
+        if constexpr (Root)
+            return lp_root<L>(s);
+        else
+            return s;
+    }
+
+    // out[(i + r) * ld + j] = dist(a[i + r], b[j]) for r < R and j in [jb, je).
+    template<size_t L, bool Root, size_t R, typename T, typename ColsA, typename ColsB>
+    FORCE_INLINE void distance_block(const ColsA& a, size_t i, const ColsB& b, size_t jb, size_t je, T* out, size_t ld) {
+        std::array<decltype(load_point<T>(a, 0)), R> x;
+        constexpr_for<0, R, 1>([&](auto r) { x[r] = load_point<T>(a, i + r); });
+        size_t j = jb;
+        if constexpr (simd_scalar<T>) {
+            using simd_t = xsimd::batch<T>;
+            constexpr size_t W = simd_t::size;
+            std::array<decltype(broadcast_point<simd_t>(x[0])), R> xb;
+            constexpr_for<0, R, 1>([&](auto r) { xb[r] = broadcast_point<simd_t>(x[r]); });
+            for (; j + W <= je; j += W) {
+                const auto y = load_point<simd_t>(b, j);
+                constexpr_for<0, R, 1>([&](auto r) {
+                    lp_finish<L, Root>(lp_sum<L>(xb[r], y)).store_unaligned(out + (i + r) * ld + j);
+                });
+            }
+        }
+        for (; j < je; ++j) {
+            const auto y = load_point<T>(b, j);
+            constexpr_for<0, R, 1>([&](auto r) {
+                out[(i + r) * ld + j] = lp_finish<L, Root>(lp_sum<L>(x[r], y));
+            });
+        }
+    }
+
+    // The k smallest distances seen so far, sorted, written in place to dist and idx.
+    // Ties keep the point seen first; NaN distances are never accepted.
+    template<typename T>
+    struct knn_list {
+        T* dist;
+        size_t* idx;
+        size_t k;
+        size_t size = 0;
+
+        bool full() const { return size == k; }
+
+        bool accepts(T d) const { return full() ? d < dist[k - 1] : d == d; }
+
+        void insert(T d, size_t i) {
+            size_t p = full() ? k - 1 : size++;
+            for (; p > 0 and d < dist[p - 1]; --p) {
+                dist[p] = dist[p - 1];
+                idx[p] = idx[p - 1];
+            }
+            dist[p] = d;
+            idx[p] = i;
+        }
+
+        // Root the distances and mark the unused slots with index n.
+        template<size_t L, bool Root>
+        size_t finish(size_t n) {
+            for (size_t p = 0; p < size; ++p)
+                dist[p] = lp_finish<L, Root>(dist[p]);
+            for (size_t p = size; p < k; ++p) {
+                dist[p] = std::numeric_limits<T>::infinity();
+                idx[p] = n;
+            }
+            return size;
+        }
+    };
+
+    // Offer points [jb, je) to the list of the query x. Batches are compared
+    // against the current k-th distance first, and only the lanes that pass it
+    // are inserted, so most batches cost a single compare.
+    template<size_t L, typename T, size_t D, typename Cols>
+    FORCE_INLINE void knn_scan(const std::array<T, D>& x, const Cols& points, size_t jb, size_t je, knn_list<T>& list) {
+        size_t j = jb;
+        if constexpr (simd_scalar<T>) {
+            using simd_t = xsimd::batch<T>;
+            constexpr size_t W = simd_t::size;
+            const auto xb = broadcast_point<simd_t>(x);
+            for (; j + W <= je; j += W) {
+                const simd_t s = lp_sum<L>(xb, load_point<simd_t>(points, j));
+                const auto pass = list.full() ? s < simd_t(list.dist[list.k - 1]) : s == s;
+                if (xsimd::none(pass))
+                    continue;
+                alignas(simd_t::arch_type::alignment()) std::array<T, W> d;
+                s.store_aligned(d.data());
+                for (size_t l = 0; l < W; ++l)
+                    if (list.accepts(d[l]))
+                        list.insert(d[l], j + l);
+            }
+        }
+        for (; j < je; ++j) {
+            const T s = lp_sum<L>(x, load_point<T>(points, j));
+            if (list.accepts(s))
+                list.insert(s, j);
+        }
+    }
+
+    // Queries [q0, q1) against all points, one cache tile of points at a time.
+    template<size_t L, bool Root, typename T, typename Queries, typename Points>
+    void knn_range(const Queries& queries, size_t q0, size_t q1, const Points& points, size_t n, size_t k, size_t* idx, T* dist) {
+        constexpr size_t D = tpa_tuple_size_v<Points>;
+        for (size_t qb = q0; qb < q1; qb += knn_queries) {
+            const size_t qe = std::min(q1, qb + knn_queries);
+            std::array<std::array<T, D>, knn_queries> x;
+            std::array<knn_list<T>, knn_queries> lists;
+            for (size_t q = qb; q < qe; ++q) {
+                x[q - qb] = load_point<T>(queries, q);
+                lists[q - qb] = knn_list<T>{dist + q * k, idx + q * k, k};
+            }
+            for (size_t jb = 0; jb < n; jb += distance_tile) {
+                const size_t je = std::min(n, jb + distance_tile);
+                for (size_t q = qb; q < qe; ++q)
+                    knn_scan<L>(x[q - qb], points, jb, je, lists[q - qb]);
+            }
+            for (size_t q = qb; q < qe; ++q)
+                lists[q - qb].template finish<L, Root>(n);
+        }
+    }
+
+    template<typename A, typename B>
+    concept point_sets = soa_columns<A> and soa_columns<B> and tpa_tuple_size_v<A> == tpa_tuple_size_v<B>;
+}
+
+/**
+ * out[i * nb + j] = distance(a[i], b[j]) for i < na, j < nb: the L-norm of
+ * a[i] - b[j], or its L-th power if not Root. Rows of a are split across threads.
+ */
+template<size_t L = 2, bool Root = true, soa_columns A, soa_columns B, typename T>
+    requires( detail::point_sets<A, B> )
+void pairwise_distances(const A& a, size_t na, const B& b, size_t nb, T* out, unsigned threads = 1) {
+    static_assert(L >= 1, "pairwise_distances: L must be at least 1");
+    static_assert(std::is_floating_point_v<T>, "pairwise_distances: output must be floating point");
+    constexpr size_t R = detail::distance_rows;
+    const size_t grain = std::max<size_t>(R, detail::distance_tile / std::max<size_t>(nb, 1));
+    parallel_chunks(na, threads, [&](size_t, size_t begin, size_t end) {
+        for (size_t jb = 0; jb < nb; jb += detail::distance_tile) {
+            const size_t je = std::min(nb, jb + detail::distance_tile);
+            size_t i = begin;
+            for (; i + R <= end; i += R)
+                detail::distance_block<L, Root, R>(a, i, b, jb, je, out, nb);
+            for (; i < end; ++i)
+                detail::distance_block<L, Root, 1>(a, i, b, jb, je, out, nb);
+        }
+    }, grain);
+}
+
+/**
+ * The k points nearest to query, sorted by distance: idx[0..k) and dist[0..k).
+ * Ties are broken by the lower index and points at a NaN distance are skipped.
+ * Returns the number of neighbors found, min(k, n) for finite data; the slots
+ * after it get index n and an infinite distance.
+ */
+template<size_t L = 2, bool Root = true, tuple_like Q, soa_columns P, typename T>
+    requires( not soa_columns<Q> and tpa_tuple_size_v<Q> == tpa_tuple_size_v<P> )
+size_t knn(const Q& query, const P& points, size_t n, size_t k, size_t* idx, T* dist) {
+    static_assert(L >= 1, "knn: L must be at least 1");
+    static_assert(std::is_floating_point_v<T>, "knn: distances must be floating point");
+    if (k == 0)
+        return 0;
+    detail::knn_list<T> list{dist, idx, k};
+    const auto x = detail::to_elems<T>(query);
+    for (size_t jb = 0; jb < n; jb += detail::distance_tile)
+        detail::knn_scan<L>(x, points, jb, std::min(n, jb + detail::distance_tile), list);
+    return list.template finish<L, Root>(n);
+}
+
+/**
+ * knn for every query: the neighbors of queries[q] go to idx[q * k ..] and
+ * dist[q * k ..]. Queries are split across threads.
+ */
+template<size_t L = 2, bool Root = true, soa_columns Q, soa_columns P, typename T>
+    requires( detail::point_sets<Q, P> )
+void knn(const Q& queries, size_t nq, const P& points, size_t n, size_t k, size_t* idx, T* dist, unsigned threads = 1) {
+    static_assert(L >= 1, "knn: L must be at least 1");
+    static_assert(std::is_floating_point_v<T>, "knn: distances must be floating point");
+    if (k == 0)
+        return;
+    const size_t grain = std::max<size_t>(1, detail::distance_tile / std::max<size_t>(n, 1));
+    parallel_chunks(nq, threads, [&](size_t, size_t begin, size_t end) {
+        detail::knn_range<L, Root>(queries, begin, end, points, n, k, idx, dist);
+    }, grain);
+}
+
+}
@@ -0,0 +1,262 @@
+/**
+ * Explicit integrators for y' = f(t, y) and x'' = a(x), where the state is a
+ * tuple-like object.
+ *
+ * State elements are scalars, or batches for a lane-packed set of independent
+ * systems, one per lane: time, step size and error are then batches too, and
+ * the adaptive integrator accepts, rejects and resizes steps lane by lane with
+ * selects. Stages are accumulated element by element with fma, so steps build
+ * no intermediate tuples.
+ */
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    template<typename S>
+    using state_t = std::remove_cvref_t<S>;
+
+    // Scalar or batch type of the elements of a state.
+    template<typename S>
+    using state_value_t = std::remove_cvref_t<tuple_max_type_t<state_t<S>>>;
+
+    // c[0] get<I>(k[0]) + c[1] get<I>(k[1]) + ..., skipping zero coefficients.
+    template<size_t I, typename S, size_t M, typename...K>
+    FORCE_INLINE auto ode_combine(const std::array<double, M>& c, const K&...k) {
+        static_assert(sizeof...(K) == M);
+        using E = std::remove_cvref_t<std::tuple_element_t<I, S>>;
+        using T = max_type_t<E>;
+        const std::array<E, M> ki{ E(get<I>(k))... };
+        E acc = E(T(0));
+        for (size_t j = 0; j < M; ++j)
+            if (c[j] != 0)
+                acc = fma_elem(E(T(c[j])), ki[j], acc);
+        return acc;
+    }
+
+    // y + h * (c[0] k[0] + c[1] k[1] + ...)
+    template<typename S, size_t M, typename H, typename...K>
+    FORCE_INLINE S ode_stage(const S& y, const H& h, const std::array<double, M>& c, const K&...k) {
+        S ret;
+        constexpr_for<0, tpa_tuple_size_v<S>, 1>([&](auto I) {
+            using E = std::remove_cvref_t<std::tuple_element_t<I, S>>;
+            get<I>(ret) = fma_elem(E(h), ode_combine<I, S>(c, k...), get<I>(y));
+        });
+        return ret;
+    }
+
+    // Element-wise select between two states.
+    template<typename S, typename M>
+    FORCE_INLINE S state_select(const M& mask, const S& a, const S& b) {
+        S ret;
+        constexpr_for<0, tpa_tuple_size_v<S>, 1>([&](auto I) {
+            using E = std::remove_cvref_t<std::tuple_element_t<I, S>>;
+            get<I>(ret) = sort_traits<E>::select(mask, get<I>(a), get<I>(b));
+        });
+        return ret;
+    }
+
+    // Dormand-Prince 5(4) tableau.
+    struct dopri5 {
+        static constexpr std::array<double, 6> c{ 1. / 5, 3. / 10, 4. / 5, 8. / 9, 1., 1. };
+        static constexpr std::array<double, 1> a2{ 1. / 5 };
+        static constexpr std::array<double, 2> a3{ 3. / 40, 9. / 40 };
+        static constexpr std::array<double, 3> a4{ 44. / 45, -56. / 15, 32. / 9 };
+        static constexpr std::array<double, 4> a5{ 19372. / 6561, -25360. / 2187, 64448. / 6561, -212. / 729 };
+        static constexpr std::array<double, 5> a6{ 9017. / 3168, -355. / 33, 46732. / 5247, 49. / 176, -5103. / 18656 };
+        // 5th order weights; the last stage is evaluated at the new point (first same as last).
+        static constexpr std::array<double, 6> b{ 35. / 384, 0., 500. / 1113, 125. / 192, -2187. / 6784, 11. / 84 };
+        // 5th minus 4th order weights, over all 7 stages.
+        static constexpr std::array<double, 7> e{ 71. / 57600, 0., -71. / 16695, 71. / 1920, -17253. / 339200, 22. / 525, -1. / 40 };
+    };
+
+    template<typename S, typename U>
+    struct dopri5_result {
+        S y;   // 5th order solution
+        S k7;  // f(t + h, y)
+        U err; // scaled RMS error estimate, accept if <= 1
+    };
+
+    // One Dormand-Prince step from (t, y) with k1 = f(t, y).
+    template<typename F, typename S, typename U>
+    FORCE_INLINE dopri5_result<S, U> dopri5_step(F&& f, const U& t, const S& y, const U& h, const S& k1, const U& rtol, const U& atol) {
+        using T = max_type_t<U>;
+        using tab = dopri5;
+        const S k2 = f(fma_elem(U(T(tab::c[0])), h, t), ode_stage(y, h, tab::a2, k1));
+        const S k3 = f(fma_elem(U(T(tab::c[1])), h, t), ode_stage(y, h, tab::a3, k1, k2));
+        const S k4 = f(fma_elem(U(T(tab::c[2])), h, t), ode_stage(y, h, tab::a4, k1, k2, k3));
+        const S k5 = f(fma_elem(U(T(tab::c[3])), h, t), ode_stage(y, h, tab::a5, k1, k2, k3, k4));
+        const S k6 = f(t + h, ode_stage(y, h, tab::a6, k1, k2, k3, k4, k5));
+        const S y5 = ode_stage(y, h, tab::b, k1, k2, k3, k4, k5, k6);
+        const S k7 = f(t + h, y5);
+        using std::abs;
+        using std::max;
+        using std::sqrt;
+        constexpr size_t N = tpa_tuple_size_v<S>;
+        U acc = U(T(0));
+        constexpr_for<0, N, 1>([&](auto I) {
+            const U sc = fma_elem(rtol, max(U(abs(get<I>(y))), U(abs(get<I>(y5)))), atol);
+            const U r = h * U(ode_combine<I, S>(tab::e, k1, k2, k3, k4, k5, k6, k7)) / sc;
+            acc = fma_elem(r, r, acc);
+        });
+        return dopri5_result<S, U>{y5, k7, sqrt(acc / U(T(N)))};
+    }
+
+    // Next step size from the error of a 5th order step.
+    template<typename U>
+    FORCE_INLINE U dopri5_resize(const U& h, const U& err) {
+        using T = max_type_t<U>;
+        using std::min;
+        using std::max;
+        using std::pow;
+        const U factor = min(U(T(5)), max(U(T(0.2)), U(T(0.9)) * pow(err, U(T(-0.2)))));
+        return h * factor;
+    }
+}
+
+// State after steps classic Runge-Kutta steps of size h from (t, y).
+template<typename F, tuple_like S, typename U = detail::state_value_t<S>>
+FORCE_INLINE detail::state_t<S> rk4(F&& f, std::type_identity_t<U> t, S&& y0, const std::type_identity_t<U>& h, size_t steps = 1) {
+    using T = max_type_t<U>;
+    using state = detail::state_t<S>;
+    const U half = h * U(T(0.5));
+    state y = y0;
+    for (size_t i = 0; i < steps; ++i) {
+        const state k1 = f(t, y);
+        const state k2 = f(t + half, detail::ode_stage(y, half, std::array{1.}, k1));
+        const state k3 = f(t + half, detail::ode_stage(y, half, std::array{1.}, k2));
+        const state k4 = f(t + h, detail::ode_stage(y, h, std::array{1.}, k3));
+        y = detail::ode_stage(y, h, std::array{1. / 6, 1. / 3, 1. / 3, 1. / 6}, k1, k2, k3, k4);
+        t = t + h;
+    }
+    return y;
+}
+
+template<typename S, typename U>
+struct rk45_step_result {
+    S y;                   // new state, unchanged in rejected lanes
+    U t;                   // new time, unchanged in rejected lanes
+    U h;                   // proposed size of the next step
+    U err;                 // scaled error estimate
+    detail::lane_mask_t<U> accepted;
+};
+
+/**
+ * One attempted Dormand-Prince 5(4) step of size h. The step is accepted where
+ * the RMS norm of the embedded error, scaled by atol + rtol |y|, is at most 1;
+ * rejected lanes keep (t, y). The next step size is proposed from the error in
+ * both cases.
+ */
+template<typename F, tuple_like S, typename U = detail::state_value_t<S>>
+FORCE_INLINE rk45_step_result<detail::state_t<S>, U> rk45_step(F&& f, const std::type_identity_t<U>& t, S&& y0, const std::type_identity_t<U>& h,
+        const std::type_identity_t<U>& rtol = U(max_type_t<U>(1e-6)), const std::type_identity_t<U>& atol = U(max_type_t<U>(1e-9))) {
+    using state = detail::state_t<S>;
+    const state y = y0;
+    const auto r = detail::dopri5_step(f, t, y, h, state(f(t, y)), rtol, atol);
+    const auto ok = r.err <= U(max_type_t<U>(1));
+    return rk45_step_result<state, U>{
+        detail::state_select(ok, r.y, y), detail::lane_select<U>(ok, t + h, t), detail::dopri5_resize(h, r.err), r.err, ok };
+}
+
+template<typename S, typename U>
+struct rk45_result {
+    S y;                   // state at t
+    U t;                   // t1 in the lanes that finished
+    U h;                   // last proposed step size, signed as t1 - t0
+    detail::lane_mask_t<U> done;
+    size_t steps;          // attempted steps, common to all lanes
+};
+
+/**
+ * Integrate from t0 to t1 with adaptive Dormand-Prince 5(4) steps, starting
+ * with steps of size |h0|. Integration runs backward in lanes where t1 < t0.
+ * Every lane has its own time and step size; lanes that reach t1 stop
+ * advancing while the others go on. Stops after max_steps attempts.
+ */
+template<typename F, tuple_like S, typename U = detail::state_value_t<S>>
+rk45_result<detail::state_t<S>, U> rk45(F&& f, const std::type_identity_t<U>& t0, const std::type_identity_t<U>& t1, S&& y0, const std::type_identity_t<U>& h0,
+        const std::type_identity_t<U>& rtol = U(max_type_t<U>(1e-6)), const std::type_identity_t<U>& atol = U(max_type_t<U>(1e-9)),
+        size_t max_steps = 100000) {
+    using state = detail::state_t<S>;
+    using T = max_type_t<U>;
+    using std::abs;
+    using std::min;
+    using std::max;
+    state y = y0;
+    U t = t0;
+    // Step sizes are kept positive; dir is the direction of integration.
+    U h = abs(h0);
+    const U dir = detail::lane_select<U>(t1 < t0, U(T(-1)), U(T(1)));
+    state k1 = f(t, y);
+    size_t steps = 0;
+    detail::lane_mask_t<U> done = (t1 - t) * dir <= U(T(0));
+    while (not detail::all_lanes(done) and steps < max_steps) {
+        // Finished lanes take empty steps, which are always accepted.
+        const U left = (t1 - t) * dir;
+        const U size = max(U(T(0)), min(h, left));
+        const auto r = detail::dopri5_step(f, t, y, size * dir, k1, rtol, atol);
+        const auto ok = r.err <= U(T(1));
+        y = detail::state_select(ok, r.y, y);
+        k1 = detail::state_select(ok, r.k7, k1);
+        const U tn = detail::lane_select<U>(ok, t + size * dir, t);
+        // Land exactly on t1 when the last step was clipped.
+        t = detail::lane_select<U>(ok & (size == left), t1, tn);
+        h = detail::lane_select<U>(done, h, detail::dopri5_resize(size, r.err));
+        done = (t1 - t) * dir <= U(T(0));
+        ++steps;
+    }
+    return rk45_result<state, U>{y, t, h * dir, done, steps};
+}
+
+/**
+ * Velocity Verlet (kick-drift-kick leapfrog) for x'' = a(x): steps steps of
+ * size h, with one evaluation of a per step. Returns the pair (x, v).
+ */
+template<typename A, tuple_like X, tuple_like V, typename U = detail::state_value_t<X>>
+FORCE_INLINE auto velocity_verlet(A&& accel, X&& x0, V&& v0, const std::type_identity_t<U>& h, size_t steps = 1) {
+    using T = max_type_t<U>;
+    using xstate = detail::state_t<X>;
+    using vstate = detail::state_t<V>;
+    const U half = h * U(T(0.5));
+    xstate x = x0;
+    vstate v = v0;
+    vstate a = accel(x);
+    for (size_t i = 0; i < steps; ++i) {
+        v = detail::ode_stage(v, half, std::array{1.}, a);
+        x = detail::ode_stage(x, h, std::array{1.}, v);
+        a = accel(x);
+        v = detail::ode_stage(v, half, std::array{1.}, a);
+    }
+    return std::pair<xstate, vstate>{x, v};
+}
+
+/**
+ * Drift-kick-drift leapfrog for x'' = a(x): steps steps of size h, with one
+ * evaluation of a per step. Returns the pair (x, v).
+ */
+template<typename A, tuple_like X, tuple_like V, typename U = detail::state_value_t<X>>
+FORCE_INLINE auto leapfrog(A&& accel, X&& x0, V&& v0, const std::type_identity_t<U>& h, size_t steps = 1) {
+    using T = max_type_t<U>;
+    using xstate = detail::state_t<X>;
+    using vstate = detail::state_t<V>;
+    const U half = h * U(T(0.5));
+    xstate x = x0;
+    vstate v = v0;
+    for (size_t i = 0; i < steps; ++i) {
+        x = detail::ode_stage(x, half, std::array{1.}, v);
+        v = detail::ode_stage(v, h, std::array{1.}, vstate(accel(x)));
+        x = detail::ode_stage(x, half, std::array{1.}, v);
+    }
+    return std::pair<xstate, vstate>{x, v};
+}
+
+}
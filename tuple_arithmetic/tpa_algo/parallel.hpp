@@ -0,0 +1,59 @@
+/**
+ * Minimal fork-join helpers used by the bulk kernels.
+ * A `threads` argument of 1 runs on the calling thread, 0 selects
+ * std::thread::hardware_concurrency().
+ */
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "../tuple_arithmetic.hpp"
+
+#pragma once
+
+namespace tpa {
+
+inline unsigned thread_count(unsigned threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    return threads;
+}
+
+// Number of chunks parallel_chunks splits [0, n) into.
+inline size_t chunk_count(size_t n, unsigned threads, size_t grain = 1) {
+    return std::max<size_t>(1, std::min<size_t>(thread_count(threads), n / std::max<size_t>(grain, 1)));
+}
+
+/**
+ * Split [0, n) into chunk_count(n, threads, grain) contiguous chunks and call
+ * fn(chunk, begin, end) for all of them concurrently. The calling thread
+ * processes chunk 0. The split only depends on the arguments, so two calls
+ * with the same arguments see the same chunks.
+ */
+template<typename Fn>
+void parallel_chunks(size_t n, unsigned threads, Fn&& fn, size_t grain = 1) {
+    const size_t chunks = chunk_count(n, threads, grain);
+    auto bound = [n, chunks](size_t c) { return n / chunks * c + std::min(c, n % chunks); };
+    if (chunks == 1) {
+        fn(size_t(0), size_t(0), n);
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    for (size_t c = 1; c < chunks; ++c)
+        workers.emplace_back([&fn, c, b = bound(c), e = bound(c + 1)]() { fn(c, b, e); });
+    fn(size_t(0), size_t(0), bound(1));
+    for (auto& w : workers)
+        w.join();
+}
+
+// fn(i) for i in [0, n), split across threads.
+template<typename Fn>
+void parallel_for(size_t n, unsigned threads, Fn&& fn, size_t grain = 1) {
+    parallel_chunks(n, threads, [&fn](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            fn(i);
+    }, grain);
+}
+
+}
@@ -0,0 +1,329 @@
+/**
+ * Particle kernels over column sets (see soa.hpp): all-pairs gravity, short
+ * range pair forces over a cell list, and the kick and drift steps of a
+ * leapfrog integrator.
+ *
+ * Positions, velocities and accelerations are column sets of D columns, e.g.
+ * std::array<float*, 3>. Computation is done in the value type of the output.
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+#include "neighbors.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Sources per cache tile in the all-pairs kernel, and minimum particles per thread.
+    inline constexpr size_t nbody_tile = size_t(1) << 10;
+    inline constexpr size_t particle_grain = size_t(1) << 8;
+
+    template<typename U, typename Cols, size_t D>
+    FORCE_INLINE void store_point(const Cols& cols, size_t i, const std::array<U, D>& v) {
+        if constexpr (std::is_arithmetic_v<U>)
+            store_record(cols, i, v);
+        else
+            store_columns(cols, i, v);
+    }
+
+    // acc[i..] += sum over sources j in [jb, je) of gm[j] (x[j] - x[i]) / (|x[j] - x[i]|^2 + eps2)^(3/2)
+    template<typename U, typename T, typename Pos, typename Acc>
+    FORCE_INLINE void gravity_block(const Pos& pos, const T* gm, const Acc& acc, size_t i, size_t jb, size_t je, T eps2) {
+        using std::sqrt;
+        constexpr size_t D = tpa_tuple_size_v<Pos>;
+        const auto xi = load_point<U>(pos, i);
+        auto a = load_point<U>(acc, i);
+        for (size_t j = jb; j < je; ++j) {
+            std::array<U, D> d;
+            constexpr_for<0, D, 1>([&](auto K) { d[K] = U(T(get<K>(pos)[j])) - xi[K]; });
+            U r2 = U(eps2);
+            constexpr_for<0, D, 1>([&](auto K) { r2 = fma_elem(d[K], d[K], r2); });
+            // The particle itself, or coincident particles without softening, add nothing.
+            const U s = lane_select<U>(r2 > U(T(0)), U(gm[j]) / (r2 * sqrt(r2)), U(T(0)));
+            constexpr_for<0, D, 1>([&](auto K) { a[K] = fma_elem(s, d[K], a[K]); });
+        }
+        store_point(acc, i, a);
+    }
+}
+
+/**
+ * acc[i] = G sum_j m[j] (x[j] - x[i]) / (|x[j] - x[i]|^2 + eps^2)^(3/2), over all
+ * pairs. Targets are processed a batch at a time against a cache tile of
+ * sources; targets are split across threads.
+ */
+template<soa_columns Pos, typename M, soa_columns Acc, typename T = column_value_t<Acc>>
+    requires( detail::point_sets<Pos, Acc> )
+void nbody_accelerations(const Pos& pos, const M* mass, size_t n, const Acc& acc,
+        std::type_identity_t<T> G = 1, std::type_identity_t<T> eps = 0, unsigned threads = 1) {
+    static_assert(std::is_floating_point_v<T>, "nbody_accelerations: accelerations must be floating point");
+    std::vector<T> gm(n);
+    for (size_t j = 0; j < n; ++j)
+        gm[j] = G * T(mass[j]);
+    const T eps2 = eps * eps;
+    parallel_chunks(n, threads, [&](size_t, size_t begin, size_t end) {
+        constexpr size_t D = tpa_tuple_size_v<Acc>;
+        for (size_t i = begin; i < end; ++i)
+            constexpr_for<0, D, 1>([&](auto K) { get<K>(acc)[i] = T(0); });
+        for (size_t jb = 0; jb < n; jb += detail::nbody_tile) {
+            const size_t je = std::min(n, jb + detail::nbody_tile);
+            size_t i = begin;
+            if constexpr (simd_scalar<T>) {
+                using simd_t = xsimd::batch<T>;
+                for (; i + simd_t::size <= end; i += simd_t::size)
+                    detail::gravity_block<simd_t>(pos, gm.data(), acc, i, jb, je, eps2);
+            }
+            for (; i < end; ++i)
+                detail::gravity_block<T>(pos, gm.data(), acc, i, jb, je, eps2);
+        }
+    }, detail::particle_grain);
+}
+
+/**
+ * Uniform grid of cells of at least the given size over D-dimensional points,
+ * with the points sorted by cell: the points of a cell, and of a run of cells
+ * along the last axis, are contiguous. The coordinates are copied in sorted
+ * order, so ranges of points can be loaded as batches.
+ */
+template<typename T, size_t D = 3>
+class cell_list {
+    static_assert(std::is_floating_point_v<T>, "cell_list: only floating point coordinates are supported");
+    public:
+        using value_type = T;
+        static constexpr size_t dim = D;
+
+        cell_list() = default;
+
+        template<soa_columns Pos>
+        cell_list(const Pos& pos, size_t n, T cell_size) : m_index(n) {
+            static_assert(tpa_tuple_size_v<Pos> == D, "cell_list: dimension mismatch");
+            m_lo.fill(T(0));
+            std::array<T, D> hi;
+            hi.fill(T(0));
+            if (n > 0) {
+                m_lo = detail::load_point<T>(pos, 0);
+                hi = m_lo;
+                for (size_t i = 1; i < n; ++i) {
+                    const auto x = detail::load_point<T>(pos, i);
+                    m_lo = min(m_lo, x);
+                    hi = max(hi, x);
+                }
+            }
+            // Larger cells are still correct; keep the grid within a few cells per point.
+            const size_t max_cells = std::max<size_t>(64, 4 * n);
+            T size = cell_size;
+            size_t cells;
+            for (;;) {
+                cells = 1;
+                for (size_t k = 0; k < D; ++k) {
+                    m_shape[k] = size_t((hi[k] - m_lo[k]) / size) + 1;
+                    cells *= m_shape[k];
+                }
+                if (cells <= max_cells)
+                    break;
+                size *= 2;
+            }
+            m_inv_size = T(1) / size;
+
+            // Counting sort by cell.
+            std::vector<size_t> cell(n);
+            m_start.assign(cells + 1, 0);
+            for (size_t i = 0; i < n; ++i) {
+                cell[i] = cell_of(detail::load_point<T>(pos, i));
+                ++m_start[cell[i] + 1];
+            }
+            for (size_t c = 0; c < cells; ++c)
+                m_start[c + 1] += m_start[c];
+            std::vector<size_t> next(m_start.begin(), m_start.end() - 1);
+            for (size_t i = 0; i < n; ++i)
+                m_index[next[cell[i]]++] = i;
+            for (size_t k = 0; k < D; ++k)
+                m_columns[k].resize(n);
+            for (size_t p = 0; p < n; ++p) {
+                const auto x = detail::load_point<T>(pos, m_index[p]);
+                for (size_t k = 0; k < D; ++k)
+                    m_columns[k][p] = x[k];
+            }
+        }
+
+        size_t size() const { return m_index.size(); }
+        size_t cell_count() const { return m_start.empty() ? 0 : m_start.size() - 1; }
+        const std::array<size_t, D>& shape() const { return m_shape; }
+
+        // Index, in the input, of the point at sorted position p.
+        const size_t* index() const { return m_index.data(); }
+
+        // Sorted coordinates, as a column set.
+        std::array<const T*, D> columns() const {
+            std::array<const T*, D> ret;
+            for (size_t k = 0; k < D; ++k)
+                ret[k] = m_columns[k].data();
+            return ret;
+        }
+
+        // Sorted positions [cell_begin(c), cell_end(c)) are the points in cell c.
+        size_t cell_begin(size_t c) const { return m_start[c]; }
+        size_t cell_end(size_t c) const { return m_start[c + 1]; }
+
+        // Row-major index of the cell containing x, clamped to the grid.
+        size_t cell_of(const std::array<T, D>& x) const {
+            size_t c = 0;
+            for (size_t k = 0; k < D; ++k)
+                c = c * m_shape[k] + cell_coord(x, k);
+            return c;
+        }
+
+        /**
+         * fn(begin, end) for the ranges of sorted positions covering cell c and
+         * its neighbours (3^D cells, fewer at the border), one range per run of
+         * cells along the last axis.
+         */
+        template<typename Fn>
+        void for_each_neighbor_range(size_t c, Fn&& fn) const {
+            std::array<size_t, D> coord;
+            for (size_t k = D; k-- > 0;) {
+                coord[k] = c % m_shape[k];
+                c /= m_shape[k];
+            }
+            const size_t last_lo = coord[D - 1] > 0 ? coord[D - 1] - 1 : 0;
+            const size_t last_hi = std::min(coord[D - 1] + 1, m_shape[D - 1] - 1);
+            size_t runs = 1;
+            for (size_t k = 0; k + 1 < D; ++k)
+                runs *= 3;
+            for (size_t r = 0; r < runs; ++r) {
+                size_t base = 0, code = r;
+                bool inside = true;
+                for (size_t k = 0; k + 1 < D; ++k) {
+                    const std::ptrdiff_t ck = std::ptrdiff_t(coord[k]) + std::ptrdiff_t(code % 3) - 1;
+                    code /= 3;
+                    inside = inside and ck >= 0 and ck < std::ptrdiff_t(m_shape[k]);
+                    base = base * m_shape[k] + size_t(ck);
+                }
+                if (inside) {
+                    base *= m_shape[D - 1];
+                    fn(m_start[base + last_lo], m_start[base + last_hi + 1]);
+                }
+            }
+        }
+
+    private:
+        std::array<T, D> m_lo;
+        T m_inv_size = 1;
+        std::array<size_t, D> m_shape;
+        std::vector<size_t> m_start;
+        std::vector<size_t> m_index;
+        std::array<std::vector<T>, D> m_columns;
+
+        size_t cell_coord(const std::array<T, D>& x, size_t k) const {
+            const T f = (x[k] - m_lo[k]) * m_inv_size;
+            return f <= T(0) ? 0 : std::min(size_t(f), m_shape[k] - 1);
+        }
+};
+
+/**
+ * acc[i] = sum over j with 0 < |x[i] - x[j]| < cutoff of fn(r2) (x[i] - x[j]),
+ * where r2 = |x[i] - x[j]|^2, for the points of a cell list whose cells are at
+ * least cutoff wide. fn maps r2 to the force over the distance (divided by the
+ * mass, for accelerations); it takes and returns scalars or batches. Pairs are
+ * evaluated a batch of neighbours at a time; cells are split across threads.
+ */
+template<typename T, size_t D, typename Fn, soa_columns Acc>
+    requires( tpa_tuple_size_v<Acc> == D )
+void pair_forces(const cell_list<T, D>& cells, std::type_identity_t<T> cutoff, Fn&& fn, const Acc& acc, unsigned threads = 1) {
+    using R = column_value_t<Acc>;
+    using batch_t = std::conditional_t<simd_scalar<T>, xsimd::batch<T>, T>;
+    const auto cols = cells.columns();
+    const size_t* index = cells.index();
+    const T rc2 = cutoff * cutoff;
+    parallel_chunks(cells.cell_count(), threads, [&](size_t, size_t cbegin, size_t cend) {
+        for (size_t c = cbegin; c < cend; ++c) {
+            for (size_t p = cells.cell_begin(c); p < cells.cell_end(c); ++p) {
+                const auto xi = detail::load_point<T>(cols, p);
+                std::array<T, D> a;
+                a.fill(T(0));
+                // Lane partial sums over all neighbour ranges, reduced once per point.
+                std::array<batch_t, D> ab;
+                if constexpr (simd_scalar<T>)
+                    ab.fill(batch_t(T(0)));
+                cells.for_each_neighbor_range(c, [&](size_t b, size_t e) {
+                    size_t j = b;
+                    if constexpr (simd_scalar<T>) {
+                        constexpr size_t W = batch_t::size;
+                        const auto xb = detail::broadcast_point<batch_t>(xi);
+                        for (; j + W <= e; j += W) {
+                            const auto xj = detail::load_point<batch_t>(cols, j);
+                            std::array<batch_t, D> d;
+                            batch_t r2(T(0));
+                            constexpr_for<0, D, 1>([&](auto K) {
+                                d[K] = xb[K] - xj[K];
+                                r2 = detail::fma_elem(d[K], d[K], r2);
+                            });
+                            const auto near = (r2 < batch_t(rc2)) & (r2 > batch_t(T(0)));
+                            if (xsimd::none(near))
+                                continue;
+                            const batch_t s = xsimd::select(near, batch_t(fn(r2)), batch_t(T(0)));
+                            constexpr_for<0, D, 1>([&](auto K) { ab[K] = detail::fma_elem(s, d[K], ab[K]); });
+                        }
+                    }
+                    for (; j < e; ++j) {
+                        const auto xj = detail::load_point<T>(cols, j);
+                        std::array<T, D> d;
+                        T r2 = 0;
+                        for (size_t k = 0; k < D; ++k) {
+                            d[k] = xi[k] - xj[k];
+                            r2 += d[k] * d[k];
+                        }
+                        if (r2 < rc2 and r2 > T(0)) {
+                            const T s = T(fn(r2));
+                            for (size_t k = 0; k < D; ++k)
+                                a[k] += s * d[k];
+                        }
+                    }
+                });
+                if constexpr (simd_scalar<T>)
+                    constexpr_for<0, D, 1>([&](auto K) { a[K] += xsimd::reduce_add(ab[K]); });
+                constexpr_for<0, D, 1>([&](auto K) { get<K>(acc)[index[p]] = R(a[K]); });
+            }
+        }
+    }, 1);
+}
+
+// vel[i] += dt acc[i]
+template<soa_columns Vel, soa_columns Acc>
+    requires( detail::point_sets<Vel, Acc> )
+void kick(const Vel& vel, const Acc& acc, size_t n, std::type_identity_t<column_value_t<Vel>> dt, unsigned threads = 1) {
+    using T = column_value_t<Vel>;
+    parallel_chunks(n, threads, [&](size_t, size_t begin, size_t end) {
+        size_t i = begin;
+        if constexpr (simd_scalar<T>) {
+            using simd_t = xsimd::batch<T>;
+            const simd_t h(dt);
+            for (; i + simd_t::size <= end; i += simd_t::size) {
+                auto v = detail::load_point<simd_t>(vel, i);
+                const auto a = detail::load_point<simd_t>(acc, i);
+                constexpr_for<0, tpa_tuple_size_v<Vel>, 1>([&](auto K) { v[K] = detail::fma_elem(h, a[K], v[K]); });
+                store_columns(vel, i, v);
+            }
+        }
+        for (; i < end; ++i)
+            constexpr_for<0, tpa_tuple_size_v<Vel>, 1>([&](auto K) { get<K>(vel)[i] += dt * T(get<K>(acc)[i]); });
+    }, detail::particle_grain);
+}
+
+// pos[i] += dt vel[i]
+template<soa_columns Pos, soa_columns Vel>
+    requires( detail::point_sets<Pos, Vel> )
+void drift(const Pos& pos, const Vel& vel, size_t n, std::type_identity_t<column_value_t<Pos>> dt, unsigned threads = 1) {
+    kick(pos, vel, n, dt, threads);
+}
+
+}
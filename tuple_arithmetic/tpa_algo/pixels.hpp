@@ -0,0 +1,273 @@
+/**
+ * Integer arithmetic for 8- and 16-bit pixels: saturating add and subtract,
+ * rounding average, high half of products, and widening and saturating
+ * narrowing conversions.
+ *
+ * Every function takes scalars, batches, or tuples of them element by
+ * element (with scalars broadcast, as for the arithmetic operators). Unlike
+ * the operators, results keep the element type: a + b on uint8_t promotes to
+ * int, sat_add(a, b) stays uint8_t and clamps to [0, 255]. On batches, the
+ * operations stay in registers of the narrow type, so a register holds 16 to
+ * 64 components; widening interleaves with zeros or sign bits, and narrowing
+ * keeps the low half of each lane with a shuffle.
+ *
+ * transform_pixels applies such a function to whole arrays of pixels, one
+ * register of components at a time.
+ */
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+
+#pragma once
+
+namespace tpa {
+
+template<typename T>
+concept pixel_int = std::integral<T> and not std::is_same_v<T, bool> and sizeof(T) <= 4;
+
+namespace detail {
+    // Minimum number of components per chunk in threaded pixel transforms.
+    inline constexpr size_t pixel_grain = size_t(1) << 16;
+
+    // Scalar type and number of components of a pixel.
+    template<typename P>
+    struct pixel_traits {
+        using value_type = P;
+        static constexpr size_t components = 1;
+    };
+    template<tuple_like P>
+    struct pixel_traits<P> {
+        using value_type = std::remove_cvref_t<std::tuple_element_t<0, P>>;
+        static constexpr size_t components = tpa_tuple_size_v<P>;
+        static_assert(sizeof(P) == components * sizeof(value_type),
+                "pixels: tuple pixels must be stored as contiguous components of one type");
+    };
+
+    // Integer of twice the width and the same signedness.
+    template<pixel_int T>
+    using int_wide_t = std::conditional_t<std::is_signed_v<T>,
+        std::conditional_t<sizeof(T) == 1, int16_t, std::conditional_t<sizeof(T) == 2, int32_t, int64_t>>,
+        std::conditional_t<sizeof(T) == 1, uint16_t, std::conditional_t<sizeof(T) == 2, uint32_t, uint64_t>>>;
+
+    // Integer of half the width and the same signedness.
+    template<typename W>
+        requires( std::integral<W> and sizeof(W) >= 2 )
+    using int_narrow_t = std::conditional_t<std::is_signed_v<W>,
+        std::conditional_t<sizeof(W) == 2, int8_t, std::conditional_t<sizeof(W) == 4, int16_t, int32_t>>,
+        std::conditional_t<sizeof(W) == 2, uint8_t, std::conditional_t<sizeof(W) == 4, uint16_t, uint32_t>>>;
+
+    template<typename T, typename W>
+    FORCE_INLINE constexpr T saturate(W x) {
+        return T(std::clamp<W>(x, W(std::numeric_limits<T>::min()), W(std::numeric_limits<T>::max())));
+    }
+
+    // The register of x as lanes of type U.
+    template<typename U, typename T, typename A>
+    FORCE_INLINE xsimd::batch<U, A> reinterpret(const xsimd::batch<T, A>& x) {
+        static_assert(sizeof(xsimd::batch<U, A>) == sizeof(xsimd::batch<T, A>));
+        return std::bit_cast<xsimd::batch<U, A>>(x);
+    }
+
+    // Lanes 0, 2, 4, ... of a followed by those of b.
+    template<typename T, typename A, size_t... I>
+    FORCE_INLINE xsimd::batch<T, A> even_lanes(const xsimd::batch<T, A>& a, const xsimd::batch<T, A>& b,
+            std::index_sequence<I...>) {
+        using idx_t = std::make_unsigned_t<T>;
+        return xsimd::shuffle(a, b, xsimd::batch_constant<idx_t, A, idx_t(2 * I)...>());
+    }
+
+    // Low halves of the lanes of lo and hi, in one batch of the narrow type.
+    template<typename W, typename A>
+    FORCE_INLINE auto narrow_trunc(const xsimd::batch<W, A>& lo, const xsimd::batch<W, A>& hi) {
+        using T = int_narrow_t<W>;
+        return even_lanes(reinterpret<T>(lo), reinterpret<T>(hi),
+                std::make_index_sequence<xsimd::batch<T, A>::size>());
+    }
+}
+
+/**
+ * Scalar and batch operations. sat_add and sat_sub clamp to the range of the
+ * type; avg(a, b) is (a + b + 1) >> 1 without overflow, as pavgb; mulhi(a, b)
+ * is the high half of the double-width product, (a * b) >> bits.
+ */
+template<pixel_int T>
+FORCE_INLINE constexpr T sat_add(T a, std::type_identity_t<T> b) {
+    using W = detail::int_wide_t<T>;
+    return detail::saturate<T>(W(W(a) + W(b)));
+}
+
+template<pixel_int T>
+FORCE_INLINE constexpr T sat_sub(T a, std::type_identity_t<T> b) {
+    using W = std::make_signed_t<detail::int_wide_t<T>>;
+    return detail::saturate<T>(W(W(a) - W(b)));
+}
+
+template<pixel_int T>
+FORCE_INLINE constexpr T avg(T a, std::type_identity_t<T> b) {
+    using W = detail::int_wide_t<T>;
+    return T((W(a) + W(b) + W(1)) >> 1);
+}
+
+template<pixel_int T>
+FORCE_INLINE constexpr T mulhi(T a, std::type_identity_t<T> b) {
+    using W = detail::int_wide_t<T>;
+    return T((W(a) * W(b)) >> (8 * sizeof(T)));
+}
+
+template<pixel_int T, typename A>
+FORCE_INLINE xsimd::batch<T, A> sat_add(const xsimd::batch<T, A>& a, const std::type_identity_t<xsimd::batch<T, A>>& b) {
+    return xsimd::sadd(a, b);
+}
+
+template<pixel_int T, typename A>
+FORCE_INLINE xsimd::batch<T, A> sat_sub(const xsimd::batch<T, A>& a, const std::type_identity_t<xsimd::batch<T, A>>& b) {
+    return xsimd::ssub(a, b);
+}
+
+template<pixel_int T, typename A>
+FORCE_INLINE xsimd::batch<T, A> avg(const xsimd::batch<T, A>& a, const std::type_identity_t<xsimd::batch<T, A>>& b) {
+    // a + b = 2 (a | b) - (a ^ b), rounded up.
+    return (a | b) - ((a ^ b) >> 1);
+}
+
+/**
+ * Widening: a scalar converts to the type of twice its width, a batch to the
+ * two batches of its low and high lanes.
+ */
+template<pixel_int T>
+FORCE_INLINE constexpr detail::int_wide_t<T> widen(T a) { return detail::int_wide_t<T>(a); }
+
+template<pixel_int T, typename A>
+FORCE_INLINE auto widen(const xsimd::batch<T, A>& a) {
+    using W = detail::int_wide_t<T>;
+    // Little-endian: pairs (lane, extension) are the lanes of the wide type.
+    const xsimd::batch<T, A> ext = std::is_signed_v<T> ? a >> int32_t(8 * sizeof(T) - 1) : xsimd::batch<T, A>(T(0));
+    return std::array<xsimd::batch<W, A>, 2>{
+        detail::reinterpret<W>(xsimd::zip_lo(a, ext)),
+        detail::reinterpret<W>(xsimd::zip_hi(a, ext)) };
+}
+
+/**
+ * Saturating narrowing: a scalar converts to the type of half its width, and
+ * two batches to one batch of their lanes, lo first, as packuswb for unsigned
+ * types and packsswb for signed ones.
+ */
+template<typename W>
+    requires( pixel_int<W> and sizeof(W) >= 2 )
+FORCE_INLINE constexpr detail::int_narrow_t<W> narrow_sat(W a) { return detail::saturate<detail::int_narrow_t<W>>(a); }
+
+template<typename W, typename A>
+    requires( pixel_int<W> and sizeof(W) >= 2 )
+FORCE_INLINE auto narrow_sat(const xsimd::batch<W, A>& lo, const std::type_identity_t<xsimd::batch<W, A>>& hi) {
+    using T = detail::int_narrow_t<W>;
+    using std::min;
+    using std::max;
+    const xsimd::batch<W, A> l(W(std::numeric_limits<T>::min())), h(W(std::numeric_limits<T>::max()));
+    return detail::narrow_trunc(min(max(lo, l), h), min(max(hi, l), h));
+}
+
+template<pixel_int T, typename A>
+FORCE_INLINE xsimd::batch<T, A> mulhi(const xsimd::batch<T, A>& a, const std::type_identity_t<xsimd::batch<T, A>>& b) {
+    const auto wa = widen(a);
+    const auto wb = widen(b);
+    constexpr int32_t bits = 8 * sizeof(T);
+    // The high halves fit in T, so truncation is exact.
+    return detail::narrow_trunc((wa[0] * wb[0]) >> bits, (wa[1] * wb[1]) >> bits);
+}
+
+// Tuples, element by element.
+template<typename Tp1, typename Tp2>
+    requires( tuple_like<Tp1> or tuple_like<Tp2> )
+FORCE_INLINE constexpr auto sat_add(Tp1&& a, Tp2&& b) {
+    return apply_binary_op([](auto&& x, auto&& y) { return sat_add(x, y); }, std::forward<Tp1>(a), std::forward<Tp2>(b));
+}
+
+template<typename Tp1, typename Tp2>
+    requires( tuple_like<Tp1> or tuple_like<Tp2> )
+FORCE_INLINE constexpr auto sat_sub(Tp1&& a, Tp2&& b) {
+    return apply_binary_op([](auto&& x, auto&& y) { return sat_sub(x, y); }, std::forward<Tp1>(a), std::forward<Tp2>(b));
+}
+
+template<typename Tp1, typename Tp2>
+    requires( tuple_like<Tp1> or tuple_like<Tp2> )
+FORCE_INLINE constexpr auto avg(Tp1&& a, Tp2&& b) {
+    return apply_binary_op([](auto&& x, auto&& y) { return avg(x, y); }, std::forward<Tp1>(a), std::forward<Tp2>(b));
+}
+
+template<typename Tp1, typename Tp2>
+    requires( tuple_like<Tp1> or tuple_like<Tp2> )
+FORCE_INLINE constexpr auto mulhi(Tp1&& a, Tp2&& b) {
+    return apply_binary_op([](auto&& x, auto&& y) { return mulhi(x, y); }, std::forward<Tp1>(a), std::forward<Tp2>(b));
+}
+
+template<tuple_like Tp>
+FORCE_INLINE constexpr auto widen(Tp&& a) {
+    return apply_unary_op([](auto&& x) { return widen(x); }, std::forward<Tp>(a));
+}
+
+template<tuple_like Tp>
+FORCE_INLINE constexpr auto narrow_sat(Tp&& a) {
+    return apply_unary_op([](auto&& x) { return narrow_sat(x); }, std::forward<Tp>(a));
+}
+
+// Tuples of batches: element k of the result packs elements k of lo and hi.
+template<tuple_like Tp1, tuple_like Tp2>
+FORCE_INLINE constexpr auto narrow_sat(Tp1&& lo, Tp2&& hi) {
+    return apply_binary_op([](auto&& x, auto&& y) { return narrow_sat(x, y); }, std::forward<Tp1>(lo), std::forward<Tp2>(hi));
+}
+
+namespace detail {
+    // out[i] = fn(in[i]...) for components [begin, end), a register at a time.
+    template<typename T, typename F, typename... In>
+    void transform_components(F& fn, T* out, size_t begin, size_t end, const In*... in) {
+        size_t i = begin;
+        if constexpr (simd_scalar<T>) {
+            using simd_t = xsimd::batch<T>;
+            constexpr size_t W = simd_t::size;
+            for (; i + W <= end; i += W)
+                simd_t(fn(simd_t::load_unaligned(in + i)...)).store_unaligned(out + i);
+        }
+        for (; i < end; ++i)
+            out[i] = T(fn(in[i]...));
+    }
+
+    template<typename P, typename F, typename... In>
+    void transform_pixels(F& fn, P* out, size_t n, unsigned threads, const In*... in) {
+        using T = typename pixel_traits<P>::value_type;
+        const size_t m = n * pixel_traits<P>::components;
+        parallel_chunks(m, threads, [&](size_t, size_t begin, size_t end) {
+            transform_components(fn, reinterpret_cast<T*>(out), begin, end, reinterpret_cast<const T*>(in)...);
+        }, pixel_grain);
+    }
+}
+
+/**
+ * out[i] = fn(in[i]) or fn(a[i], b[i]) for arrays of n pixels, which are
+ * scalars or contiguous tuples of one component type, such as
+ * std::array<uint8_t, 4>. fn is applied to the components, independently:
+ * it is called with batches of the component type, each holding the
+ * components of several pixels, and with scalars for the last ones. It must
+ * return the component type, as the functions above do. out may be one of
+ * the inputs.
+ */
+template<typename P, typename F>
+void transform_pixels(const P* in, P* out, size_t n, F&& fn, unsigned threads = 1) {
+    detail::transform_pixels(fn, out, n, threads, in);
+}
+
+template<typename P, typename F>
+void transform_pixels(const P* a, const P* b, P* out, size_t n, F&& fn, unsigned threads = 1) {
+    detail::transform_pixels(fn, out, n, threads, a, b);
+}
+
+}
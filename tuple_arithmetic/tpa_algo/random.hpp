@@ -0,0 +1,351 @@
+/**
+ * Counter-based random numbers: the Philox4x32-10 generator and uniform,
+ * normal and exponential variates as scalars, batches or tuples.
+ *
+ * Word i of a stream is a pure function of the seed, the stream number and i:
+ * word 4 b + k is word k of the Philox block of counter b. So jumping ahead is
+ * free, independent streams need no state, and blocks are generated many
+ * counters at a time with plain loops that compile to vector code.
+ *
+ * A variate of element type U consumes a fixed number of words: one per float
+ * and two per double, times the lanes of a batch, and twice that for normals.
+ * The bulk fills split the output in units of a batch and give each thread
+ * the words at its own offset, so their results do not depend on the number
+ * of threads. Values do depend on the element type: a batch of W uniforms is
+ * the same as W scalar draws, but normals and exponentials are computed with
+ * the batch or the scalar math functions.
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "parallel.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    inline constexpr uint32_t philox_m0 = 0xD2511F53, philox_m1 = 0xCD9E8D57;
+    inline constexpr uint32_t philox_w0 = 0x9E3779B9, philox_w1 = 0xBB67AE85;
+    inline constexpr int philox_rounds = 10;
+
+    // Counters per vectorized call, and words per tile in bulk fills.
+    inline constexpr size_t philox_lanes = 16;
+    inline constexpr size_t random_tile = size_t(1) << 10;
+
+    /**
+     * Philox4x32-10 of the B counters (first + b, stream), b < B, as 128-bit
+     * counters of four words, low first: word k of block b goes to out[4 b + k].
+     * Each counter is one lane of the loops.
+     */
+    template<size_t B>
+    FORCE_INLINE void philox_blocks(uint64_t first, uint64_t stream, uint64_t key, uint32_t* out) {
+        std::array<uint32_t, B> c0, c1, c2, c3;
+        for (size_t b = 0; b < B; ++b) {
+            c0[b] = uint32_t(first + b);
+            c1[b] = uint32_t((first + b) >> 32);
+            c2[b] = uint32_t(stream);
+            c3[b] = uint32_t(stream >> 32);
+        }
+        uint32_t k0 = uint32_t(key), k1 = uint32_t(key >> 32);
+        for (int r = 0; r < philox_rounds; ++r) {
+            for (size_t b = 0; b < B; ++b) {
+                const uint64_t p0 = uint64_t(philox_m0) * c0[b];
+                const uint64_t p1 = uint64_t(philox_m1) * c2[b];
+                c0[b] = uint32_t(p1 >> 32) ^ c1[b] ^ k0;
+                c2[b] = uint32_t(p0 >> 32) ^ c3[b] ^ k1;
+                c1[b] = uint32_t(p1);
+                c3[b] = uint32_t(p0);
+            }
+            k0 += philox_w0;
+            k1 += philox_w1;
+        }
+        for (size_t b = 0; b < B; ++b) {
+            out[4 * b] = c0[b];
+            out[4 * b + 1] = c1[b];
+            out[4 * b + 2] = c2[b];
+            out[4 * b + 3] = c3[b];
+        }
+    }
+}
+
+/**
+ * Philox4x32-10 (Salmon et al., 2011) with a 64-bit key, the seed, and a
+ * 64-bit stream number in the high half of the counter. Satisfies
+ * std::uniform_random_bit_generator, and also produces words in bulk.
+ */
+class philox {
+    public:
+        using result_type = uint32_t;
+
+        explicit philox(uint64_t seed = 0, uint64_t stream = 0) : m_key(seed), m_stream(stream) {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return UINT32_MAX; }
+
+        // The block of a full 128-bit counter and key, both low word first.
+        static std::array<uint32_t, 4> block(const std::array<uint32_t, 4>& counter, const std::array<uint32_t, 2>& key) {
+            std::array<uint32_t, 4> ret;
+            detail::philox_blocks<1>(uint64_t(counter[1]) << 32 | counter[0], uint64_t(counter[3]) << 32 | counter[2],
+                                     uint64_t(key[1]) << 32 | key[0], ret.data());
+            return ret;
+        }
+
+        uint64_t seed() const { return m_key; }
+        uint64_t stream() const { return m_stream; }
+        // Index of the next word in the stream.
+        uint64_t position() const { return m_pos; }
+
+        // Jump to word pos, or ahead by n words.
+        void seek(uint64_t pos) { m_pos = pos; }
+        void discard(uint64_t n) { m_pos += n; }
+
+        // The generator of another stream with the same seed, at its start.
+        philox split(uint64_t stream) const { return philox(m_key, stream); }
+
+        result_type operator()() {
+            const uint64_t b = m_pos / 4;
+            if (b != m_buffered) {
+                detail::philox_blocks<1>(b, m_stream, m_key, m_buffer.data());
+                m_buffered = b;
+            }
+            return m_buffer[m_pos++ % 4];
+        }
+
+        // out[0..n) = the next n words.
+        void fill(uint32_t* out, size_t n) {
+            generate(m_pos, out, n);
+            m_pos += n;
+        }
+
+        // out[0..n) = words pos, pos + 1, ... of the stream, without moving.
+        void generate(uint64_t pos, uint32_t* out, size_t n) const {
+            constexpr size_t B = detail::philox_lanes;
+            std::array<uint32_t, 4 * B> buf;
+            while (n > 0) {
+                const uint64_t b = pos / 4;
+                const size_t skip = size_t(pos % 4);
+                if (skip == 0 and n >= 4 * B) {
+                    detail::philox_blocks<B>(b, m_stream, m_key, out);
+                    pos += 4 * B;
+                    out += 4 * B;
+                    n -= 4 * B;
+                    continue;
+                }
+                const size_t count = std::min(n, 4 - skip);
+                detail::philox_blocks<1>(b, m_stream, m_key, buf.data());
+                std::copy_n(buf.data() + skip, count, out);
+                pos += count;
+                out += count;
+                n -= count;
+            }
+        }
+
+    private:
+        uint64_t m_key;
+        uint64_t m_stream;
+        uint64_t m_pos = 0;
+        uint64_t m_buffered = UINT64_MAX;
+        std::array<uint32_t, 4> m_buffer;
+};
+
+namespace detail {
+    // Scalar type of a variate: float or double, possibly in batches or tuples.
+    template<typename U>
+    using variate_scalar_t = max_type_t<std::remove_cvref_t<max_type_t<U>>>;
+
+    template<typename U>
+    static constexpr size_t variate_lanes = std::is_arithmetic_v<U> ? 1 : sizeof(U) / sizeof(max_type_t<U>);
+
+    // Words per uniform variate of scalar or batch type U.
+    template<typename U>
+    static constexpr size_t variate_words = variate_lanes<U> * sizeof(max_type_t<U>) / sizeof(uint32_t);
+
+    template<typename U>
+    concept random_element = std::is_same_v<variate_scalar_t<U>, float> or std::is_same_v<variate_scalar_t<U>, double>;
+
+    // Uniform in [0, 1) from the words w: the top 24 bits of one word for a
+    // float, the top 53 of two for a double.
+    template<typename U>
+    FORCE_INLINE U uniform_from(const uint32_t* w) {
+        using T = max_type_t<U>;
+        constexpr size_t W = variate_lanes<U>;
+        alignas(64) std::array<T, W> u;
+        for (size_t l = 0; l < W; ++l) {
+            if constexpr (std::is_same_v<T, float>)
+                u[l] = T(w[l] >> 8) * 0x1p-24f;
+            else
+                u[l] = T((uint64_t(w[2 * l]) << 32 | w[2 * l + 1]) >> 11) * 0x1p-53;
+        }
+        if constexpr (std::is_arithmetic_v<U>)
+            return u[0];
+        else
+            return U::load_aligned(u.data());
+    }
+
+    template<typename U>
+    FORCE_INLINE U uniform_draw(philox& gen) {
+        std::array<uint32_t, variate_words<U>> w;
+        gen.fill(w.data(), w.size());
+        return uniform_from<U>(w.data());
+    }
+
+    // Box-Muller: (r cos t, r sin t) from u1 in [0, 1) and u2 in [0, 1).
+    template<typename U>
+    FORCE_INLINE std::pair<U, U> box_muller(const U& u1, const U& u2) {
+        using T = max_type_t<U>;
+        using std::log;
+        using std::sqrt;
+        const U r = sqrt(U(T(-2)) * log(U(T(1)) - u1));
+        const U t = U(T(2) * std::numbers::pi_v<T>) * u2;
+        if constexpr (std::is_arithmetic_v<U>)
+            return {r * std::cos(t), r * std::sin(t)};
+        else {
+            const auto [s, c] = xsimd::sincos(t);
+            return {r * c, r * s};
+        }
+    }
+
+    // -log(1 - u)
+    template<typename U>
+    FORCE_INLINE U exponential_from(const U& u) {
+        using T = max_type_t<U>;
+        using std::log;
+        return -log(U(T(1)) - u);
+    }
+
+    // Element by element for tuples, with the same draws as a loop over them.
+    template<typename U, typename Fn>
+    FORCE_INLINE U draw_elements(Fn&& fn) {
+        if constexpr (tuple_like<U>) {
+            U ret;
+            constexpr_for<0, tpa_tuple_size_v<U>, 1>([&](auto K) {
+                get<K>(ret) = fn.template operator()<std::remove_cvref_t<std::tuple_element_t<K, U>>>();
+            });
+            return ret;
+        }
+        else
+            return fn.template operator()<U>();
+    }
+
+    template<typename T, typename U>
+    FORCE_INLINE void store_lanes(const U& v, T* out, size_t count) {
+        if constexpr (std::is_arithmetic_v<U>)
+            *out = v;
+        else if (count == U::size)
+            v.store_unaligned(out);
+        else {
+            const auto a = to_array(v);
+            std::copy_n(a.data(), count, out);
+        }
+    }
+
+    /**
+     * out[0..n) in units of `unit` values drawn from `words` words each, by
+     * fn(w, out, count), where w points to the words of the unit and count <=
+     * unit is the number of values to store. Units are split across threads,
+     * and each chunk generates the words at its own offset a tile at a time.
+     */
+    template<typename T, typename Fn>
+    void fill_variates(philox& gen, T* out, size_t n, size_t unit, size_t words, unsigned threads, Fn&& fn) {
+        const size_t units = (n + unit - 1) / unit;
+        const size_t tile = std::max<size_t>(1, random_tile / words);
+        const uint64_t start = gen.position();
+        parallel_chunks(units, threads, [&](size_t, size_t begin, size_t end) {
+            std::vector<uint32_t> w(tile * words);
+            for (size_t tb = begin; tb < end; tb += tile) {
+                const size_t te = std::min(end, tb + tile);
+                gen.generate(start + uint64_t(tb) * words, w.data(), (te - tb) * words);
+                for (size_t k = tb; k < te; ++k)
+                    fn(w.data() + (k - tb) * words, out + k * unit, std::min(unit, n - k * unit));
+            }
+        }, std::max<size_t>(1, random_tile / unit));
+        gen.discard(uint64_t(units) * words);
+    }
+
+    // The widest element type of bulk fills.
+    template<typename T>
+    using fill_element_t = std::conditional_t<simd_scalar<T>, xsimd::batch<T>, T>;
+}
+
+// Uniform in [0, 1), or in [lo, hi).
+template<typename U>
+    requires( detail::random_element<U> )
+FORCE_INLINE U uniform(philox& gen) {
+    return detail::draw_elements<U>([&]<typename E>() { return detail::uniform_draw<E>(gen); });
+}
+
+template<typename U>
+    requires( detail::random_element<U> )
+FORCE_INLINE U uniform(philox& gen, detail::variate_scalar_t<U> lo, detail::variate_scalar_t<U> hi) {
+    return detail::draw_elements<U>([&]<typename E>() {
+        return detail::fma_elem(E(hi - lo), detail::uniform_draw<E>(gen), E(lo));
+    });
+}
+
+// Normal with the given mean and standard deviation, by Box-Muller.
+template<typename U>
+    requires( detail::random_element<U> )
+FORCE_INLINE U normal(philox& gen, detail::variate_scalar_t<U> mean = 0, detail::variate_scalar_t<U> stddev = 1) {
+    return detail::draw_elements<U>([&]<typename E>() {
+        const E u1 = detail::uniform_draw<E>(gen);
+        const E u2 = detail::uniform_draw<E>(gen);
+        return detail::fma_elem(E(stddev), detail::box_muller(u1, u2).first, E(mean));
+    });
+}
+
+// Exponential with the given rate.
+template<typename U>
+    requires( detail::random_element<U> )
+FORCE_INLINE U exponential(philox& gen, detail::variate_scalar_t<U> rate = 1) {
+    return detail::draw_elements<U>([&]<typename E>() {
+        return detail::exponential_from(detail::uniform_draw<E>(gen)) / E(rate);
+    });
+}
+
+// out[0..n) uniform in [lo, hi), a batch at a time.
+template<typename T>
+    requires( std::is_floating_point_v<T> )
+void fill_uniform(philox& gen, T* out, size_t n, T lo = 0, T hi = 1, unsigned threads = 1) {
+    using U = detail::fill_element_t<T>;
+    detail::fill_variates(gen, out, n, detail::variate_lanes<U>, detail::variate_words<U>, threads,
+            [&](const uint32_t* w, T* o, size_t count) {
+        detail::store_lanes(detail::fma_elem(U(hi - lo), detail::uniform_from<U>(w), U(lo)), o, count);
+    });
+}
+
+// out[0..n) normal; both values of each Box-Muller pair are used.
+template<typename T>
+    requires( std::is_floating_point_v<T> )
+void fill_normal(philox& gen, T* out, size_t n, T mean = 0, T stddev = 1, unsigned threads = 1) {
+    using U = detail::fill_element_t<T>;
+    constexpr size_t W = detail::variate_lanes<U>;
+    constexpr size_t words = detail::variate_words<U>;
+    detail::fill_variates(gen, out, n, 2 * W, 2 * words, threads, [&](const uint32_t* w, T* o, size_t count) {
+        const auto [z0, z1] = detail::box_muller(detail::uniform_from<U>(w), detail::uniform_from<U>(w + words));
+        detail::store_lanes(detail::fma_elem(U(stddev), z0, U(mean)), o, std::min(count, W));
+        if (count > W)
+            detail::store_lanes(detail::fma_elem(U(stddev), z1, U(mean)), o + W, count - W);
+    });
+}
+
+// out[0..n) exponential with the given rate.
+template<typename T>
+    requires( std::is_floating_point_v<T> )
+void fill_exponential(philox& gen, T* out, size_t n, T rate = 1, unsigned threads = 1) {
+    using U = detail::fill_element_t<T>;
+    detail::fill_variates(gen, out, n, detail::variate_lanes<U>, detail::variate_words<U>, threads,
+            [&](const uint32_t* w, T* o, size_t count) {
+        detail::store_lanes(detail::exponential_from(detail::uniform_from<U>(w)) / U(rate), o, count);
+    });
+}
+
+}
@@ -0,0 +1,215 @@
+/**
+ * Root finding for many independent equations at once: Newton and Halley
+ * iterations, and the ITP bracketing method.
+ *
+ * Unknowns are scalars, or batches with one equation per lane; Newton also
+ * solves square systems whose unknown is a tuple. Lanes are frozen with
+ * selects as soon as they converge or fail, and the loop ends when every
+ * lane is done or the iteration cap is hit, so a batch costs as many
+ * function evaluations as its slowest lane.
+ */
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "solve.hpp"
+
+#pragma once
+
+namespace tpa {
+
+template<typename X, typename U>
+struct root_result {
+    X x;                               // root estimate, or the last iterate of failed lanes
+    detail::lane_mask_t<U> converged;  // lanes that met the tolerance
+    size_t iterations;                 // iterations, common to all lanes
+};
+
+namespace detail {
+    // Scalar or batch type of an unknown, or of its elements.
+    template<typename X> struct root_value { using type = std::remove_cvref_t<X>; };
+    template<typename X> requires( tuple_like<X> )
+    struct root_value<X> { using type = std::remove_cvref_t<tuple_max_type_t<std::remove_cvref_t<X>>>; };
+    template<typename X>
+    using root_value_t = typename root_value<X>::type;
+
+    template<typename U>
+    FORCE_INLINE U default_root_tol() {
+        using T = max_type_t<U>;
+        return U(std::sqrt(std::numeric_limits<T>::epsilon()));
+    }
+
+    // Lanes where v is finite.
+    template<typename U>
+    FORCE_INLINE lane_mask_t<U> root_finite(const U& v) {
+        using std::abs;
+        using T = max_type_t<U>;
+        return abs(v) <= U(std::numeric_limits<T>::max());
+    }
+
+    // Steps dx are taken where the function is not already zero; a lane
+    // converges when |dx| <= tol (1 + |x|), in the max norm for tuples.
+    template<typename X, typename U, typename Step>
+    root_result<X, U> newton_iterate(X x, const U& tol, size_t max_iter, Step&& step) {
+        using T = max_type_t<U>;
+        lane_mask_t<U> done = no_lanes<U>();
+        lane_mask_t<U> converged = no_lanes<U>();
+        size_t it = 0;
+        while (not all_lanes(done) and it < max_iter) {
+            const auto [dx, zero, ok] = step(x);
+            const auto move = (!(done | zero)) & ok;
+            U size, scale;
+            if constexpr (std::is_same_v<X, U>) {
+                using std::abs;
+                x = lane_select<U>(move, x - dx, x);
+                size = abs(dx);
+                scale = abs(x);
+            }
+            else {
+                using std::abs;
+                using std::max;
+                size = U(T(0));
+                scale = U(T(0));
+                constexpr_for<0, tpa_tuple_size_v<X>, 1>([&](auto K) {
+                    using E = std::remove_cvref_t<std::tuple_element_t<K, X>>;
+                    get<K>(x) = E(lane_select<U>(move, U(get<K>(x)) - dx[K], U(get<K>(x))));
+                    size = max(size, U(abs(dx[K])));
+                    scale = max(scale, U(abs(U(get<K>(x)))));
+                });
+            }
+            converged = converged | ((!done) & zero) | (move & (size <= tol * (U(T(1)) + scale)));
+            done = done | converged | !(ok | zero);
+            ++it;
+        }
+        return root_result<X, U>{x, converged, it};
+    }
+}
+
+/**
+ * Newton's method for f(x) = 0 from x0, with df the derivative of f. For a
+ * scalar or batch x, f and df return the same type; for a tuple x, f returns
+ * a tuple of the same size and df the Jacobian as a mat, such as the one of
+ * tpa::jacobian. A lane converges when the step is at most tol (1 + |x|)
+ * after taking it, so a simple root is then accurate to about tol^2. Lanes
+ * stop, unconverged, on a zero derivative or a singular Jacobian.
+ */
+template<typename F, typename DF, typename X, typename U = detail::root_value_t<X>>
+root_result<std::remove_cvref_t<X>, U> newton(F&& f, DF&& df, X&& x0,
+        const std::type_identity_t<U>& tol = detail::default_root_tol<U>(), size_t max_iter = 50) {
+    using T = max_type_t<U>;
+    using state = std::remove_cvref_t<X>;
+    if constexpr (not tuple_like<state>) {
+        return detail::newton_iterate(state(x0), tol, max_iter, [&](const U& x) {
+            const U fx = f(x);
+            const U dx = fx / U(df(x));
+            return std::tuple{dx, fx == U(T(0)), detail::root_finite(dx)};
+        });
+    }
+    else {
+        constexpr size_t N = tpa_tuple_size_v<state>;
+        return detail::newton_iterate(state(x0), tol, max_iter, [&](const state& x) {
+            const auto fx = detail::to_elems<U>(f(x));
+            const auto lu = lu_factor(mat<U, N>(df(x)));
+            const auto dx = lu_solve(lu, fx);
+            detail::lane_mask_t<U> zero = fx[0] == U(T(0));
+            detail::lane_mask_t<U> ok = !lu.singular;
+            for (size_t k = 0; k < N; ++k) {
+                zero = zero & (fx[k] == U(T(0)));
+                ok = ok & detail::root_finite(dx[k]);
+            }
+            return std::tuple{dx, zero, ok};
+        });
+    }
+}
+
+/**
+ * Halley's method for a scalar or batched f(x) = 0, with the first and second
+ * derivatives df and d2f: cubic convergence at simple roots. Convergence is
+ * tested as in newton.
+ */
+template<typename F, typename DF, typename D2F, typename U>
+    requires( not tuple_like<U> )
+root_result<U, U> halley(F&& f, DF&& df, D2F&& d2f, const U& x0,
+        const std::type_identity_t<U>& tol = detail::default_root_tol<U>(), size_t max_iter = 50) {
+    using T = max_type_t<U>;
+    return detail::newton_iterate(x0, tol, max_iter, [&](const U& x) {
+        const U fx = f(x);
+        const U d1 = df(x);
+        const U d2 = d2f(x);
+        const U dx = U(T(2)) * fx * d1 / detail::fma_elem(U(T(2)) * d1, d1, -fx * d2);
+        return std::tuple{dx, fx == U(T(0)), detail::root_finite(dx)};
+    });
+}
+
+/**
+ * Root of a scalar or batched f in the bracket [a, b] by the ITP method
+ * (interpolate, truncate, project) of Oliveira and Takahashi: bisection's
+ * worst case plus one iteration, with superlinear convergence on smooth
+ * functions. f(a) and f(b) must have opposite signs, or a lane is not
+ * converged; a lane converges when its bracket is at most 2 tol wide, and
+ * returns its midpoint. tol <= 0 selects a few ulps of max(|a|, |b|).
+ */
+template<typename F, typename U>
+    requires( not tuple_like<U> )
+root_result<U, U> itp(F&& f, U a, std::type_identity_t<U> b, std::type_identity_t<U> tol = U(0), size_t max_iter = 200) {
+    using T = max_type_t<U>;
+    using std::abs;
+    using std::min;
+    using std::max;
+    using std::ceil;
+    using std::log2;
+    using std::exp2;
+    using detail::lane_select;
+    const U zero(T(0)), one(T(1)), half(T(0.5));
+    const U lo = min(a, b);
+    b = max(a, b);
+    a = lo;
+    tol = lane_select<U>(tol > zero, tol,
+        U(T(4) * std::numeric_limits<T>::epsilon()) * max(max(abs(a), abs(b)), U(std::numeric_limits<T>::min())));
+    // Orient f so that it increases over the bracket.
+    U ya = f(a), yb = f(b);
+    const U s = lane_select<U>(ya > zero, -one, one);
+    ya = ya * s;
+    yb = yb * s;
+    detail::lane_mask_t<U> converged = (ya == zero) | (yb == zero);
+    a = lane_select<U>(yb == zero, b, a);
+    b = lane_select<U>(ya == zero, a, b);
+    detail::lane_mask_t<U> done = converged | !((ya <= zero) & (yb >= zero));
+
+    // k1 = 0.2 / (b - a), k2 = 2, n0 = 1.
+    const U k1 = U(T(0.2)) / (b - a);
+    U r_scale = tol * exp2(max(ceil(log2((b - a) / (U(T(2)) * tol))), zero) + one);
+    size_t it = 0;
+    converged = converged | ((!done) & (b - a <= U(T(2)) * tol));
+    done = done | converged;
+    while (not detail::all_lanes(done) and it < max_iter) {
+        const U w = b - a;
+        const U mid = half * (a + b);
+        const U r = max(r_scale - half * w, zero);
+        const U delta = k1 * w * w;
+        const U xf = (yb * a - ya * b) / (yb - ya);
+        const U sigma = lane_select<U>(mid >= xf, one, -one);
+        const U xt = lane_select<U>(delta <= abs(mid - xf), detail::fma_elem(sigma, delta, xf), mid);
+        const U x = lane_select<U>(abs(xt - mid) <= r, xt, detail::fma_elem(-sigma, r, mid));
+        const U y = f(x) * s;
+        const auto live = !done;
+        const auto hit = live & (y == zero);
+        const auto up = live & (y > zero);
+        const auto down = live & (y < zero);
+        b = lane_select<U>(up | hit, x, b);
+        yb = lane_select<U>(up, y, yb);
+        a = lane_select<U>(down | hit, x, a);
+        ya = lane_select<U>(down, y, ya);
+        r_scale = r_scale * half;
+        converged = converged | (live & (hit | (b - a <= U(T(2)) * tol)));
+        done = done | converged;
+        ++it;
+    }
+    return root_result<U, U>{half * (a + b), converged, it};
+}
+
+}
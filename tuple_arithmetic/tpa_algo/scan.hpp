@@ -0,0 +1,180 @@
+/**
+ * Bulk prefix sums over arrays of scalars, arrays of tuple-like records
+ * (per-component running totals) and column sets.
+ *
+ * With threads != 1, large inputs are scanned in two passes: every thread
+ * sums its chunk, the chunk totals are scanned serially, then every thread
+ * scans its chunk starting from its offset. Floating point results may then
+ * differ from the serial scan by rounding.
+ */
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "../tpa_simd/xsimd_permute.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Minimum number of elements per chunk in the parallel scan.
+    inline constexpr size_t scan_grain = size_t(1) << 15;
+
+    /**
+     * out[i] = carry + in[0] + ... + in[i] (Inclusive), or
+     * out[i] = carry + in[0] + ... + in[i-1], for i in [0, n).
+     * Returns carry + in[0] + ... + in[n-1]. in and out may alias.
+     */
+    template<bool Inclusive, typename U, typename T>
+    T scan_column(const U* in, T* out, size_t n, T carry) {
+        size_t i = 0;
+        if constexpr (simd_scalar<T> and simd_scalar<U>) {
+            using simd_t = xsimd::batch<T>;
+            constexpr size_t W = simd_t::size;
+            if (n >= W) {
+                simd_t c(carry);
+                for (; i + W <= n; i += W) {
+                    const auto s = inclusive_scan(simd_t::load_unaligned(in + i));
+                    if constexpr (Inclusive)
+                        (s + c).store_unaligned(out + i);
+                    else
+                        (xsimd::slide_left<sizeof(T)>(s) + c).store_unaligned(out + i);
+                    c += broadcast_lane<W - 1>(s);
+                }
+                carry = to_array(c)[0];
+            }
+        }
+        for (; i < n; ++i) {
+            const T v = in[i];
+            if constexpr (Inclusive) {
+                carry += v;
+                out[i] = carry;
+            }
+            else {
+                out[i] = carry;
+                carry += v;
+            }
+        }
+        return carry;
+    }
+
+    template<typename U, typename T>
+    T sum_column(const U* in, size_t n, T init) {
+        size_t i = 0;
+        if constexpr (simd_scalar<T> and simd_scalar<U>) {
+            using simd_t = xsimd::batch<T>;
+            constexpr size_t W = simd_t::size;
+            if (n >= W) {
+                simd_t acc(T(0));
+                for (; i + W <= n; i += W)
+                    acc += simd_t::load_unaligned(in + i);
+                init += xsimd::reduce_add(acc);
+            }
+        }
+        for (; i < n; ++i)
+            init += in[i];
+        return init;
+    }
+
+    // Tuple-like records: same contract as scan_column, the carry is a tuple (or a batch).
+    template<bool Inclusive, typename In, typename Out, typename Carry>
+    Carry scan_records(const In* in, Out* out, size_t n, Carry carry) {
+        for (size_t i = 0; i < n; ++i) {
+            if constexpr (Inclusive) {
+                carry = carry + in[i];
+                assign(out[i], carry);
+            }
+            else {
+                const Carry v = to_simd_deep(in[i]);
+                assign(out[i], carry);
+                carry = carry + v;
+            }
+        }
+        return carry;
+    }
+
+    template<typename In, typename Carry>
+    Carry sum_records(const In* in, size_t n, Carry acc) {
+        for (size_t i = 0; i < n; ++i)
+            acc = acc + in[i];
+        return acc;
+    }
+
+    /**
+     * scan(begin, end, carry) scans [begin, end) starting from carry,
+     * sum(begin, end) returns the sum of [begin, end).
+     */
+    template<typename Carry, typename Scan, typename Sum>
+    void two_pass_scan(size_t n, unsigned threads, const Carry& init, Scan&& scan, Sum&& sum) {
+        const size_t chunks = chunk_count(n, threads, scan_grain);
+        if (chunks == 1) {
+            scan(size_t(0), n, init);
+            return;
+        }
+        std::vector<Carry> offset(chunks, init);
+        parallel_chunks(n, threads, [&](size_t c, size_t begin, size_t end) {
+            offset[c] = sum(begin, end);
+        }, scan_grain);
+        Carry acc = init;
+        for (auto& off : offset) {
+            const Carry total = off;
+            off = acc;
+            acc = acc + total;
+        }
+        parallel_chunks(n, threads, [&](size_t c, size_t begin, size_t end) {
+            scan(begin, end, offset[c]);
+        }, scan_grain);
+    }
+
+    template<bool Inclusive, typename In, typename Out, typename Init>
+    void bulk_scan(In&& in, Out&& out, size_t n, Init&& init, unsigned threads) {
+        if constexpr (soa_columns<In>) {
+            static_assert(soa_columns<Out> and tpa_tuple_size_v<In> == tpa_tuple_size_v<Out>);
+            decltype(auto) ti = broadcast<In>(std::forward<Init>(init));
+            constexpr_for<0, std::tuple_size_v<std::remove_cvref_t<In>>, 1>([&](auto J) {
+                bulk_scan<Inclusive>(get<J>(in), get<J>(out), n, get<J>(ti), threads);
+            });
+        }
+        else {
+            using rec_t = std::remove_cvref_t<decltype(*in)>;
+            using out_t = std::remove_cvref_t<decltype(*out)>;
+            if constexpr (tuple_like<rec_t>) {
+                using carry_t = std::remove_cvref_t<decltype(to_simd_deep(std::declval<out_t>()))>;
+                carry_t carry, zero;
+                assign(carry, init);
+                assign(zero, 0);
+                two_pass_scan(n, threads, carry,
+                    [&](size_t b, size_t e, const carry_t& c) { scan_records<Inclusive>(in + b, out + b, e - b, c); },
+                    [&](size_t b, size_t e) { return sum_records(in + b, e - b, zero); });
+            }
+            else {
+                two_pass_scan(n, threads, out_t(init),
+                    [&](size_t b, size_t e, out_t c) { scan_column<Inclusive>(in + b, out + b, e - b, c); },
+                    [&](size_t b, size_t e) { return sum_column(in + b, e - b, out_t(0)); });
+            }
+        }
+    }
+
+    template<typename T>
+    concept scan_range = std::is_pointer_v<std::remove_cvref_t<T>> or soa_columns<T>;
+}
+
+// out[i] = in[0] + ... + in[i] for i in [0, n). in and out may alias.
+template<typename In, typename Out>
+    requires( detail::scan_range<In> and detail::scan_range<Out> )
+void inclusive_scan(In&& in, Out&& out, size_t n, unsigned threads = 1) {
+    detail::bulk_scan<true>(std::forward<In>(in), std::forward<Out>(out), n, 0, threads);
+}
+
+// out[i] = init + in[0] + ... + in[i-1] for i in [0, n). in and out may alias.
+template<typename In, typename Out, typename Init>
+    requires( detail::scan_range<In> and detail::scan_range<Out> )
+void exclusive_scan(In&& in, Out&& out, size_t n, Init&& init, unsigned threads = 1) {
+    detail::bulk_scan<false>(std::forward<In>(in), std::forward<Out>(out), n, std::forward<Init>(init), threads);
+}
+
+}
@@ -0,0 +1,82 @@
+/**
+ * Helpers for bulk kernels over column (SoA) storage.
+ *
+ * A column set is a tuple-like object of pointers, e.g.
+ * std::tuple<float*, double*> or std::array<float*, 3>.
+ * Record i of a column set is (get<0>(cols)[i], get<1>(cols)[i], ...).
+ */
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+
+#pragma once
+
+namespace tpa {
+
+// Scalar types with a native xsimd::batch.
+template<typename T>
+concept simd_scalar = std::is_arithmetic_v<T> and
+    not std::is_same_v<T, bool> and not std::is_same_v<T, char> and not std::is_same_v<T, long double>;
+
+template<typename T>
+concept column_pointer =
+    std::is_pointer_v<std::remove_cvref_t<T>> and
+    std::is_arithmetic_v<std::remove_cv_t<std::remove_pointer_t<std::remove_cvref_t<T>>>>;
+
+template<typename T>
+concept soa_columns = tuple_like<T> and
+    []<size_t...I>(std::index_sequence<I...>) {
+        return (column_pointer<std::tuple_element_t<I, std::remove_cvref_t<T>>> && ...);
+    }(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<T>>>{});
+
+// Value type of a column pointer, or of the first column in a column set.
+template<typename T> struct column_value { using type = std::remove_cv_t<std::remove_pointer_t<std::remove_cvref_t<T>>>; };
+template<soa_columns T> struct column_value<T> : column_value<std::tuple_element_t<0, std::remove_cvref_t<T>>> {};
+template<typename T> using column_value_t = typename column_value<T>::type;
+
+namespace detail {
+    template<typename U>
+    FORCE_INLINE lane_mask_t<U> no_lanes() { return U(0) != U(0); }
+
+    template<typename M>
+    FORCE_INLINE bool all_lanes(const M& m) {
+        if constexpr (std::is_same_v<M, bool>)
+            return m;
+        else
+            return xsimd::all(m);
+    }
+}
+
+// (p1, p2, ...), i -> (p1[i], p2[i], ...)
+template<soa_columns Cols>
+FORCE_INLINE constexpr auto load_record(Cols&& cols, size_t i) {
+    return apply_unary_op([i](auto&& p) { return p[i]; }, std::forward<Cols>(cols));
+}
+
+// (p1, p2, ...), i, (v1, v2, ...) -> p1[i] = v1, p2[i] = v2, ...
+template<soa_columns Cols, typename Rec>
+FORCE_INLINE constexpr void store_record(Cols&& cols, size_t i, Rec&& rec) {
+    decltype(auto) tr = detail::broadcast<Cols>(std::forward<Rec>(rec));
+    constexpr_for<0, std::tuple_size_v<std::remove_cvref_t<Cols>>, 1>([&](auto I) {
+        get<I>(cols)[i] = get<I>(tr);
+    });
+}
+
+// (p1, p2, ...), i -> (simd_t(p1 + i), simd_t(p2 + i), ...), converted to simd_t's value type.
+template<typename simd_t, soa_columns Cols>
+FORCE_INLINE auto load_columns(Cols&& cols, size_t i) {
+    return apply_unary_op([i](auto&& p) { return simd_t::load_unaligned(p + i); }, std::forward<Cols>(cols));
+}
+
+// (p1, p2, ...), i, (b1, b2, ...) -> store b1 at p1 + i, b2 at p2 + i, ...
+template<soa_columns Cols, tuple_like Vals>
+FORCE_INLINE void store_columns(Cols&& cols, size_t i, Vals&& vals) {
+    constexpr_for<0, std::tuple_size_v<std::remove_cvref_t<Cols>>, 1>([&](auto I) {
+        get<I>(vals).store_unaligned(get<I>(cols) + i);
+    });
+}
+
+}
@@ -0,0 +1,339 @@
+/**
+ * Small dense linear solvers, for many independent systems at once.
+ *
+ * The factorizations work on tpa::mat<U, R, C> where U is a floating point
+ * scalar or an xsimd batch; a matrix of batches holds one system per lane.
+ * They are branch-free: instead of stopping at a zero pivot, every lane
+ * reports whether its system is singular in a mask (bool, or batch_bool for
+ * batches). In singular lanes the offending pivot is replaced by 1, so
+ * results stay finite but are meaningless.
+ *
+ * A pivot counts as zero when its magnitude is at most
+ * max(R, C) * epsilon * max |a_ij|.
+ *
+ * solve_systems<S>(a, b, x, n) solves n systems stored in column sets (see
+ * soa.hpp), a batch of systems at a time.
+ */
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    template<typename U, size_t R, size_t C>
+    FORCE_INLINE U pivot_tolerance(const mat<U, R, C>& a) {
+        using std::abs;
+        using std::max;
+        using T = max_type_t<U>;
+        U m = abs(a[0][0]);
+        for (size_t i = 0; i < R; ++i)
+            for (size_t j = 0; j < C; ++j)
+                m = max(m, abs(a[i][j]));
+        return m * U(T(std::max(R, C)) * std::numeric_limits<T>::epsilon());
+    }
+
+    // Solve U x = y in place, U upper triangular.
+    template<typename U, size_t R, size_t C, size_t N>
+    FORCE_INLINE void back_substitute(const mat<U, R, C>& u, std::array<U, N>& y) {
+        for (size_t i = N; i-- > 0;) {
+            U s = y[i];
+            for (size_t j = i + 1; j < N; ++j)
+                s = detail::fma_elem(-u[i][j], y[j], s);
+            y[i] = s / u[i][i];
+        }
+    }
+}
+
+// P A = L U with partial pivoting. L has a unit diagonal and is stored below the
+// diagonal of lu, U on and above it.
+template<typename U, size_t N>
+struct lu_factorization {
+    mat<U, N> lu;
+    // At step k, row k was swapped with row pivots[k] (>= k), stored as a value of U.
+    std::array<U, N> pivots;
+    detail::lane_mask_t<U> singular;
+};
+
+// A = L L^T for symmetric positive definite A; singular flags lanes that are not.
+template<typename U, size_t N>
+struct cholesky_factorization {
+    mat<U, N> l;
+    detail::lane_mask_t<U> singular;
+};
+
+// A = Q R for an M x N matrix with M >= N, by Householder reflections. R is stored
+// on and above the diagonal of qr; the reflection vectors, with an implicit leading 1,
+// below it. H_k = I - tau[k] v_k v_k^T and Q = H_0 H_1 ... H_{N-1}.
+template<typename U, size_t M, size_t N>
+struct qr_factorization {
+    mat<U, M, N> qr;
+    std::array<U, N> tau;
+    detail::lane_mask_t<U> singular;
+};
+
+template<typename U, size_t N>
+lu_factorization<U, N> lu_factor(const mat<U, N>& a) {
+    using std::abs;
+    using detail::lane_select;
+    using T = max_type_t<U>;
+    lu_factorization<U, N> f{a, {}, detail::no_lanes<U>()};
+    auto& lu = f.lu;
+    const U tol = detail::pivot_tolerance(a);
+    for (size_t k = 0; k < N; ++k) {
+        U best = abs(lu[k][k]);
+        U p = U(T(k));
+        for (size_t i = k + 1; i < N; ++i) {
+            const U v = abs(lu[i][k]);
+            const auto c = v > best;
+            best = lane_select<U>(c, v, best);
+            p = lane_select<U>(c, U(T(i)), p);
+        }
+        f.pivots[k] = p;
+        for (size_t i = k + 1; i < N; ++i) {
+            const auto swap = p == U(T(i));
+            for (size_t j = 0; j < N; ++j) {
+                const U t = lu[k][j];
+                lu[k][j] = lane_select<U>(swap, lu[i][j], t);
+                lu[i][j] = lane_select<U>(swap, t, lu[i][j]);
+            }
+        }
+        const auto zero = best <= tol;
+        f.singular = f.singular | zero;
+        lu[k][k] = lane_select<U>(zero, U(T(1)), lu[k][k]);
+        const U r = U(T(1)) / lu[k][k];
+        for (size_t i = k + 1; i < N; ++i) {
+            const U l = lu[i][k] * r;
+            lu[i][k] = l;
+            for (size_t j = k + 1; j < N; ++j)
+                lu[i][j] = detail::fma_elem(-l, lu[k][j], lu[i][j]);
+        }
+    }
+    return f;
+}
+
+template<typename U, size_t N>
+std::array<U, N> lu_solve(const lu_factorization<U, N>& f, std::array<U, N> b) {
+    using T = max_type_t<U>;
+    for (size_t k = 0; k < N; ++k)
+        for (size_t i = k + 1; i < N; ++i) {
+            const auto swap = f.pivots[k] == U(T(i));
+            const U t = b[k];
+            b[k] = detail::lane_select<U>(swap, b[i], t);
+            b[i] = detail::lane_select<U>(swap, t, b[i]);
+        }
+    for (size_t i = 1; i < N; ++i)
+        for (size_t j = 0; j < i; ++j)
+            b[i] = detail::fma_elem(-f.lu[i][j], b[j], b[i]);
+    detail::back_substitute(f.lu, b);
+    return b;
+}
+
+template<typename U, size_t N>
+cholesky_factorization<U, N> cholesky_factor(const mat<U, N>& a) {
+    using std::sqrt;
+    using T = max_type_t<U>;
+    cholesky_factorization<U, N> f{{}, detail::no_lanes<U>()};
+    auto& l = f.l;
+    const U tol = detail::pivot_tolerance(a);
+    for (size_t j = 0; j < N; ++j) {
+        U d = a[j][j];
+        for (size_t k = 0; k < j; ++k)
+            d = detail::fma_elem(-l[j][k], l[j][k], d);
+        const auto bad = d <= tol;
+        f.singular = f.singular | bad;
+        l[j][j] = sqrt(detail::lane_select<U>(bad, U(T(1)), d));
+        const U r = U(T(1)) / l[j][j];
+        for (size_t i = j + 1; i < N; ++i) {
+            U s = a[i][j];
+            for (size_t k = 0; k < j; ++k)
+                s = detail::fma_elem(-l[i][k], l[j][k], s);
+            l[i][j] = s * r;
+            l[j][i] = U(T(0));
+        }
+    }
+    return f;
+}
+
+template<typename U, size_t N>
+std::array<U, N> cholesky_solve(const cholesky_factorization<U, N>& f, std::array<U, N> b) {
+    const auto& l = f.l;
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < i; ++j)
+            b[i] = detail::fma_elem(-l[i][j], b[j], b[i]);
+        b[i] = b[i] / l[i][i];
+    }
+    for (size_t i = N; i-- > 0;) {
+        for (size_t j = i + 1; j < N; ++j)
+            b[i] = detail::fma_elem(-l[j][i], b[j], b[i]);
+        b[i] = b[i] / l[i][i];
+    }
+    return b;
+}
+
+template<typename U, size_t M, size_t N>
+qr_factorization<U, M, N> qr_factor(const mat<U, M, N>& a) {
+    static_assert(M >= N, "qr_factor: the matrix must have at least as many rows as columns");
+    using std::sqrt;
+    using std::abs;
+    using detail::lane_select;
+    using T = max_type_t<U>;
+    qr_factorization<U, M, N> f{a, {}, detail::no_lanes<U>()};
+    auto& qr = f.qr;
+    const U tol = detail::pivot_tolerance(a);
+    for (size_t k = 0; k < N; ++k) {
+        const U x0 = qr[k][k];
+        U s = U(T(0));
+        for (size_t i = k + 1; i < M; ++i)
+            s = detail::fma_elem(qr[i][k], qr[i][k], s);
+        // beta = -sign(x0) |x|; no reflection for a column that is already zero below the diagonal.
+        const U norm = sqrt(detail::fma_elem(x0, x0, s));
+        const auto flat = s == U(T(0));
+        const U one = U(T(1));
+        const U beta = lane_select<U>(flat, x0, lane_select<U>(x0 >= U(T(0)), -norm, norm));
+        const U tau = lane_select<U>(flat, U(T(0)), (beta - x0) / lane_select<U>(flat, one, beta));
+        const U scale = lane_select<U>(flat, U(T(0)), one / lane_select<U>(flat, one, x0 - beta));
+        f.tau[k] = tau;
+        for (size_t i = k + 1; i < M; ++i)
+            qr[i][k] = qr[i][k] * scale;
+        for (size_t j = k + 1; j < N; ++j) {
+            U w = qr[k][j];
+            for (size_t i = k + 1; i < M; ++i)
+                w = detail::fma_elem(qr[i][k], qr[i][j], w);
+            w = w * tau;
+            qr[k][j] = qr[k][j] - w;
+            for (size_t i = k + 1; i < M; ++i)
+                qr[i][j] = detail::fma_elem(-qr[i][k], w, qr[i][j]);
+        }
+        const auto zero = abs(beta) <= tol;
+        f.singular = f.singular | zero;
+        qr[k][k] = lane_select<U>(zero, U(T(1)), beta);
+    }
+    return f;
+}
+
+// Least squares solution of A x = b (the exact solution for square A).
+template<typename U, size_t M, size_t N>
+std::array<U, N> qr_solve(const qr_factorization<U, M, N>& f, std::array<U, M> b) {
+    const auto& qr = f.qr;
+    for (size_t k = 0; k < N; ++k) {
+        U w = b[k];
+        for (size_t i = k + 1; i < M; ++i)
+            w = detail::fma_elem(qr[i][k], b[i], w);
+        w = w * f.tau[k];
+        b[k] = b[k] - w;
+        for (size_t i = k + 1; i < M; ++i)
+            b[i] = detail::fma_elem(-qr[i][k], w, b[i]);
+    }
+    std::array<U, N> x;
+    for (size_t i = 0; i < N; ++i)
+        x[i] = b[i];
+    detail::back_substitute(qr, x);
+    return x;
+}
+
+enum class solver {
+    lu,        // partial pivoting
+    cholesky,  // symmetric positive definite matrices, only the lower triangle is read
+    qr,        // Householder, least squares for overdetermined systems
+};
+
+namespace detail {
+    // Minimum number of systems per chunk in threaded solves.
+    inline constexpr size_t solve_grain = size_t(1) << 10;
+
+    template<solver S, typename U, size_t M, size_t N>
+    FORCE_INLINE auto solve_one(const mat<U, M, N>& a, const std::array<U, M>& b) {
+        if constexpr (S == solver::lu) {
+            const auto f = lu_factor(a);
+            return std::pair{lu_solve(f, b), f.singular};
+        }
+        else if constexpr (S == solver::cholesky) {
+            const auto f = cholesky_factor(a);
+            return std::pair{cholesky_solve(f, b), f.singular};
+        }
+        else {
+            const auto f = qr_factor(a);
+            return std::pair{qr_solve(f, b), f.singular};
+        }
+    }
+
+    template<solver S, typename simd_t, typename T, size_t M, size_t N, typename A, typename B, typename X>
+    size_t solve_range(A&& a, B&& b, X&& x, bool* singular, size_t begin, size_t end) {
+        size_t count = 0;
+        size_t i = begin;
+        if constexpr (not std::is_same_v<simd_t, void>) {
+            constexpr size_t W = simd_t::size;
+            for (; i + W <= end; i += W) {
+                const auto ac = load_columns<simd_t>(a, i);
+                const auto bc = load_columns<simd_t>(b, i);
+                mat<simd_t, M, N> am;
+                std::array<simd_t, M> bv;
+                constexpr_for<0, M, 1>([&](auto R) {
+                    constexpr_for<0, N, 1>([&](auto C) { am[R][C] = get<R * N + C>(ac); });
+                    bv[R] = get<R>(bc);
+                });
+                const auto [xv, bad] = solve_one<S>(am, bv);
+                store_columns(x, i, xv);
+                const auto bits = bad.mask();
+                count += size_t(std::popcount(uint64_t(bits)));
+                if (singular)
+                    for (size_t l = 0; l < W; ++l)
+                        singular[i + l] = (bits >> l) & 1;
+            }
+        }
+        for (; i < end; ++i) {
+            mat<T, M, N> am;
+            std::array<T, M> bv;
+            constexpr_for<0, M, 1>([&](auto R) {
+                constexpr_for<0, N, 1>([&](auto C) { am[R][C] = T(get<R * N + C>(a)[i]); });
+                bv[R] = T(get<R>(b)[i]);
+            });
+            const auto [xv, bad] = solve_one<S>(am, bv);
+            store_record(x, i, xv);
+            count += bad;
+            if (singular)
+                singular[i] = bad;
+        }
+        return count;
+    }
+}
+
+/**
+ * Solve A_i x_i = b_i for i in [0, n). The matrix elements are the M * N columns
+ * of a in row-major order, b has M columns and x has N columns. M == N except
+ * for least squares with solver::qr. If singular is not null, singular[i] tells
+ * whether system i was singular. Returns the number of singular systems.
+ */
+template<solver S, soa_columns A, soa_columns B, soa_columns X>
+size_t solve_systems(A&& a, B&& b, X&& x, size_t n, bool* singular = nullptr, unsigned threads = 1) {
+    constexpr size_t M = tpa_tuple_size_v<B>;
+    constexpr size_t N = tpa_tuple_size_v<X>;
+    static_assert(tpa_tuple_size_v<A> == M * N, "solve_systems: a must have one column per matrix element");
+    static_assert(S == solver::qr or M == N, "solve_systems: only solver::qr handles non-square systems");
+    using T = column_value_t<X>;
+    static_assert(std::is_floating_point_v<T>, "solve_systems: solutions must be floating point");
+    using simd_t = std::conditional_t<simd_scalar<T>, xsimd::batch<T>, void>;
+    std::vector<size_t> counts(chunk_count(n, threads, detail::solve_grain), 0);
+    parallel_chunks(n, threads, [&](size_t c, size_t begin, size_t end) {
+        counts[c] = detail::solve_range<S, simd_t, T, M, N>(a, b, x, singular, begin, end);
+    }, detail::solve_grain);
+    size_t count = 0;
+    for (size_t c : counts)
+        count += c;
+    return count;
+}
+
+}
@@ -0,0 +1,285 @@
+/**
+ * Piecewise polynomial curves with tuple-like control points: Bézier splines
+ * and uniform B-splines of any degree, and arc length tables.
+ *
+ * Curves are parametrized by t in [0, 1] over all of their segments. The
+ * parameter is a scalar, or a batch with one parameter per lane: the control
+ * points of every lane's segment are then gathered, so a batch of points on
+ * different segments is evaluated at once. Basis weights are built with the
+ * de Casteljau and Cox-de Boor recurrences, one fma per weight.
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+
+#pragma once
+
+namespace tpa {
+
+enum class spline_basis {
+    bezier,  // segments of Degree + 1 control points, consecutive segments share one
+    bspline, // uniform B-spline, consecutive segments share Degree control points
+};
+
+namespace detail {
+    // Minimum number of parameters per chunk in threaded sampling.
+    inline constexpr size_t spline_grain = size_t(1) << 12;
+
+    template<typename T>
+    using spline_value_t = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+    template<typename U> struct spline_index { using type = std::ptrdiff_t; };
+    template<typename T, typename A> struct spline_index<xsimd::batch<T, A>> {
+        using type = xsimd::batch<xsimd::as_integer_t<T>, A>;
+    };
+
+    // Weights w of the Degree + 1 control points of a segment at local
+    // parameter u in [0, 1], and weights dw of their derivative along u.
+    template<spline_basis B, size_t P, typename U>
+    FORCE_INLINE void spline_weights(const U& u, std::array<U, P + 1>& w, std::array<U, P + 1>& dw) {
+        using T = max_type_t<U>;
+        const U v = U(T(1)) - u;
+        w.fill(U(T(0)));
+        w[0] = U(T(1));
+        for (size_t k = 1; k <= P; ++k) {
+            if (k == P) {
+                // Differences of the weights of degree P - 1; the Bernstein ones scale by P.
+                const U s = U(T(B == spline_basis::bezier ? P : 1));
+                dw[0] = -w[0] * s;
+                for (size_t j = 1; j <= P; ++j)
+                    dw[j] = (w[j - 1] - w[j]) * s;
+            }
+            // Degree k from degree k - 1, in place from the top; w[k] is still 0.
+            for (size_t j = k; j > 0; --j) {
+                if constexpr (B == spline_basis::bezier)
+                    w[j] = fma_elem(u, w[j - 1], v * w[j]);
+                else
+                    w[j] = fma_elem(u + U(T(k - j)), w[j - 1], (v + U(T(j))) * w[j]) * U(T(1) / T(k));
+            }
+            if constexpr (B == spline_basis::bezier)
+                w[0] = v * w[0];
+            else
+                w[0] = v * w[0] * U(T(1) / T(k));
+        }
+    }
+
+    // Linear interpolation in a table of samples at x = 0, 1, ..., clamped.
+    template<typename U, typename T>
+    FORCE_INLINE U table_lerp(const std::vector<T>& table, U x) {
+        using std::min;
+        using std::max;
+        using std::floor;
+        const T last = T(table.size() - 1);
+        x = min(max(x, U(T(0))), U(last));
+        const U i = min(floor(x), U(last - T(1)));
+        const U f = x - i;
+        if constexpr (std::is_arithmetic_v<U>) {
+            const size_t k = size_t(i);
+            return fma_elem(f, table[k + 1] - table[k], table[k]);
+        }
+        else {
+            using ib_t = typename spline_index<U>::type;
+            const ib_t k = xsimd::batch_cast<typename ib_t::value_type>(i);
+            const U a = U::gather(table.data(), k);
+            const U b = U::gather(table.data() + 1, k);
+            return fma_elem(f, b - a, a);
+        }
+    }
+}
+
+/**
+ * Curve of Degree through the control points of type Point, with basis B.
+ * A Bézier spline of n control points has (n - 1) / Degree segments, and a
+ * uniform B-spline n - Degree; extra points are ignored, and a curve without
+ * segments must not be evaluated. Segment s covers t in [s / m, (s + 1) / m]
+ * for m segments. Coordinates are stored in the common type of Point, or
+ * double for integer points.
+ */
+template<tuple_like Point, spline_basis B, size_t Degree = 3>
+class spline {
+    static_assert(Degree >= 1, "spline: degree must be at least 1");
+    public:
+        static constexpr size_t dim = tpa_tuple_size_v<Point>;
+        static constexpr size_t degree = Degree;
+        using value_type = detail::spline_value_t<tuple_common_t<Point>>;
+        using point_type = std::array<value_type, dim>;
+
+        spline() = default;
+
+        spline(const Point* points, size_t n) : m_points(n) {
+            for (size_t i = 0; i < n; ++i)
+                m_points[i] = detail::to_elems<value_type>(points[i]);
+            if constexpr (B == spline_basis::bezier)
+                m_segments = n == 0 ? 0 : (n - 1) / Degree;
+            else
+                m_segments = n > Degree ? n - Degree : 0;
+        }
+
+        size_t size() const { return m_points.size(); }
+        size_t segments() const { return m_segments; }
+        const point_type& control_point(size_t i) const { return m_points[i]; }
+
+        // Point at t, for t a scalar or a batch of value_type; t is clamped to [0, 1].
+        template<typename U>
+        FORCE_INLINE std::array<U, dim> operator()(const U& t) const { return eval<false>(t); }
+
+        // Derivative with respect to t.
+        template<typename U>
+        FORCE_INLINE std::array<U, dim> derivative(const U& t) const { return eval<true>(t); }
+
+        // Points at t[0..n) stored to a column set of dim columns, a batch at a time.
+        template<soa_columns C>
+            requires( tpa_tuple_size_v<C> == dim )
+        void sample(const value_type* t, size_t n, const C& out, unsigned threads = 1) const {
+            sample_impl<false>(t, n, out, threads);
+        }
+
+        template<soa_columns C>
+            requires( tpa_tuple_size_v<C> == dim )
+        void sample_derivative(const value_type* t, size_t n, const C& out, unsigned threads = 1) const {
+            sample_impl<true>(t, n, out, threads);
+        }
+
+    private:
+        static constexpr size_t step = B == spline_basis::bezier ? Degree : 1;
+
+        std::vector<point_type> m_points;
+        size_t m_segments = 0;
+
+        template<bool Deriv, typename U>
+        FORCE_INLINE std::array<U, dim> eval(const U& t) const {
+            using T = value_type;
+            using std::min;
+            using std::max;
+            using std::floor;
+            static_assert(std::is_same_v<max_type_t<U>, T>, "spline: parameters must have the value type of the curve");
+            const T m = T(m_segments);
+            const U x = min(max(t, U(T(0))), U(T(1))) * U(m);
+            const U s = min(floor(x), U(m - T(1)));
+            std::array<U, Degree + 1> w, dw;
+            detail::spline_weights<B, Degree>(x - s, w, dw);
+            if constexpr (Deriv)
+                for (auto& d : dw)
+                    d = d * U(m);
+            const auto& c = Deriv ? dw : w;
+
+            std::array<U, dim> ret;
+            if constexpr (std::is_arithmetic_v<U>) {
+                const point_type* p = m_points.data() + size_t(s) * step;
+                constexpr_for<0, dim, 1>([&](auto K) {
+                    U acc = c[0] * p[0][K];
+                    for (size_t j = 1; j <= Degree; ++j)
+                        acc = detail::fma_elem(c[j], p[j][K], acc);
+                    ret[K] = acc;
+                });
+            }
+            else {
+                using ib_t = typename detail::spline_index<U>::type;
+                using int_t = typename ib_t::value_type;
+                const ib_t idx = xsimd::batch_cast<int_t>(s) * ib_t(int_t(step * dim));
+                const T* base = m_points.data()->data();
+                ret.fill(U(T(0)));
+                for (size_t j = 0; j <= Degree; ++j)
+                    constexpr_for<0, dim, 1>([&](auto K) {
+                        ret[K] = detail::fma_elem(c[j], U::gather(base + j * dim + K, idx), ret[K]);
+                    });
+            }
+            return ret;
+        }
+
+        template<bool Deriv, typename C>
+        void sample_impl(const value_type* t, size_t n, const C& out, unsigned threads) const {
+            parallel_chunks(n, threads, [&](size_t, size_t begin, size_t end) {
+                size_t i = begin;
+                if constexpr (simd_scalar<value_type>) {
+                    using simd_t = xsimd::batch<value_type>;
+                    constexpr size_t W = simd_t::size;
+                    for (; i + W <= end; i += W)
+                        store_columns(out, i, eval<Deriv>(simd_t::load_unaligned(t + i)));
+                }
+                for (; i < end; ++i)
+                    store_record(out, i, eval<Deriv>(t[i]));
+            }, detail::spline_grain);
+        }
+};
+
+template<tuple_like Point, size_t Degree = 3>
+using bezier_spline = spline<Point, spline_basis::bezier, Degree>;
+
+template<tuple_like Point, size_t Degree = 3>
+using bspline = spline<Point, spline_basis::bspline, Degree>;
+
+/**
+ * Arc length of a curve as a function of its parameter, and its inverse, in
+ * tables over `intervals` equal steps. Each step is integrated with 5-point
+ * Gauss-Legendre quadrature of the speed; lookups interpolate linearly.
+ */
+template<typename T>
+class arc_length_table {
+    public:
+        using value_type = T;
+
+        arc_length_table() = default;
+
+        template<typename Curve>
+        explicit arc_length_table(const Curve& curve, size_t intervals = 256) :
+            m_s(std::max<size_t>(intervals, 1) + 1), m_t(m_s.size()) {
+            static constexpr std::array<double, 5> x{
+                -0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831, 0.9061798459386640 };
+            static constexpr std::array<double, 5> wq{
+                0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665, 0.2369268850561891 };
+            const size_t m = m_s.size() - 1;
+            const T h = T(1) / T(m);
+            m_s[0] = T(0);
+            for (size_t i = 0; i < m; ++i) {
+                T acc = T(0);
+                for (size_t q = 0; q < 5; ++q) {
+                    const auto d = curve.derivative(h * (T(i) + T(0.5 * (x[q] + 1))));
+                    acc += T(wq[q]) * std::sqrt(dot(d, d));
+                }
+                m_s[i + 1] = m_s[i] + acc * h / T(2);
+            }
+            // t at equal steps of length, by a sweep over the intervals.
+            size_t i = 0;
+            for (size_t k = 0; k <= m; ++k) {
+                const T s = m_s[m] * T(k) / T(m);
+                while (i + 1 < m and m_s[i + 1] < s)
+                    ++i;
+                const T ds = m_s[i + 1] - m_s[i];
+                const T f = ds > T(0) ? std::clamp((s - m_s[i]) / ds, T(0), T(1)) : T(0);
+                m_t[k] = (T(i) + f) * h;
+            }
+        }
+
+        size_t intervals() const { return m_s.size() - 1; }
+        T length() const { return m_s.back(); }
+
+        // Length of the curve from 0 to t, for t a scalar or a batch.
+        template<typename U>
+        FORCE_INLINE U length_at(const U& t) const {
+            return detail::table_lerp(m_s, t * U(T(intervals())));
+        }
+
+        // Parameter at which the length from 0 is s, clamped to [0, length()].
+        template<typename U>
+        FORCE_INLINE U param_at(const U& s) const {
+            const T l = length();
+            return detail::table_lerp(m_t, s * U(l > T(0) ? T(intervals()) / l : T(0)));
+        }
+
+    private:
+        std::vector<T> m_s; // length at t = i / intervals
+        std::vector<T> m_t; // t at length = i * length / intervals
+};
+
+template<typename Curve>
+arc_length_table(const Curve&, size_t = 256) -> arc_length_table<typename Curve::value_type>;
+
+}
@@ -0,0 +1,221 @@
+/**
+ * Streaming statistics of tuple records: count, mean, variance, minimum,
+ * maximum and, optionally, covariance of every component, in one pass.
+ *
+ * Records are accumulated with Welford's update, component by component, and
+ * accumulators are combined with the pairwise formulas of Chan et al., which
+ * are exact up to rounding. A batch of records keeps one accumulator per lane,
+ * so bulk updates run a batch of records at a time; the lanes are merged when
+ * the batch accumulator is folded in.
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+#include "neighbors.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Minimum number of records per chunk in threaded updates.
+    inline constexpr size_t stats_grain = size_t(1) << 12;
+
+    template<typename T>
+    using stats_value_t = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+    // Welford accumulator of D components over the lanes of U, all lanes
+    // holding the same number of records.
+    template<typename U, size_t D, bool Cov>
+    struct welford {
+        using T = max_type_t<U>;
+
+        size_t count = 0;
+        std::array<U, D> mean, m2, lo, hi;
+        std::array<std::array<U, D>, Cov ? D : 0> cov;
+
+        welford() {
+            constexpr_for<0, D, 1>([&](auto K) {
+                mean[K] = U(T(0));
+                m2[K] = U(T(0));
+                lo[K] = U(std::numeric_limits<T>::infinity());
+                hi[K] = U(-std::numeric_limits<T>::infinity());
+                if constexpr (Cov)
+                    constexpr_for<0, D, 1>([&](auto J) { cov[K][J] = U(T(0)); });
+            });
+        }
+
+        void push(const std::array<U, D>& x) {
+            using std::min;
+            using std::max;
+            ++count;
+            const U inv(T(1) / T(count));
+            std::array<U, D> d, e;
+            constexpr_for<0, D, 1>([&](auto K) {
+                d[K] = x[K] - mean[K];
+                mean[K] = fma_elem(d[K], inv, mean[K]);
+                e[K] = x[K] - mean[K];
+                m2[K] = fma_elem(d[K], e[K], m2[K]);
+                lo[K] = min(lo[K], x[K]);
+                hi[K] = max(hi[K], x[K]);
+            });
+            if constexpr (Cov)
+                constexpr_for<0, D, 1>([&](auto I) {
+                    constexpr_for<0, D, 1>([&](auto J) { cov[I][J] = fma_elem(d[I], e[J], cov[I][J]); });
+                });
+        }
+
+        // Chan's update: this becomes the accumulator of the records of both.
+        // Scalar accumulators only; the vectors are updated with tuple operators.
+        void merge(const welford& b) {
+            if (b.count == 0)
+                return;
+            if (count == 0) {
+                *this = b;
+                return;
+            }
+            const T n = T(count + b.count);
+            const T f = T(b.count) / n;
+            const T g = T(count) * f;
+            const auto delta = b.mean - mean;
+            mean = mean + delta * f;
+            m2 = m2 + b.m2 + delta * delta * g;
+            lo = min(lo, b.lo);
+            hi = max(hi, b.hi);
+            if constexpr (Cov)
+                constexpr_for<0, D, 1>([&](auto I) { cov[I] = cov[I] + b.cov[I] + delta * (delta[I] * g); });
+            count += b.count;
+        }
+
+        // The lanes of a batch accumulator merged into a scalar one.
+        template<typename B>
+        static welford lanes_merged(const welford<B, D, Cov>& acc) {
+            constexpr size_t W = B::size;
+            std::array<std::array<T, W>, D> mean, m2, lo, hi;
+            std::array<std::array<std::array<T, W>, D>, Cov ? D : 0> cov;
+            constexpr_for<0, D, 1>([&](auto K) {
+                acc.mean[K].store_unaligned(mean[K].data());
+                acc.m2[K].store_unaligned(m2[K].data());
+                acc.lo[K].store_unaligned(lo[K].data());
+                acc.hi[K].store_unaligned(hi[K].data());
+                if constexpr (Cov)
+                    constexpr_for<0, D, 1>([&](auto J) { acc.cov[K][J].store_unaligned(cov[K][J].data()); });
+            });
+            welford ret;
+            for (size_t l = 0; l < W; ++l) {
+                welford w;
+                w.count = acc.count;
+                for (size_t k = 0; k < D; ++k) {
+                    w.mean[k] = mean[k][l];
+                    w.m2[k] = m2[k][l];
+                    w.lo[k] = lo[k][l];
+                    w.hi[k] = hi[k][l];
+                    if constexpr (Cov)
+                        for (size_t j = 0; j < D; ++j)
+                            w.cov[k][j] = cov[k][j][l];
+                }
+                ret.merge(w);
+            }
+            return ret;
+        }
+    };
+}
+
+/**
+ * Mergeable one-pass statistics of records of type Tuple, with the covariance
+ * matrix of the components if Covariance. Statistics are computed in the
+ * common type of Tuple, or double for integer records.
+ */
+template<tuple_like Tuple, bool Covariance = false>
+class running_stats {
+    public:
+        static constexpr size_t dim = tpa_tuple_size_v<Tuple>;
+        using value_type = detail::stats_value_t<tuple_common_t<Tuple>>;
+        using vector_type = std::array<value_type, dim>;
+
+        running_stats() = default;
+
+        // Add a record, or a record of batches holding one record per lane.
+        template<tuple_like R>
+            requires( tpa_tuple_size_v<R> == dim and not soa_columns<R> )
+        void push(const R& x) {
+            using U = std::remove_cvref_t<tuple_max_type_t<R>>;
+            if constexpr (std::is_arithmetic_v<U>)
+                m_acc.push(detail::to_elems<value_type>(x));
+            else {
+                static_assert(std::is_same_v<max_type_t<U>, value_type>, "running_stats: batch type mismatch");
+                detail::welford<U, dim, Covariance> acc;
+                acc.push(detail::to_elems<U>(x));
+                m_acc.merge(acc_type::lanes_merged(acc));
+            }
+        }
+
+        // Add records [0, n) of a column set, a batch of records at a time.
+        // Chunks of records are accumulated on their own threads and merged in order.
+        template<soa_columns C>
+            requires( tpa_tuple_size_v<C> == dim )
+        void push(const C& cols, size_t n, unsigned threads = 1) {
+            std::vector<acc_type> parts(chunk_count(n, threads, detail::stats_grain));
+            parallel_chunks(n, threads, [&](size_t c, size_t begin, size_t end) {
+                size_t j = begin;
+                if constexpr (simd_scalar<value_type>) {
+                    using simd_t = xsimd::batch<value_type>;
+                    constexpr size_t W = simd_t::size;
+                    if (j + W <= end) {
+                        detail::welford<simd_t, dim, Covariance> acc;
+                        for (; j + W <= end; j += W)
+                            acc.push(detail::load_point<simd_t>(cols, j));
+                        parts[c] = acc_type::lanes_merged(acc);
+                    }
+                }
+                for (; j < end; ++j)
+                    parts[c].push(detail::load_point<value_type>(cols, j));
+            }, detail::stats_grain);
+            for (const auto& p : parts)
+                m_acc.merge(p);
+        }
+
+        // Add the records of another accumulator.
+        void merge(const running_stats& other) { m_acc.merge(other.m_acc); }
+
+        size_t count() const { return m_acc.count; }
+        const vector_type& mean() const { return m_acc.mean; }
+        // Componentwise minimum and maximum; +inf and -inf when empty.
+        const vector_type& min() const { return m_acc.lo; }
+        const vector_type& max() const { return m_acc.hi; }
+
+        // Sum of squared deviations divided by count - ddof: the population
+        // variance for ddof = 0, the sample variance for ddof = 1.
+        vector_type variance(size_t ddof = 0) const {
+            return m_acc.m2 / value_type(value_type(m_acc.count) - value_type(ddof));
+        }
+
+        vector_type stddev(size_t ddof = 0) const {
+            vector_type ret = variance(ddof);
+            for (auto& v : ret)
+                v = std::sqrt(v);
+            return ret;
+        }
+
+        // Covariance matrix, with the variances on the diagonal.
+        mat<value_type, dim, dim> covariance(size_t ddof = 0) const requires( Covariance ) {
+            const value_type s = value_type(1) / (value_type(m_acc.count) - value_type(ddof));
+            mat<value_type, dim, dim> ret;
+            constexpr_for<0, dim, 1>([&](auto I) { ret[I] = m_acc.cov[I] * s; });
+            return ret;
+        }
+
+    private:
+        using acc_type = detail::welford<value_type, dim, Covariance>;
+        acc_type m_acc;
+};
+
+}
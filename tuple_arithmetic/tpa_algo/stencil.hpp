@@ -0,0 +1,224 @@
+/**
+ * Stencils (sliding-window weighted sums) over 1D signals and 2D images.
+ *
+ * Pixels are scalars, or tuples of C components of the same type stored
+ * contiguously, such as std::array<float, 3>. Every component is filtered
+ * with the same weights: in memory, a C-component image is a scalar image
+ * whose taps are C values apart, so a batch of consecutive values is a batch
+ * of outputs, and every tap is one unaligned load of the overlapping window.
+ * Pixels whose window crosses the left or right edge are computed one at a
+ * time with the boundary mode; rows above and below the image are mapped once
+ * per output row. Threads process bands of rows. Weights and sums are floating
+ * point: float for 8- and 16-bit integer pixels, double for 32-bit ones, which
+ * are rounded and saturated when stored.
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+#include "pixels.hpp"
+
+#pragma once
+
+namespace tpa {
+
+// Handling of pixels outside of the input.
+enum class stencil_boundary {
+    clamp,  // use the nearest edge pixel
+    wrap,   // periodic input: pixel n is pixel 0
+    mirror, // reflect about the edge pixels: pixel -1 is pixel 1
+    zero,   // pixels outside are 0
+};
+
+namespace detail {
+    // Minimum number of output values per chunk in threaded stencils.
+    inline constexpr size_t stencil_grain = size_t(1) << 14;
+
+    // Type of the weights and sums over pixels of component type T.
+    template<typename T>
+    using stencil_value_t = std::conditional_t<std::is_floating_point_v<T>, T,
+          std::conditional_t<(sizeof(T) <= 2), float, double>>;
+
+    // v rounded to the nearest integer in the range of T, for integer T.
+    template<typename T, typename F>
+    FORCE_INLINE F stencil_round(const F& v) {
+        if constexpr (std::is_floating_point_v<T>)
+            return v;
+        else {
+            using std::nearbyint;
+            using std::min;
+            using std::max;
+            using S = max_type_t<F>;
+            return min(max(nearbyint(v), F(S(std::numeric_limits<T>::min()))), F(S(std::numeric_limits<T>::max())));
+        }
+    }
+
+    // Index of node i of n under the boundary mode, or -1 for a zero node.
+    template<stencil_boundary B>
+    FORCE_INLINE std::ptrdiff_t edge_index(std::ptrdiff_t i, std::ptrdiff_t n) {
+        if (i >= 0 and i < n)
+            return i;
+        if constexpr (B == stencil_boundary::clamp)
+            return i < 0 ? 0 : n - 1;
+        else if constexpr (B == stencil_boundary::wrap)
+            return (i % n + n) % n;
+        else if constexpr (B == stencil_boundary::mirror) {
+            if (n == 1)
+                return 0;
+            const std::ptrdiff_t p = 2 * (n - 1);
+            i = (i % p + p) % p;
+            return i < n ? i : p - i;
+        }
+        else
+            return -1;
+    }
+
+    // Weights as KY rows of KX taps: a tuple of taps is a single row.
+    template<typename T, typename W>
+    FORCE_INLINE auto stencil_weights(const W& w) {
+        using W0 = std::remove_cvref_t<std::tuple_element_t<0, W>>;
+        if constexpr (tuple_like<W0>) {
+            constexpr size_t KY = tpa_tuple_size_v<W>;
+            constexpr size_t KX = tpa_tuple_size_v<W0>;
+            std::array<std::array<T, KX>, KY> ret;
+            constexpr_for<0, KY, 1>([&](auto I) {
+                static_assert(tpa_tuple_size_v<std::remove_cvref_t<decltype(get<I>(w))>> == KX, "stencil: weight rows must have the same size");
+                ret[I] = to_elems<T>(get<I>(w));
+            });
+            return ret;
+        }
+        else
+            return std::array<std::array<T, tpa_tuple_size_v<W>>, 1>{ to_elems<T>(w) };
+    }
+
+    // acc + w[0] get<0>(window) + w[1] get<1>(window) + ...
+    template<typename U, typename T, size_t K, typename Win>
+    FORCE_INLINE U stencil_taps(U acc, const std::array<T, K>& w, const Win& window) {
+        constexpr_for<0, K, 1>([&](auto I) { acc = fma_elem(U(w[I]), U(get<I>(window)), acc); });
+        return acc;
+    }
+
+    /**
+     * Pixels [x0, x1) of an output row of width pixels of C components, from
+     * the input rows under each row of weights. Taps are centered: tap k of a
+     * row of KX reads pixel x + k - KX / 2.
+     */
+    template<stencil_boundary B, size_t C, typename T, typename F, size_t KY, size_t KX>
+    void stencil_row(const std::array<const T*, KY>& rows, T* out, size_t width,
+            const std::array<std::array<F, KX>, KY>& w, size_t x0, size_t x1) {
+        static_assert(std::is_floating_point_v<T> or sizeof(T) <= 4, "stencil: integer pixels must have at most 32 bits");
+        constexpr std::ptrdiff_t rx = KX / 2;
+        const std::ptrdiff_t n = std::ptrdiff_t(width);
+        // Pixels whose window is inside the row.
+        const size_t lo = std::clamp<size_t>(rx, x0, x1);
+        const size_t hi = std::max(lo, std::min<size_t>(x1, width >= KX ? width - (KX - 1 - rx) : 0));
+
+        auto edge_pixel = [&](size_t x) {
+            for (size_t c = 0; c < C; ++c) {
+                F acc = F(0);
+                for (size_t ky = 0; ky < KY; ++ky)
+                    for (size_t kx = 0; kx < KX; ++kx) {
+                        const std::ptrdiff_t j = edge_index<B>(std::ptrdiff_t(x) + std::ptrdiff_t(kx) - rx, n);
+                        if (j >= 0)
+                            acc = fma_elem(w[ky][kx], F(rows[ky][size_t(j) * C + c]), acc);
+                    }
+                out[x * C + c] = T(stencil_round<T>(acc));
+            }
+        };
+
+        for (size_t x = x0; x < lo; ++x)
+            edge_pixel(x);
+        size_t i = lo * C;
+        const size_t end = hi * C;
+        if constexpr (simd_scalar<T>) {
+            using simd_t = xsimd::batch<F>;
+            constexpr size_t W = simd_t::size;
+            for (; i + W <= end; i += W) {
+                simd_t acc(F(0));
+                for (size_t ky = 0; ky < KY; ++ky) {
+                    const T* p = rows[ky] + i - rx * C;
+                    std::array<simd_t, KX> window;
+                    constexpr_for<0, KX, 1>([&](auto K) { window[K] = simd_t::load_unaligned(p + K * C); });
+                    acc = stencil_taps(acc, w[ky], window);
+                }
+                stencil_round<T>(acc).store_unaligned(out + i);
+            }
+        }
+        for (; i < end; ++i) {
+            F acc = F(0);
+            for (size_t ky = 0; ky < KY; ++ky) {
+                if constexpr (C == 1)
+                    acc = stencil_taps(acc, w[ky], ptr_tuple<const T, KX>(rows[ky], std::ptrdiff_t(i) - rx));
+                else {
+                    std::array<T, KX> window;
+                    for (size_t k = 0; k < KX; ++k)
+                        window[k] = rows[ky][i + k * C - rx * C];
+                    acc = stencil_taps(acc, w[ky], window);
+                }
+            }
+            out[i] = T(stencil_round<T>(acc));
+        }
+        for (size_t x = hi; x < x1; ++x)
+            edge_pixel(x);
+    }
+}
+
+/**
+ * out[x] = sum_k w[k] in[x + k - K / 2] for x in [0, n), where w is a tuple
+ * of K weights; pixels outside [0, n) follow the boundary mode B. Pixels are
+ * scalars or contiguous tuples of components, filtered independently.
+ * Integer components are rounded and saturated. out must not overlap in.
+ */
+template<stencil_boundary B = stencil_boundary::clamp, typename P, tuple_like Weights>
+void stencil1d(const P* in, P* out, size_t n, const Weights& w, unsigned threads = 1) {
+    using traits = detail::pixel_traits<P>;
+    using T = typename traits::value_type;
+    constexpr size_t C = traits::components;
+    const auto wt = detail::stencil_weights<detail::stencil_value_t<T>>(w);
+    static_assert(std::tuple_size_v<decltype(wt)> == 1, "stencil1d: weights must be a tuple of numbers");
+    const std::array<const T*, 1> rows{ reinterpret_cast<const T*>(in) };
+    T* o = reinterpret_cast<T*>(out);
+    parallel_chunks(n, threads, [&](size_t, size_t begin, size_t end) {
+        detail::stencil_row<B, C>(rows, o, n, wt, begin, end);
+    }, detail::stencil_grain / C);
+}
+
+/**
+ * out(x, y) = sum_{i, j} w[i][j] in(x + j - KX / 2, y + i - KY / 2) over an
+ * image of width x height pixels stored by rows, with w a tuple of KY rows of
+ * KX weights. Pixels outside the image follow the boundary mode B. Bands of
+ * rows are processed on their own threads. out must not overlap in.
+ */
+template<stencil_boundary B = stencil_boundary::clamp, typename P, tuple_like Weights>
+void stencil2d(const P* in, P* out, size_t width, size_t height, const Weights& w, unsigned threads = 1) {
+    using traits = detail::pixel_traits<P>;
+    using T = typename traits::value_type;
+    constexpr size_t C = traits::components;
+    const auto wt = detail::stencil_weights<detail::stencil_value_t<T>>(w);
+    constexpr size_t KY = std::tuple_size_v<decltype(wt)>;
+    constexpr std::ptrdiff_t ry = KY / 2;
+    const T* src = reinterpret_cast<const T*>(in);
+    T* dst = reinterpret_cast<T*>(out);
+    const size_t stride = width * C;
+    // Rows outside of the image read a row of zeros.
+    std::vector<T> zeros(B == stencil_boundary::zero ? stride : 0, T(0));
+    const size_t grain = std::max<size_t>(1, detail::stencil_grain / std::max<size_t>(stride, 1));
+    parallel_chunks(height, threads, [&](size_t, size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            std::array<const T*, KY> rows;
+            for (size_t k = 0; k < KY; ++k) {
+                const std::ptrdiff_t j = detail::edge_index<B>(std::ptrdiff_t(y + k) - ry, std::ptrdiff_t(height));
+                rows[k] = j >= 0 ? src + size_t(j) * stride : zeros.data();
+            }
+            detail::stencil_row<B, C>(rows, dst + y * stride, width, wt, 0, width);
+        }
+    }, grain);
+}
+
+}
@@ -0,0 +1,104 @@
+/**
+ * Bulk transform of points stored in column sets (see soa.hpp).
+ *
+ * transform_points(m, in, out, n) maps every record of the D input columns
+ * through the R x C matrix m:
+ * - C == D: linear map, out has R columns;
+ * - C == D + 1: affine map, the last column of m is a translation. With
+ *   R == C the last row gives the homogeneous coordinate w, and out may have
+ *   R - 1 columns, which are then divided by w (projective transform).
+ * Computation is done in the value type of the first output column.
+ * in and out may be the same columns.
+ */
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Minimum number of points per chunk in the threaded transform.
+    inline constexpr size_t transform_grain = size_t(1) << 12;
+
+    // m * (x, 1) or m * x, divided by the last row if Dout < R.
+    template<size_t Dout, typename U, size_t R, size_t C, size_t D>
+    FORCE_INLINE std::array<U, Dout> transform_point(const mat<U, R, C>& m, const std::array<U, D>& x) {
+        std::array<U, R> y;
+        constexpr_for<0, R, 1>([&](auto I) {
+            U acc;
+            if constexpr (C == D + 1)
+                acc = fma_elem(m[I][0], x[0], m[I][D]);
+            else
+                acc = m[I][0] * x[0];
+            constexpr_for<1, D, 1>([&](auto K) { acc = fma_elem(m[I][K], x[K], acc); });
+            y[I] = acc;
+        });
+        if constexpr (Dout == R)
+            return y;
+        else {
+            const U r = U(1) / y[R - 1];
+            std::array<U, Dout> ret;
+            constexpr_for<0, Dout, 1>([&](auto I) { ret[I] = y[I] * r; });
+            return ret;
+        }
+    }
+
+    template<typename U, typename T, size_t R, size_t C>
+    FORCE_INLINE auto broadcast_mat(const mat<T, R, C>& m) {
+        mat<U, R, C> ret;
+        constexpr_for<0, R, 1>([&](auto I) {
+            constexpr_for<0, C, 1>([&](auto J) { ret[I][J] = U(m[I][J]); });
+        });
+        return ret;
+    }
+
+    template<typename simd_t, typename T, size_t R, size_t C, typename In, typename Out>
+    void transform_range(const mat<T, R, C>& m, In&& in, Out&& out, size_t begin, size_t end) {
+        constexpr size_t D = tpa_tuple_size_v<In>;
+        constexpr size_t Dout = tpa_tuple_size_v<Out>;
+        size_t i = begin;
+        if constexpr (not std::is_same_v<simd_t, void>) {
+            constexpr size_t W = simd_t::size;
+            const auto mb = broadcast_mat<simd_t>(m);
+            for (; i + W <= end; i += W) {
+                const auto cols = load_columns<simd_t>(in, i);
+                std::array<simd_t, D> x;
+                constexpr_for<0, D, 1>([&](auto K) { x[K] = get<K>(cols); });
+                store_columns(out, i, transform_point<Dout>(mb, x));
+            }
+        }
+        for (; i < end; ++i) {
+            std::array<T, D> x;
+            constexpr_for<0, D, 1>([&](auto K) { x[K] = T(get<K>(in)[i]); });
+            store_record(out, i, transform_point<Dout>(m, x));
+        }
+    }
+}
+
+template<tuple_like M, soa_columns In, soa_columns Out>
+    requires( detail::matrix_like<M> )
+void transform_points(const M& m, In&& in, Out&& out, size_t n, unsigned threads = 1) {
+    constexpr size_t R = detail::rows_v<M>;
+    constexpr size_t C = detail::cols_v<M>;
+    constexpr size_t D = tpa_tuple_size_v<In>;
+    constexpr size_t Dout = tpa_tuple_size_v<Out>;
+    static_assert(C == D or C == D + 1, "transform_points: matrix columns must match the input columns (+1 for affine)");
+    static_assert(Dout == R or (Dout + 1 == R and R == C and C == D + 1),
+            "transform_points: output columns must match the matrix rows (-1 for a projective divide)");
+    using T = column_value_t<Out>;
+    static_assert(std::is_floating_point_v<T>, "transform_points: output columns must be floating point");
+    using simd_t = std::conditional_t<simd_scalar<T>, xsimd::batch<T>, void>;
+    const auto mt = detail::to_mat<T>(m);
+    parallel_chunks(n, threads, [&](size_t, size_t begin, size_t end) {
+        detail::transform_range<simd_t>(mt, in, out, begin, end);
+    }, detail::transform_grain);
+}
+
+}
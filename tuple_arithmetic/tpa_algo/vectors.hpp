@@ -0,0 +1,260 @@
+/**
+ * Bulk dot and cross products, norms and normalization of 2-, 3- and
+ * 4-vectors.
+ *
+ * Vector arrays are column sets (see soa.hpp) with one column per component,
+ * or pointers to tuple-like records such as std::array<float, 3>. Vectors are
+ * processed a batch at a time; records of type std::array<T, D> are gathered
+ * and scattered with lane strides, other record types are processed one at a
+ * time. Computation is done in the value type of the output.
+ */
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tuple_arithmetic.hpp"
+#include "../tpa_simd/xsimd_permute.hpp"
+#include "soa.hpp"
+#include "parallel.hpp"
+
+#pragma once
+
+namespace tpa {
+
+// Handling of vectors too short to be normalized: squared norm below
+// std::numeric_limits<T>::min(), which includes the zero vector.
+enum class degenerate {
+    zero,  // write the zero vector
+    keep,  // copy the input vector
+    nan,   // no check, the result is v / |v| (NaN or inf components)
+};
+
+namespace detail {
+    // Minimum number of vectors per chunk in threaded kernels.
+    inline constexpr size_t vector_grain = size_t(1) << 10;
+
+    template<typename P>
+    concept record_pointer = std::is_pointer_v<std::remove_cvref_t<P>> and
+        tuple_like<std::remove_cv_t<std::remove_pointer_t<std::remove_cvref_t<P>>>>;
+
+    template<typename P>
+    concept vector_array = soa_columns<P> or record_pointer<P>;
+
+    template<typename P> struct vector_array_traits;
+    template<soa_columns P> struct vector_array_traits<P> {
+        static constexpr size_t dim = tpa_tuple_size_v<P>;
+        using value_type = column_value_t<P>;
+        static constexpr bool packed = false;
+    };
+    template<record_pointer P> struct vector_array_traits<P> {
+        using record_type = std::remove_cv_t<std::remove_pointer_t<std::remove_cvref_t<P>>>;
+        static constexpr size_t dim = tpa_tuple_size_v<record_type>;
+        using value_type = tuple_common_t<record_type>;
+        // Records that can be gathered as dim consecutive values of value_type.
+        static constexpr bool packed = std::is_same_v<record_type, std::array<value_type, dim>>;
+    };
+
+    template<typename P> inline constexpr size_t vector_dim_v = vector_array_traits<std::remove_cvref_t<P>>::dim;
+    template<typename P> using vector_value_t = typename vector_array_traits<std::remove_cvref_t<P>>::value_type;
+
+    // Value type of a vector array or of a scalar output array.
+    template<typename Out> struct output_value { using type = vector_value_t<Out>; };
+    template<column_pointer Out> struct output_value<Out> : column_value<Out> {};
+    template<typename Out> using output_value_t = typename output_value<Out>::type;
+
+    // Lane offsets of consecutive records of D values.
+    template<size_t D, typename simd_t>
+    FORCE_INLINE auto record_offsets() {
+        using int_t = xsimd::as_integer_t<typename simd_t::value_type>;
+        return lane_indices<typename simd_t::value_type, typename simd_t::arch_type>() * xsimd::batch<int_t, typename simd_t::arch_type>(int_t(D));
+    }
+
+    template<typename T, typename P>
+    FORCE_INLINE auto load_vector(const P& p, size_t i) {
+        constexpr size_t D = vector_dim_v<P>;
+        std::array<T, D> ret;
+        constexpr_for<0, D, 1>([&](auto K) {
+            if constexpr (soa_columns<P>)
+                ret[K] = T(get<K>(p)[i]);
+            else
+                ret[K] = T(get<K>(p[i]));
+        });
+        return ret;
+    }
+
+    template<typename P, typename V>
+    FORCE_INLINE void store_vector(const P& p, size_t i, const V& v) {
+        if constexpr (soa_columns<P>)
+            store_record(p, i, v);
+        else
+            constexpr_for<0, vector_dim_v<P>, 1>([&](auto K) {
+                get<K>(p[i]) = get<K>(v);
+            });
+    }
+
+    template<typename simd_t, typename P>
+    FORCE_INLINE auto load_vectors(const P& p, size_t i) {
+        constexpr size_t D = vector_dim_v<P>;
+        std::array<simd_t, D> ret;
+        if constexpr (soa_columns<P>) {
+            const auto cols = load_columns<simd_t>(p, i);
+            constexpr_for<0, D, 1>([&](auto K) { ret[K] = get<K>(cols); });
+        }
+        else {
+            const auto idx = record_offsets<D, simd_t>();
+            const auto* base = p[i].data();
+            constexpr_for<0, D, 1>([&](auto K) { ret[K] = simd_t::gather(base + K, idx); });
+        }
+        return ret;
+    }
+
+    template<typename P, typename simd_t, size_t D>
+    FORCE_INLINE void store_vectors(const P& p, size_t i, const std::array<simd_t, D>& v) {
+        if constexpr (soa_columns<P>)
+            store_columns(p, i, v);
+        else {
+            const auto idx = record_offsets<D, simd_t>();
+            auto* base = p[i].data();
+            constexpr_for<0, D, 1>([&](auto K) { v[K].scatter(base + K, idx); });
+        }
+    }
+
+    // Vector arrays loaded and stored as batches of T.
+    template<typename P, typename T>
+    concept vector_simd = simd_scalar<T> and
+        (soa_columns<P> or (record_pointer<P> and vector_array_traits<std::remove_cvref_t<P>>::packed and std::is_same_v<vector_value_t<P>, T>));
+
+    /**
+     * out = fn(in...) for every vector, a batch at a time where all arrays allow it.
+     * fn takes std::arrays of T or of batches and returns a value or an std::array.
+     */
+    template<typename T, typename Out, typename Fn, typename...In>
+    void map_vectors(Out&& out, size_t n, unsigned threads, Fn&& fn, const In&...in) {
+        auto store = [&out](size_t i, const auto& r) {
+            if constexpr (column_pointer<Out>) {
+                if constexpr (std::is_arithmetic_v<std::remove_cvref_t<decltype(r)>>)
+                    out[i] = r;
+                else
+                    r.store_unaligned(out + i);
+            }
+            else if constexpr (std::is_arithmetic_v<std::remove_cvref_t<decltype(r[0])>>)
+                store_vector(out, i, r);
+            else
+                store_vectors(out, i, r);
+        };
+        parallel_chunks(n, threads, [&](size_t, size_t begin, size_t end) {
+            size_t i = begin;
+            if constexpr (simd_scalar<T> and (column_pointer<Out> or vector_simd<Out, T>) and (vector_simd<In, T> and ...)) {
+                using simd_t = xsimd::batch<T>;
+                constexpr size_t W = simd_t::size;
+                for (; i + W <= end; i += W)
+                    store(i, fn(load_vectors<simd_t>(in, i)...));
+            }
+            for (; i < end; ++i)
+                store(i, fn(load_vector<T>(in, i)...));
+        }, vector_grain);
+    }
+
+    template<typename U, size_t D>
+    FORCE_INLINE U vector_dot(const std::array<U, D>& a, const std::array<U, D>& b) {
+        U acc = a[0] * b[0];
+        constexpr_for<1, D, 1>([&](auto K) { acc = fma_elem(a[K], b[K], acc); });
+        return acc;
+    }
+
+    template<typename U, size_t D>
+    FORCE_INLINE auto vector_cross(const std::array<U, D>& a, const std::array<U, D>& b) {
+        static_assert(D == 2 or D == 3, "cross: only defined for 2- and 3-vectors");
+        if constexpr (D == 2)
+            return fma_elem(a[0], b[1], -(a[1] * b[0]));
+        else
+            return std::array<U, 3>{
+                fma_elem(a[1], b[2], -(a[2] * b[1])),
+                fma_elem(a[2], b[0], -(a[0] * b[2])),
+                fma_elem(a[0], b[1], -(a[1] * b[0])) };
+    }
+
+    // 1 / sqrt(s); with Approx, a hardware estimate refined by one Newton step.
+    template<bool Approx, typename U>
+    FORCE_INLINE U inv_sqrt(const U& s) {
+        using T = max_type_t<U>;
+        if constexpr (Approx and not std::is_arithmetic_v<U>) {
+            const U r = xsimd::rsqrt(s);
+            return r * fma_elem(U(T(-0.5)) * s, r * r, U(T(1.5)));
+        }
+        else {
+            using std::sqrt;
+            return U(T(1)) / sqrt(s);
+        }
+    }
+
+    template<degenerate P, bool Approx, typename U, size_t D>
+    FORCE_INLINE std::array<U, D> vector_normalize(const std::array<U, D>& v) {
+        using T = max_type_t<U>;
+        const U s = vector_dot(v, v);
+        const U r = inv_sqrt<Approx>(s);
+        std::array<U, D> ret;
+        if constexpr (P == degenerate::nan)
+            constexpr_for<0, D, 1>([&](auto K) { ret[K] = v[K] * r; });
+        else {
+            const auto bad = s < U(std::numeric_limits<T>::min());
+            constexpr_for<0, D, 1>([&](auto K) {
+                ret[K] = sort_traits<U>::select(bad, P == degenerate::zero ? U(T(0)) : v[K], v[K] * r);
+            });
+        }
+        return ret;
+    }
+}
+
+// out[i] = dot(a[i], b[i])
+template<typename A, typename B, typename T>
+    requires( detail::vector_array<A> and detail::vector_array<B> )
+void dot(const A& a, const B& b, T* out, size_t n, unsigned threads = 1) {
+    static_assert(detail::vector_dim_v<A> == detail::vector_dim_v<B>, "dot: vectors must have the same size");
+    detail::map_vectors<T>(out, n, threads, [](const auto& x, const auto& y) { return detail::vector_dot(x, y); }, a, b);
+}
+
+// out[i] = dot(in[i], in[i])
+template<typename In, typename T>
+    requires( detail::vector_array<In> )
+void squared_norm(const In& in, T* out, size_t n, unsigned threads = 1) {
+    detail::map_vectors<T>(out, n, threads, [](const auto& x) { return detail::vector_dot(x, x); }, in);
+}
+
+// out[i] = sqrt(dot(in[i], in[i]))
+template<typename In, typename T>
+    requires( detail::vector_array<In> )
+void norm(const In& in, T* out, size_t n, unsigned threads = 1) {
+    detail::map_vectors<T>(out, n, threads, [](const auto& x) {
+        using std::sqrt;
+        return sqrt(detail::vector_dot(x, x));
+    }, in);
+}
+
+// out[i] = cross(a[i], b[i]): a vector array for 3-vectors, a scalar array for 2-vectors.
+template<typename A, typename B, typename Out>
+    requires( detail::vector_array<A> and detail::vector_array<B> and
+              (detail::vector_array<Out> or column_pointer<Out>) )
+void cross(const A& a, const B& b, Out&& out, size_t n, unsigned threads = 1) {
+    static_assert(detail::vector_dim_v<A> == detail::vector_dim_v<B>, "cross: vectors must have the same size");
+    detail::map_vectors<detail::output_value_t<Out>>(out, n, threads,
+            [](const auto& x, const auto& y) { return detail::vector_cross(x, y); }, a, b);
+}
+
+/**
+ * out[i] = in[i] / |in[i]|. With Approx, batches use an inverse square root
+ * estimate refined by one Newton step (about 22 bits for float). in and out may
+ * be the same array.
+ */
+template<degenerate P = degenerate::zero, bool Approx = false, typename In, typename Out>
+    requires( detail::vector_array<In> and detail::vector_array<Out> )
+void normalize(const In& in, Out&& out, size_t n, unsigned threads = 1) {
+    static_assert(detail::vector_dim_v<In> == detail::vector_dim_v<Out>, "normalize: vectors must have the same size");
+    detail::map_vectors<detail::vector_value_t<Out>>(out, n, threads,
+            [](const auto& x) { return detail::vector_normalize<P, Approx>(x); }, in);
+}
+
+}
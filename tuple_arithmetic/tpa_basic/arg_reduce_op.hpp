@@ -0,0 +1,81 @@
+#include "defines.hpp"
+#include "basics.hpp"
+#include "functions.hpp"
+#include "sort_op.hpp"
+#include <type_traits>
+#include <utility>
+
+#pragma once
+
+TP_ENTER_NS
+
+// Reductions with index
+namespace detail {
+    /**
+     * b is a better candidate than a: smaller (larger if Max), or b is NaN and a is not.
+     * With a left-to-right fold this picks the first extremum, or the first NaN if any.
+     */
+    template<bool Max, typename T>
+    FORCE_INLINE constexpr auto extremum_better(const T& b, const T& a) {
+        if constexpr (std::is_arithmetic_v<T>)
+            return (Max ? a < b : b < a) or (b != b and a == a);
+        else
+            return (Max ? a < b : b < a) | ((b != b) & (a == a));
+    }
+
+    template<typename Tp>
+    concept arg_reducible = tuple_like<Tp> and (std::tuple_size_v<std::remove_cvref_t<Tp>> > 0) and
+        requires { typename tuple_common_t<Tp>; };
+
+    // (a1, a2, ...) -> (extremum, index), serial fold in the common type of the elements.
+    template<bool Max, typename Tp>
+    FORCE_INLINE constexpr auto extremum_fold(Tp&& tp) {
+        using T = tuple_common_t<Tp>;
+        using traits = sort_traits<T>;
+        T best = get<0>(tp);
+        auto idx = traits::index(0);
+        constexpr_for<1, std::tuple_size_v<std::remove_cvref_t<Tp>>, 1>([&](auto I) {
+            const T v = get<I>(tp);
+            const auto take = extremum_better<Max>(v, best);
+            idx = traits::select(take, traits::index(I), idx);
+            best = traits::select(take, v, best);
+        });
+        return std::pair{best, idx};
+    }
+}
+
+// (a1, a2, ...) -> (min, index of the first min). A NaN element is returned over any number.
+// For a tuple of batches every lane is reduced independently and the index is a batch of integers.
+template<tuple_like Tp>
+    requires( detail::arg_reducible<Tp> )
+FORCE_INLINE constexpr auto min_element(Tp&& tp) {
+    return detail::extremum_fold<false>(std::forward<Tp>(tp));
+}
+
+// (a1, a2, ...) -> (max, index of the first max). A NaN element is returned over any number.
+template<tuple_like Tp>
+    requires( detail::arg_reducible<Tp> )
+FORCE_INLINE constexpr auto max_element(Tp&& tp) {
+    return detail::extremum_fold<true>(std::forward<Tp>(tp));
+}
+
+// (a1, a2, ...) -> ((min, index), (max, index))
+template<tuple_like Tp>
+    requires( detail::arg_reducible<Tp> )
+FORCE_INLINE constexpr auto minmax_element(Tp&& tp) {
+    return std::pair{min_element(tp), max_element(tp)};
+}
+
+template<tuple_like Tp>
+    requires( detail::arg_reducible<Tp> )
+FORCE_INLINE constexpr auto argmin(Tp&& tp) {
+    return min_element(std::forward<Tp>(tp)).second;
+}
+
+template<tuple_like Tp>
+    requires( detail::arg_reducible<Tp> )
+FORCE_INLINE constexpr auto argmax(Tp&& tp) {
+    return max_element(std::forward<Tp>(tp)).second;
+}
+
+TP_EXIT_NS
@@ -1,4 +1,6 @@
 #include "defines.hpp"
+#include <array>
+#include <cstddef>
 #include <concepts>
 #include <tuple>
 #include <functional>
@@ -81,4 +83,46 @@ template<typename T> struct tpa_tuple_size :
         std::integral_constant<size_t, 0>> {};
 template<typename T> static constexpr size_t tpa_tuple_size_v = tpa_tuple_size<std::remove_cvref_t<T>>::value;
 
+// Common type of all elements of a tuple.
+namespace detail {
+    template<typename Tp, size_t...I>
+    auto tuple_common_type(std::index_sequence<I...>) ->
+        std::common_type_t<std::remove_cvref_t<std::tuple_element_t<I, std::remove_cvref_t<Tp>>>...>;
+}
+template<typename Tp>
+using tuple_common_t = decltype(detail::tuple_common_type<Tp>(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<Tp>>>{}));
+
+
+namespace detail {
+    /**
+     * Element operations used by the networks and index reductions. Specialized for
+     * xsimd batches, where the comparison yields a lane mask.
+     */
+    template<typename T>
+    struct sort_traits {
+        using index_type = size_t;
+        FORCE_INLINE static constexpr index_type index(size_t k) { return k; }
+        template<typename V>
+        FORCE_INLINE static constexpr V select(bool cond, const V& a, const V& b) { return cond ? a : b; }
+    };
+
+    // Comparison result of U: bool for scalars, a batch_bool for batches.
+    template<typename U>
+    using lane_mask_t = decltype(std::declval<U>() < std::declval<U>());
+
+    // cond ? a : b, lane by lane for batches.
+    template<typename U>
+    FORCE_INLINE constexpr U lane_select(const lane_mask_t<U>& cond, const U& a, const U& b) {
+        return sort_traits<U>::select(cond, a, b);
+    }
+
+    // Elements of a tuple converted to T.
+    template<typename T, typename Q>
+    FORCE_INLINE constexpr std::array<T, tpa_tuple_size_v<Q>> to_elems(Q&& q) {
+        std::array<T, tpa_tuple_size_v<Q>> ret;
+        constexpr_for<0, tpa_tuple_size_v<Q>, 1>([&](auto I) { ret[I] = T(get<I>(q)); });
+        return ret;
+    }
+}
+
 TP_EXIT_NS
@@ -0,0 +1,207 @@
+#include "defines.hpp"
+#include "basics.hpp"
+#include "functions.hpp"
+#include "other.hpp"
+#include <array>
+#include <type_traits>
+#include <utility>
+
+#pragma once
+
+TP_ENTER_NS
+
+// Row-major R x C matrix: a tuple of R rows of C elements each.
+// Any such nested tuple-like object is accepted by the functions below.
+template<typename T, size_t R, size_t C = R>
+using mat = std::array<std::array<T, C>, R>;
+
+namespace detail {
+    template<typename M>
+    concept matrix_like = tuple_like<M> and (tpa_tuple_size_v<M> > 0) and
+        tuple_like<std::tuple_element_t<0, std::remove_cvref_t<M>>>;
+
+    template<typename M> static constexpr size_t rows_v = tpa_tuple_size_v<M>;
+    template<typename M> static constexpr size_t cols_v = tpa_tuple_size_v<std::tuple_element_t<0, std::remove_cvref_t<M>>>;
+
+    template<typename M, size_t...I>
+    auto matrix_common_type(std::index_sequence<I...>) ->
+        std::common_type_t<tuple_common_t<std::tuple_element_t<I, std::remove_cvref_t<M>>>...>;
+
+    // Common type of all elements
+    template<typename M>
+    using matrix_value_t = decltype(matrix_common_type<M>(std::make_index_sequence<rows_v<M>>{}));
+
+    template<typename M>
+    concept square_matrix = matrix_like<M> and rows_v<M> == cols_v<M>;
+
+    // Integer matrices are inverted in double precision.
+    template<typename T>
+    using inverse_value_t = std::conditional_t<std::is_integral_v<T>, double, T>;
+
+    template<typename T, typename M>
+    FORCE_INLINE constexpr auto to_mat(M&& m) {
+        mat<T, rows_v<M>, cols_v<M>> ret;
+        constexpr_for<0, rows_v<M>, 1>([&](auto I) {
+            constexpr_for<0, cols_v<M>, 1>([&](auto J) {
+                ret[I][J] = T(get<J>(get<I>(m)));
+            });
+        });
+        return ret;
+    }
+
+    // a0 * b0 + a1 * b1 + ...
+    template<size_t N, typename T, typename Fa, typename Fb>
+    FORCE_INLINE constexpr T fma_sum(Fa&& a, Fb&& b) {
+        T acc = T(a(std::integral_constant<size_t, 0>{})) * T(b(std::integral_constant<size_t, 0>{}));
+        constexpr_for<1, N, 1>([&](auto K) {
+            acc = fma_elem(T(a(K)), T(b(K)), acc);
+        });
+        return acc;
+    }
+
+    // a * d - b * c
+    template<typename T>
+    FORCE_INLINE constexpr T det2(const T& a, const T& b, const T& c, const T& d) {
+        return fma_elem(a, d, -(b * c));
+    }
+}
+
+// Transpose
+template<tuple_like M>
+    requires( detail::matrix_like<M> )
+FORCE_INLINE constexpr auto transpose(M&& m) {
+    using T = detail::matrix_value_t<M>;
+    mat<T, detail::cols_v<M>, detail::rows_v<M>> ret;
+    constexpr_for<0, detail::rows_v<M>, 1>([&](auto I) {
+        constexpr_for<0, detail::cols_v<M>, 1>([&](auto J) {
+            ret[J][I] = T(get<J>(get<I>(m)));
+        });
+    });
+    return ret;
+}
+
+// Matrix-matrix product if x is a matrix, matrix-vector product otherwise.
+template<tuple_like M, tuple_like X>
+    requires( detail::matrix_like<M> )
+FORCE_INLINE constexpr auto matmul(M&& m, X&& x) {
+    constexpr size_t R = detail::rows_v<M>;
+    constexpr size_t K = detail::cols_v<M>;
+    static_assert(tpa_tuple_size_v<X> == K, "matmul: inner dimensions do not match");
+    if constexpr (detail::matrix_like<X>) {
+        constexpr size_t C = detail::cols_v<X>;
+        using T = decltype(std::declval<detail::matrix_value_t<M>>() * std::declval<detail::matrix_value_t<X>>());
+        mat<T, R, C> ret;
+        constexpr_for<0, R, 1>([&](auto I) {
+            constexpr_for<0, C, 1>([&](auto J) {
+                ret[I][J] = detail::fma_sum<K, T>(
+                        [&](auto k) { return get<decltype(k)::value>(get<I>(m)); },
+                        [&](auto k) { return get<J>(get<decltype(k)::value>(x)); });
+            });
+        });
+        return ret;
+    }
+    else {
+        using T = decltype(std::declval<detail::matrix_value_t<M>>() * std::declval<tuple_common_t<X>>());
+        std::array<T, R> ret;
+        constexpr_for<0, R, 1>([&](auto I) {
+            ret[I] = detail::fma_sum<K, T>(
+                    [&](auto k) { return get<decltype(k)::value>(get<I>(m)); },
+                    [&](auto k) { return get<decltype(k)::value>(x); });
+        });
+        return ret;
+    }
+}
+
+// Determinant of a 1x1 to 4x4 matrix.
+template<tuple_like M>
+    requires( detail::square_matrix<M> )
+FORCE_INLINE constexpr auto det(M&& m) {
+    constexpr size_t N = detail::rows_v<M>;
+    static_assert(N <= 4, "det: only implemented up to 4x4");
+    using T = detail::matrix_value_t<M>;
+    const auto a = detail::to_mat<T>(std::forward<M>(m));
+    if constexpr (N == 1)
+        return a[0][0];
+    else if constexpr (N == 2)
+        return detail::det2(a[0][0], a[0][1], a[1][0], a[1][1]);
+    else if constexpr (N == 3)
+        return dot(a[0], cross(a[1], a[2]));
+    else {
+        using detail::det2;
+        const T s0 = det2(a[0][0], a[0][1], a[1][0], a[1][1]);
+        const T s1 = det2(a[0][0], a[0][2], a[1][0], a[1][2]);
+        const T s2 = det2(a[0][0], a[0][3], a[1][0], a[1][3]);
+        const T s3 = det2(a[0][1], a[0][2], a[1][1], a[1][2]);
+        const T s4 = det2(a[0][1], a[0][3], a[1][1], a[1][3]);
+        const T s5 = det2(a[0][2], a[0][3], a[1][2], a[1][3]);
+        const T c0 = det2(a[2][0], a[2][1], a[3][0], a[3][1]);
+        const T c1 = det2(a[2][0], a[2][2], a[3][0], a[3][2]);
+        const T c2 = det2(a[2][0], a[2][3], a[3][0], a[3][3]);
+        const T c3 = det2(a[2][1], a[2][2], a[3][1], a[3][2]);
+        const T c4 = det2(a[2][1], a[2][3], a[3][1], a[3][3]);
+        const T c5 = det2(a[2][2], a[2][3], a[3][2], a[3][3]);
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+}
+
+// Inverse of a 1x1 to 4x4 matrix, from the adjugate. A singular matrix gives inf or NaN elements.
+template<tuple_like M>
+    requires( detail::square_matrix<M> )
+FORCE_INLINE constexpr auto inverse(M&& m) {
+    constexpr size_t N = detail::rows_v<M>;
+    static_assert(N <= 4, "inverse: only implemented up to 4x4");
+    using T = detail::inverse_value_t<detail::matrix_value_t<M>>;
+    const auto a = detail::to_mat<T>(std::forward<M>(m));
+    mat<T, N, N> b;
+    if constexpr (N == 1)
+        b[0][0] = T(1) / a[0][0];
+    else if constexpr (N == 2) {
+        const T r = T(1) / detail::det2(a[0][0], a[0][1], a[1][0], a[1][1]);
+        b = {{ {a[1][1] * r, -a[0][1] * r}, {-a[1][0] * r, a[0][0] * r} }};
+    }
+    else if constexpr (N == 3) {
+        // Columns of the adjugate are cross products of the rows.
+        const auto c0 = cross(a[1], a[2]);
+        const auto c1 = cross(a[2], a[0]);
+        const auto c2 = cross(a[0], a[1]);
+        const T r = T(1) / dot(a[0], c0);
+        constexpr_for<0, 3, 1>([&](auto I) {
+            b[I] = {get<I>(c0) * r, get<I>(c1) * r, get<I>(c2) * r};
+        });
+    }
+    else {
+        using detail::det2;
+        const T s0 = det2(a[0][0], a[0][1], a[1][0], a[1][1]);
+        const T s1 = det2(a[0][0], a[0][2], a[1][0], a[1][2]);
+        const T s2 = det2(a[0][0], a[0][3], a[1][0], a[1][3]);
+        const T s3 = det2(a[0][1], a[0][2], a[1][1], a[1][2]);
+        const T s4 = det2(a[0][1], a[0][3], a[1][1], a[1][3]);
+        const T s5 = det2(a[0][2], a[0][3], a[1][2], a[1][3]);
+        const T c0 = det2(a[2][0], a[2][1], a[3][0], a[3][1]);
+        const T c1 = det2(a[2][0], a[2][2], a[3][0], a[3][2]);
+        const T c2 = det2(a[2][0], a[2][3], a[3][0], a[3][3]);
+        const T c3 = det2(a[2][1], a[2][2], a[3][1], a[3][2]);
+        const T c4 = det2(a[2][1], a[2][3], a[3][1], a[3][3]);
+        const T c5 = det2(a[2][2], a[2][3], a[3][2], a[3][3]);
+        const T r = T(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+        b[0] = {( a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3) * r,
+                (-a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3) * r,
+                ( a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3) * r,
+                (-a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3) * r};
+        b[1] = {(-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1) * r,
+                ( a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1) * r,
+                (-a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1) * r,
+                ( a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1) * r};
+        b[2] = {( a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0) * r,
+                (-a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0) * r,
+                ( a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0) * r,
+                (-a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0) * r};
+        b[3] = {(-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0) * r,
+                ( a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0) * r,
+                (-a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0) * r,
+                ( a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0) * r};
+    }
+    return b;
+}
+
+TP_EXIT_NS
@@ -3,6 +3,8 @@
 #include "const_tuple.hpp"
 #include "unary_op.hpp"
 #include "binary_op.hpp"
+#include <array>
+#include <cmath>
 #include <type_traits>
 
 #pragma once
@@ -45,4 +47,104 @@ FORCE_INLINE constexpr decltype(auto) powi(T&& val) {
     }
 }
 
+// polynomial evaluation
+namespace detail {
+    template<typename T>
+    constexpr bool fast_fma =
+#if defined(FP_FAST_FMA)
+        std::is_same_v<T, double> or
+#endif
+#if defined(FP_FAST_FMAF)
+        std::is_same_v<T, float> or
+#endif
+        false;
+
+    // a * b + c, fused where the hardware supports it, or for batches.
+    template<typename T>
+    FORCE_INLINE constexpr T fma_elem(const T& a, const T& b, const T& c) {
+        if constexpr (fast_fma<T>) {
+            if (not std::is_constant_evaluated())
+                return std::fma(a, b, c);
+            return a * b + c;
+        }
+        else if constexpr (std::is_arithmetic_v<T>)
+            return a * b + c;
+        else if constexpr (requires { { fma(a, b, c) } -> std::convertible_to<T>; })
+            return fma(a, b, c);
+        else
+            return a * b + c;
+    }
+
+    // Horner's rule has the fewest operations; Estrin's scheme has a shorter
+    // dependency chain and wins for longer polynomials.
+    static constexpr size_t estrin_min_size = 6;
+
+    template<typename X, size_t N>
+    FORCE_INLINE constexpr X horner(const std::array<X, N>& c, const X& x) {
+        X r = c[N-1];
+        constexpr_for<0, N-1, 1>([&](auto I) {
+            r = fma_elem(r, x, c[N-2-I]);
+        });
+        return r;
+    }
+
+    // (c0 + c1 x) + (c2 + c3 x) x^2 + ..., then the same on the pairs with x^2.
+    template<typename X, size_t N>
+    FORCE_INLINE constexpr X estrin(const std::array<X, N>& c, const X& x) {
+        if constexpr (N == 1)
+            return c[0];
+        else {
+            std::array<X, (N+1)/2> p;
+            constexpr_for<0, N/2, 1>([&](auto I) {
+                p[I] = fma_elem(c[2*I+1], x, c[2*I]);
+            });
+            if constexpr (N % 2 == 1)
+                p[N/2] = c[N-1];
+            return estrin(p, powi<2>(x));
+        }
+    }
+
+    template<typename X, size_t N>
+    FORCE_INLINE constexpr X poly_eval(const std::array<X, N>& c, const X& x) {
+        if constexpr (N == 0)
+            return X(0);
+        else if constexpr (N < estrin_min_size)
+            return horner(c, x);
+        else
+            return estrin(c, x);
+    }
+
+    // Arithmetic values are promoted with the coefficients; batches keep their type.
+    template<typename X, typename...C>
+    using poly_result_t = typename std::conditional_t<std::is_arithmetic_v<X>,
+          std::common_type<X, C...>, std::type_identity<X>>::type;
+}
+
+// c0 + c1 x + c2 x^2 + ... with compile-time coefficients, element-wise if x is tuple-like.
+template<auto...C, typename X>
+FORCE_INLINE constexpr auto polyval(X&& x) {
+    if constexpr (tuple_like<X>)
+        return apply_unary_op([](auto&& v) { return polyval<C...>(v); }, std::forward<X>(x));
+    else {
+        using R = detail::poly_result_t<std::remove_cvref_t<X>, decltype(C)...>;
+        constexpr size_t N = sizeof...(C);
+        return detail::poly_eval(std::array<R, N>{ R(C)... }, R(x));
+    }
+}
+
+// c0 + c1 x + c2 x^2 + ... with coefficients (c0, c1, c2, ...), element-wise if x is tuple-like.
+template<tuple_like Coeffs, typename X>
+FORCE_INLINE constexpr auto polyval(Coeffs&& coeffs, X&& x) {
+    if constexpr (tuple_like<X>)
+        return apply_unary_op([&coeffs](auto&& v) { return polyval(coeffs, v); }, std::forward<X>(x));
+    else {
+        constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<Coeffs>>;
+        return [&]<size_t...I>(std::index_sequence<I...>) {
+            using R = detail::poly_result_t<std::remove_cvref_t<X>,
+                  std::remove_cvref_t<std::tuple_element_t<I, std::remove_cvref_t<Coeffs>>>...>;
+            return detail::poly_eval(std::array<R, N>{ R(get<I>(coeffs))... }, R(x));
+        }(std::make_index_sequence<N>{});
+    }
+}
+
 TP_EXIT_NS
@@ -0,0 +1,183 @@
+#include "defines.hpp"
+#include "basics.hpp"
+#include "functions.hpp"
+#include "other.hpp"
+#include "matrix.hpp"
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+#pragma once
+
+TP_ENTER_NS
+
+// Quaternion w + x i + y j + z k stored as (x, y, z, w): the vector part lines up with 3-vectors.
+// Any tuple-like object of 4 elements is accepted by the functions below.
+template<typename T>
+using quat = std::array<T, 4>;
+
+namespace detail {
+    template<typename Q>
+    concept quat_like = tuple_like<Q> and tpa_tuple_size_v<Q> == 4;
+
+    template<typename V>
+    concept vec3_like = tuple_like<V> and tpa_tuple_size_v<V> == 3;
+
+    template<typename...Tp>
+    using quat_value_t = std::common_type_t<tuple_common_t<Tp>...>;
+
+    template<typename T>
+    FORCE_INLINE constexpr T quat_dot(const quat<T>& a, const quat<T>& b) {
+        return fma_elem(a[0], b[0], fma_elem(a[1], b[1], fma_elem(a[2], b[2], a[3] * b[3])));
+    }
+
+    // wa * a + wb * b, normalized
+    template<typename T>
+    FORCE_INLINE quat<T> quat_blend(const quat<T>& a, const quat<T>& b, const T& wa, const T& wb) {
+        using std::sqrt;
+        quat<T> r;
+        constexpr_for<0, 4, 1>([&](auto I) { r[I] = fma_elem(wa, a[I], wb * b[I]); });
+        const T s = T(1) / sqrt(quat_dot(r, r));
+        constexpr_for<0, 4, 1>([&](auto I) { r[I] = r[I] * s; });
+        return r;
+    }
+}
+
+// Hamilton product a * b: rotating by the result rotates by b, then by a.
+template<tuple_like Q1, tuple_like Q2>
+    requires( detail::quat_like<Q1> and detail::quat_like<Q2> )
+FORCE_INLINE constexpr auto quat_mul(Q1&& q1, Q2&& q2) {
+    using T = detail::quat_value_t<Q1, Q2>;
+    using detail::fma_elem;
+    const auto a = detail::to_elems<T>(std::forward<Q1>(q1));
+    const auto b = detail::to_elems<T>(std::forward<Q2>(q2));
+    return quat<T>{
+        fma_elem(a[3], b[0], fma_elem(a[0], b[3], fma_elem(a[1], b[2], -(a[2] * b[1])))),
+        fma_elem(a[3], b[1], fma_elem(a[1], b[3], fma_elem(a[2], b[0], -(a[0] * b[2])))),
+        fma_elem(a[3], b[2], fma_elem(a[2], b[3], fma_elem(a[0], b[1], -(a[1] * b[0])))),
+        fma_elem(a[3], b[3], -fma_elem(a[0], b[0], fma_elem(a[1], b[1], a[2] * b[2]))) };
+}
+
+// (x, y, z, w) -> (-x, -y, -z, w), the inverse of a unit quaternion.
+template<tuple_like Q>
+    requires( detail::quat_like<Q> )
+FORCE_INLINE constexpr auto quat_conjugate(Q&& q) {
+    using T = detail::quat_value_t<Q>;
+    const auto a = detail::to_elems<T>(std::forward<Q>(q));
+    return quat<T>{-a[0], -a[1], -a[2], a[3]};
+}
+
+// Rotate a 3-vector by a unit quaternion: v + 2w (q x v) + 2 q x (q x v),
+// evaluated as t = 2 q x v, v + w t + q x t.
+template<tuple_like Q, tuple_like V>
+    requires( detail::quat_like<Q> and detail::vec3_like<V> )
+FORCE_INLINE constexpr auto quat_rotate(Q&& q, V&& v) {
+    using T = detail::quat_value_t<Q, V>;
+    using detail::fma_elem;
+    const auto a = detail::to_elems<T>(std::forward<Q>(q));
+    const auto x = detail::to_elems<T>(std::forward<V>(v));
+    const std::array<T, 3> u{a[0], a[1], a[2]};
+    const auto t = cross(u, x) * T(2);
+    const auto c = cross(u, t);
+    std::array<T, 3> ret;
+    constexpr_for<0, 3, 1>([&](auto I) { ret[I] = fma_elem(a[3], t[I], x[I] + c[I]); });
+    return ret;
+}
+
+// Unit quaternion rotating by angle (radians) around a unit axis.
+template<tuple_like V, typename T>
+    requires( detail::vec3_like<V> )
+FORCE_INLINE auto quat_from_axis_angle(V&& axis, T angle) {
+    using std::sin;
+    using std::cos;
+    using U = std::common_type_t<tuple_common_t<V>, T>;
+    const U h = U(angle) * U(0.5);
+    const U s = sin(h);
+    return quat<U>{U(get<0>(axis)) * s, U(get<1>(axis)) * s, U(get<2>(axis)) * s, cos(h)};
+}
+
+// Normalized linear interpolation along the shorter arc.
+template<tuple_like Q1, tuple_like Q2, typename T>
+    requires( detail::quat_like<Q1> and detail::quat_like<Q2> )
+FORCE_INLINE auto nlerp(Q1&& q1, Q2&& q2, T t) {
+    using U = detail::quat_value_t<Q1, Q2>;
+    const auto a = detail::to_elems<U>(std::forward<Q1>(q1));
+    const auto b = detail::to_elems<U>(std::forward<Q2>(q2));
+    const U u = U(t);
+    const U wb = detail::lane_select<U>(detail::quat_dot(a, b) < U(0), -u, u);
+    return detail::quat_blend(a, b, U(1) - u, wb);
+}
+
+// Spherical linear interpolation along the shorter arc, at constant angular velocity.
+// Falls back to nlerp when the quaternions are nearly parallel.
+template<tuple_like Q1, tuple_like Q2, typename T>
+    requires( detail::quat_like<Q1> and detail::quat_like<Q2> )
+FORCE_INLINE auto slerp(Q1&& q1, Q2&& q2, T t) {
+    using std::abs;
+    using std::acos;
+    using std::sin;
+    using U = detail::quat_value_t<Q1, Q2>;
+    const auto a = detail::to_elems<U>(std::forward<Q1>(q1));
+    const auto b = detail::to_elems<U>(std::forward<Q2>(q2));
+    const U u = U(t);
+    const U d = detail::quat_dot(a, b);
+    const U ad = abs(d);
+    const auto near = ad > U(0.9995);
+    const U theta = acos(detail::lane_select<U>(near, U(0), ad));
+    const U r = U(1) / detail::lane_select<U>(near, U(1), sin(theta));
+    U wa = detail::lane_select<U>(near, U(1) - u, sin((U(1) - u) * theta) * r);
+    U wb = detail::lane_select<U>(near, u, sin(u * theta) * r);
+    wb = detail::lane_select<U>(d < U(0), -wb, wb);
+    return detail::quat_blend(a, b, wa, wb);
+}
+
+// Rotation matrix of a unit quaternion: quat_rotate(q, v) == matmul(quat_to_mat(q), v).
+template<tuple_like Q>
+    requires( detail::quat_like<Q> )
+FORCE_INLINE constexpr auto quat_to_mat(Q&& q) {
+    using T = detail::quat_value_t<Q>;
+    const auto a = detail::to_elems<T>(std::forward<Q>(q));
+    const T x2 = a[0] + a[0], y2 = a[1] + a[1], z2 = a[2] + a[2];
+    const T xx = a[0] * x2, yy = a[1] * y2, zz = a[2] * z2;
+    const T xy = a[0] * y2, xz = a[0] * z2, yz = a[1] * z2;
+    const T wx = a[3] * x2, wy = a[3] * y2, wz = a[3] * z2;
+    return mat<T, 3>{{
+        {T(1) - (yy + zz), xy - wz, xz + wy},
+        {xy + wz, T(1) - (xx + zz), yz - wx},
+        {xz - wy, yz + wx, T(1) - (xx + yy)} }};
+}
+
+/**
+ * Unit quaternion of a rotation matrix. The component with the largest magnitude is
+ * computed from the diagonal and the others from off-diagonal sums, which is accurate
+ * for all rotations; the choice is made with selects, so it also works lane-wise.
+ */
+template<tuple_like M>
+    requires( detail::square_matrix<M> and detail::rows_v<M> == 3 )
+FORCE_INLINE auto quat_from_mat(M&& m) {
+    using std::sqrt;
+    using detail::lane_select;
+    using T = detail::inverse_value_t<detail::matrix_value_t<M>>;
+    const auto a = detail::to_mat<T>(std::forward<M>(m));
+    // 4 w^2, 4 x^2, 4 y^2, 4 z^2
+    const T tw = T(1) + a[0][0] + a[1][1] + a[2][2];
+    const T tx = T(1) + a[0][0] - a[1][1] - a[2][2];
+    const T ty = T(1) - a[0][0] + a[1][1] - a[2][2];
+    const T tz = T(1) - a[0][0] - a[1][1] + a[2][2];
+    const auto is_x = (tx > tw) & (tx >= ty) & (tx >= tz);
+    const auto is_y = (ty > tw) & (ty > tx) & (ty >= tz);
+    const auto is_z = (tz > tw) & (tz > tx) & (tz > ty);
+    const T t = lane_select<T>(is_x, tx, lane_select<T>(is_y, ty, lane_select<T>(is_z, tz, tw)));
+    const T r = sqrt(t);
+    const T s = T(0.5) / r;
+    const T h = T(0.5) * r;
+    const T dx = (a[2][1] - a[1][2]) * s, dy = (a[0][2] - a[2][0]) * s, dz = (a[1][0] - a[0][1]) * s;
+    const T sxy = (a[0][1] + a[1][0]) * s, sxz = (a[0][2] + a[2][0]) * s, syz = (a[1][2] + a[2][1]) * s;
+    return quat<T>{
+        lane_select<T>(is_x, h, lane_select<T>(is_y, sxy, lane_select<T>(is_z, sxz, dx))),
+        lane_select<T>(is_x, sxy, lane_select<T>(is_y, h, lane_select<T>(is_z, syz, dy))),
+        lane_select<T>(is_x, sxz, lane_select<T>(is_y, syz, lane_select<T>(is_z, h, dz))),
+        lane_select<T>(is_x, dx, lane_select<T>(is_y, dy, lane_select<T>(is_z, dz, h))) };
+}
+
+TP_EXIT_NS
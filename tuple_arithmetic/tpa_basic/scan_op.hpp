@@ -0,0 +1,60 @@
+#include "defines.hpp"
+#include "basics.hpp"
+#include "functions.hpp"
+#include "binary_op.hpp"
+
+#pragma once
+
+TP_ENTER_NS
+
+// Scan operation
+namespace detail {
+    // acc holds s_0, ..., s_{K-1}; append s_K = op(s_{K-1}, get<K-Off>(tp)) until End.
+    template<size_t K, size_t End, size_t Off, typename Op, typename Tp, typename Acc>
+    FORCE_INLINE constexpr auto scan_impl(Op& op, Tp& tp, Acc&& acc) {
+        if constexpr (K == End) {
+            return std::forward<Acc>(acc);
+        }
+        else {
+            auto next = op(std::get<K-1>(acc), get<K-Off>(tp));
+            return scan_impl<K+1, End, Off>(op, tp, std::tuple_cat(std::forward<Acc>(acc), std::make_tuple(next)));
+        }
+    }
+
+    template<typename T>
+    concept scan_op = not tuple_like<T>;
+}
+
+// (a1, a2, a3, ...) -> (a1, op(a1, a2), op(op(a1, a2), a3), ...)
+template<detail::scan_op Op, tuple_like Tp>
+    requires( std::tuple_size_v<std::remove_cvref_t<Tp>> > 0 )
+FORCE_INLINE constexpr auto inclusive_scan(Op&& op, Tp&& tp) {
+    constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<Tp>>;
+    return TP_CONVERT((detail::scan_impl<1, N, 0>(op, tp, std::make_tuple(get<0>(tp)))));
+}
+
+// (a1, a2, a3, ...), init -> (init, op(init, a1), op(op(init, a1), a2), ...)
+template<detail::scan_op Op, tuple_like Tp, typename T>
+    requires( std::tuple_size_v<std::remove_cvref_t<Tp>> > 0 )
+FORCE_INLINE constexpr auto exclusive_scan(Op&& op, Tp&& tp, T&& init) {
+    constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<Tp>>;
+    return TP_CONVERT((detail::scan_impl<1, N, 1>(op, tp, std::make_tuple(std::forward<T>(init)))));
+}
+
+// (a1, a2, a3, ...) -> (a1, a1 + a2, a1 + a2 + a3, ...)
+template<tuple_like Tp>
+FORCE_INLINE constexpr auto inclusive_scan(Tp&& tp) {
+    return inclusive_scan(
+            [](auto&& a, auto&& b) { return a + b; },
+            std::forward<Tp>(tp));
+}
+
+// (a1, a2, a3, ...), init -> (init, init + a1, init + a1 + a2, ...)
+template<tuple_like Tp, typename T>
+FORCE_INLINE constexpr auto exclusive_scan(Tp&& tp, T&& init) {
+    return exclusive_scan(
+            [](auto&& a, auto&& b) { return a + b; },
+            std::forward<Tp>(tp), std::forward<T>(init));
+}
+
+TP_EXIT_NS
@@ -0,0 +1,55 @@
+#include "defines.hpp"
+#include "basics.hpp"
+#include "functions.hpp"
+#include "assign.hpp"
+#include "binary_op.hpp"
+#include <concepts>
+
+#pragma once
+
+TP_ENTER_NS
+
+// Scatter-add
+namespace detail {
+    // dst += v, element-wise if dst is tuple-like.
+    template<typename Dst, typename V>
+    FORCE_INLINE constexpr void add_to(Dst&& dst, V&& v) {
+        if constexpr (tuple_like<Dst>)
+            assign(dst, dst + std::forward<V>(v));
+        else
+            dst += std::forward<V>(v);
+    }
+
+    template<typename T>
+    concept scatter_index = std::integral<std::remove_cvref_t<T>> or tuple_like<T>;
+}
+
+// ptr[idx] += val, where ptr[idx] may itself be tuple-like (AoS bins).
+template<typename Ptr, typename Idx, typename Val>
+    requires( not tuple_like<Ptr> and std::integral<std::remove_cvref_t<Idx>> )
+FORCE_INLINE constexpr void scatter_add(Ptr&& ptr, Idx&& idx, Val&& val) {
+    detail::add_to(ptr[idx], std::forward<Val>(val));
+}
+
+// (i1, i2, ...), (v1, v2, ...) -> ptr[i1] += v1, ptr[i2] += v2, ...
+// Duplicated indices accumulate. val is broadcast if it is not tuple-like.
+template<typename Ptr, tuple_like Idx, typename Val>
+    requires( not tuple_like<Ptr> )
+FORCE_INLINE constexpr void scatter_add(Ptr&& ptr, Idx&& idx, Val&& val) {
+    decltype(auto) tv = detail::broadcast<Idx>(std::forward<Val>(val));
+    constexpr_for<0, std::tuple_size_v<std::remove_cvref_t<Idx>>, 1>([&](auto I) {
+        detail::add_to(ptr[get<I>(idx)], get<I>(tv));
+    });
+}
+
+// SoA bins: (p1, p2, ...), idx, (v1, v2, ...) -> scatter_add(p1, idx, v1), scatter_add(p2, idx, v2), ...
+template<tuple_like Ptrs, typename Idx, typename Val>
+    requires( detail::scatter_index<Idx> )
+FORCE_INLINE constexpr void scatter_add(Ptrs&& ptrs, Idx&& idx, Val&& val) {
+    decltype(auto) tv = detail::broadcast<Ptrs>(std::forward<Val>(val));
+    constexpr_for<0, std::tuple_size_v<std::remove_cvref_t<Ptrs>>, 1>([&](auto I) {
+        scatter_add(get<I>(ptrs), idx, get<I>(tv));
+    });
+}
+
+TP_EXIT_NS
@@ -0,0 +1,209 @@
+#include "defines.hpp"
+#include "basics.hpp"
+#include "functions.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#pragma once
+
+TP_ENTER_NS
+
+// Sorting networks
+namespace detail {
+    struct comparator {
+        size_t lo, hi;
+    };
+
+    /**
+     * Batcher's odd-even merge sort for arbitrary n (Knuth, TAOCP 5.2.2, exercise 5.2.2-19).
+     * Calls fn(comparator) for every compare-exchange, in order.
+     */
+    template<typename Fn>
+    constexpr void batcher_network(size_t n, Fn&& fn) {
+        for (size_t p = 1; p < n; p *= 2)
+            for (size_t k = p; k >= 1; k /= 2)
+                for (size_t j = k % p; j + k < n; j += 2 * k)
+                    for (size_t i = 0; i < k and i + j + k < n; ++i)
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                            fn(comparator{i + j, i + j + k});
+    }
+
+    /**
+     * Compile-time sorting network of N inputs.
+     * Only comparators that can affect the positions set in Outputs are kept,
+     * so selecting a single order statistic uses a fraction of a full sort.
+     * Comparators are also grouped into layers of disjoint pairs, for lane-parallel
+     * evaluation: in layer l, lane i is compared with lane partner[l][i].
+     */
+    template<size_t N, uint64_t Outputs = ~uint64_t(0)>
+    struct sorting_network {
+        static_assert(N <= 64, "sorting networks support at most 64 inputs");
+
+        static constexpr size_t full_size = [] {
+            size_t n = 0;
+            batcher_network(N, [&n](comparator) { ++n; });
+            return n;
+        }();
+
+        static constexpr auto full = [] {
+            std::array<comparator, full_size> ret{};
+            size_t n = 0;
+            batcher_network(N, [&](comparator c) { ret[n++] = c; });
+            return ret;
+        }();
+
+        static constexpr auto keep = [] {
+            std::array<bool, full_size> ret{};
+            uint64_t live = N == 64 ? Outputs : Outputs & ((uint64_t(1) << N) - 1);
+            for (size_t c = full_size; c-- > 0;) {
+                const uint64_t bits = (uint64_t(1) << full[c].lo) | (uint64_t(1) << full[c].hi);
+                if (live & bits) {
+                    ret[c] = true;
+                    live |= bits;
+                }
+            }
+            return ret;
+        }();
+
+        static constexpr size_t size = [] {
+            size_t n = 0;
+            for (bool k : keep) n += k;
+            return n;
+        }();
+
+        static constexpr auto pairs = [] {
+            std::array<comparator, size> ret{};
+            size_t n = 0;
+            for (size_t c = 0; c < full_size; ++c)
+                if (keep[c]) ret[n++] = full[c];
+            return ret;
+        }();
+
+        static constexpr auto layer_of = [] {
+            std::array<size_t, size> ret{};
+            std::array<size_t, N> last{};
+            for (size_t c = 0; c < size; ++c) {
+                const size_t l = std::max(last[pairs[c].lo], last[pairs[c].hi]);
+                ret[c] = l;
+                last[pairs[c].lo] = last[pairs[c].hi] = l + 1;
+            }
+            return ret;
+        }();
+
+        static constexpr size_t depth = [] {
+            size_t d = 0;
+            for (size_t l : layer_of) d = std::max(d, l + 1);
+            return d;
+        }();
+
+        static constexpr auto partner = [] {
+            std::array<std::array<size_t, N>, depth> ret{};
+            for (auto& layer : ret)
+                for (size_t i = 0; i < N; ++i)
+                    layer[i] = i;
+            for (size_t c = 0; c < size; ++c) {
+                ret[layer_of[c]][pairs[c].lo] = pairs[c].hi;
+                ret[layer_of[c]][pairs[c].hi] = pairs[c].lo;
+            }
+            return ret;
+        }();
+    };
+
+    // (a, b) -> (min, max); a swap, so the result is a permutation even with NaNs.
+    template<typename T>
+    FORCE_INLINE constexpr void compare_exchange(T& a, T& b) {
+        using traits = sort_traits<T>;
+        const auto swap = b < a;
+        const T lo = traits::select(swap, b, a);
+        b = traits::select(swap, a, b);
+        a = lo;
+    }
+
+    template<typename T, typename I>
+    FORCE_INLINE constexpr void compare_exchange(T& a, T& b, I& ia, I& ib) {
+        using traits = sort_traits<T>;
+        const auto swap = b < a;
+        const T lo = traits::select(swap, b, a);
+        const I ilo = traits::select(swap, ib, ia);
+        b = traits::select(swap, a, b);
+        ib = traits::select(swap, ia, ib);
+        a = lo;
+        ia = ilo;
+    }
+
+    template<tuple_like Tp, size_t...I>
+    FORCE_INLINE constexpr auto sort_values(Tp&& tp, std::index_sequence<I...>) {
+        using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+        return std::array<T, sizeof...(I)>{ get<I>(tp)... };
+    }
+
+    template<typename Net, typename T, size_t N>
+    FORCE_INLINE constexpr void run_network(std::array<T, N>& v) {
+        constexpr_for<0, Net::size, 1>([&v](auto C) {
+            constexpr comparator c = Net::pairs[C];
+            compare_exchange(v[c.lo], v[c.hi]);
+        });
+    }
+
+    template<typename Tp>
+    concept sortable_tuple = same_type_tuple<Tp> and (std::tuple_size_v<std::remove_cvref_t<Tp>> > 0);
+}
+
+// Sort elements of a same-type tuple in ascending order with a sorting network.
+// Returns an std::array. For a tuple of xsimd batches, every lane is sorted independently.
+template<tuple_like Tp>
+    requires( detail::sortable_tuple<Tp> )
+FORCE_INLINE constexpr auto sort(Tp&& tp) {
+    constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<Tp>>;
+    auto v = detail::sort_values(std::forward<Tp>(tp), std::make_index_sequence<N>{});
+    detail::run_network<detail::sorting_network<N>>(v);
+    return v;
+}
+
+// Indices that sort the tuple: get<argsort(tp)[k]>(tp) is the k-th smallest element.
+// The order of equal elements is unspecified.
+template<tuple_like Tp>
+    requires( detail::sortable_tuple<Tp> )
+FORCE_INLINE constexpr auto argsort(Tp&& tp) {
+    constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<Tp>>;
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+    using traits = detail::sort_traits<T>;
+    auto v = detail::sort_values(std::forward<Tp>(tp), std::make_index_sequence<N>{});
+    std::array<typename traits::index_type, N> idx;
+    constexpr_for<0, N, 1>([&idx](auto I) { idx[I] = traits::index(I); });
+    constexpr_for<0, detail::sorting_network<N>::size, 1>([&](auto C) {
+        constexpr detail::comparator c = detail::sorting_network<N>::pairs[C];
+        detail::compare_exchange(v[c.lo], v[c.hi], idx[c.lo], idx[c.hi]);
+    });
+    return idx;
+}
+
+// K-th smallest element, using only the comparators of the network that K depends on.
+template<size_t K, tuple_like Tp>
+    requires( detail::sortable_tuple<Tp> )
+FORCE_INLINE constexpr auto nth_element(Tp&& tp) {
+    constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<Tp>>;
+    static_assert(K < N, "nth_element: K out of range");
+    auto v = detail::sort_values(std::forward<Tp>(tp), std::make_index_sequence<N>{});
+    detail::run_network<detail::sorting_network<N, uint64_t(1) << K>>(v);
+    return v[K];
+}
+
+// Middle element; mean of the two middle elements for even sizes.
+template<tuple_like Tp>
+    requires( detail::sortable_tuple<Tp> )
+FORCE_INLINE constexpr auto median(Tp&& tp) {
+    constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<Tp>>;
+    auto v = detail::sort_values(std::forward<Tp>(tp), std::make_index_sequence<N>{});
+    if constexpr (N % 2 == 1) {
+        detail::run_network<detail::sorting_network<N, uint64_t(1) << (N/2)>>(v);
+        return v[N/2];
+    }
+    else {
+        detail::run_network<detail::sorting_network<N, uint64_t(3) << (N/2 - 1)>>(v);
+        return v[N/2 - 1] + (v[N/2] - v[N/2 - 1]) / 2;
+    }
+}
+
+TP_EXIT_NS
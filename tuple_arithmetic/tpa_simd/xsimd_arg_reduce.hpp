@@ -0,0 +1,103 @@
+#include <bit>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tpa_basic/basics.hpp"
+#include "../tpa_basic/arg_reduce_op.hpp"
+#include "xsimd_cast.hpp"
+#include "xsimd_tpa_op.hpp"
+#include "xsimd_permute.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    /**
+     * Horizontal (value, index) reduction of a batch with log2(W) butterfly steps.
+     * Ties and pairs of NaNs go to the smaller index, so the result matches the
+     * left-to-right fold of the lanes.
+     */
+    template<bool Max, typename T, typename A, typename I>
+    FORCE_INLINE auto reduce_extremum(xsimd::batch<T, A> x, xsimd::batch<I, A> idx) {
+        constexpr size_t W = xsimd::batch<T, A>::size;
+        constexpr_for<0, std::bit_width(W) - 1, 1>([&](auto K) {
+            constexpr size_t S = size_t(1) << decltype(K)::value;
+            const auto y = butterfly_lanes<S>(x);
+            const auto iy = butterfly_lanes<S>(idx);
+            const auto take = extremum_better<Max>(y, x) |
+                (~extremum_better<Max>(x, y) & xsimd::batch_bool_cast<T>(iy < idx));
+            idx = xsimd::select(xsimd::batch_bool_cast<I>(take), iy, idx);
+            x = xsimd::select(take, y, x);
+        });
+        return std::pair{to_array(x)[0], size_t(to_array(idx)[0])};
+    }
+
+    template<typename Tp>
+    concept simd_arg_reduce_tuple = arg_reducible<Tp> and same_type_tuple<Tp> and
+        std::is_arithmetic_v<std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>> and
+        has_simd<std::tuple_element_t<0, std::remove_cvref_t<Tp>>, std::tuple_size_v<std::remove_cvref_t<Tp>>>;
+}
+
+// Lanes of a batch -> (min, lane of the first min). NaN lanes win over numbers.
+template<typename T, typename A>
+FORCE_INLINE auto min_element(const xsimd::batch<T, A>& x) {
+    return detail::reduce_extremum<false>(x, detail::lane_indices<T, A>());
+}
+
+template<typename T, typename A>
+FORCE_INLINE auto max_element(const xsimd::batch<T, A>& x) {
+    return detail::reduce_extremum<true>(x, detail::lane_indices<T, A>());
+}
+
+template<typename T, typename A>
+FORCE_INLINE auto minmax_element(const xsimd::batch<T, A>& x) {
+    const auto idx = detail::lane_indices<T, A>();
+    return std::pair{detail::reduce_extremum<false>(x, idx), detail::reduce_extremum<true>(x, idx)};
+}
+
+template<typename T, typename A>
+FORCE_INLINE size_t argmin(const xsimd::batch<T, A>& x) {
+    return min_element(x).second;
+}
+
+template<typename T, typename A>
+FORCE_INLINE size_t argmax(const xsimd::batch<T, A>& x) {
+    return max_element(x).second;
+}
+
+// Same-type arithmetic tuples that fit in a batch are reduced across lanes.
+template<tuple_like Tp>
+    requires( detail::simd_arg_reduce_tuple<Tp> )
+FORCE_INLINE auto min_element(Tp&& tp) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+    return min_element(to_simd<T>(std::forward<Tp>(tp)));
+}
+
+template<tuple_like Tp>
+    requires( detail::simd_arg_reduce_tuple<Tp> )
+FORCE_INLINE auto max_element(Tp&& tp) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+    return max_element(to_simd<T>(std::forward<Tp>(tp)));
+}
+
+template<tuple_like Tp>
+    requires( detail::simd_arg_reduce_tuple<Tp> )
+FORCE_INLINE auto minmax_element(Tp&& tp) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+    return minmax_element(to_simd<T>(std::forward<Tp>(tp)));
+}
+
+template<tuple_like Tp>
+    requires( detail::simd_arg_reduce_tuple<Tp> )
+FORCE_INLINE size_t argmin(Tp&& tp) {
+    return min_element(std::forward<Tp>(tp)).second;
+}
+
+template<tuple_like Tp>
+    requires( detail::simd_arg_reduce_tuple<Tp> )
+FORCE_INLINE size_t argmax(Tp&& tp) {
+    return max_element(std::forward<Tp>(tp)).second;
+}
+
+}
@@ -0,0 +1,261 @@
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tpa_basic/basics.hpp"
+#include "../tpa_basic/matrix.hpp"
+#include "xsimd_cast.hpp"
+#include "xsimd_tpa_op.hpp"
+#include "xsimd_permute.hpp"
+
+#pragma once
+
+namespace tpa {
+
+/**
+ * 2x2, 3x3 and 4x4 matrices of a single arithmetic type, kept in 4-lane batches:
+ * a 2x2 matrix as one batch (m00, m01, m10, m11), larger ones as one batch per
+ * row, 3-element rows padded with a zero lane.
+ */
+namespace detail {
+    template<typename M>
+    concept uniform_matrix = matrix_like<M> and
+        []<size_t...I>(std::index_sequence<I...>) {
+            return (same_type_tuple<std::tuple_element_t<I, std::remove_cvref_t<M>>> && ...) and
+                (std::is_same_v<matrix_value_t<M>,
+                    std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<std::tuple_element_t<I, std::remove_cvref_t<M>>>>>> && ...);
+        }(std::make_index_sequence<rows_v<M>>{});
+
+    template<typename M>
+    concept simd_matrix = square_matrix<M> and uniform_matrix<M> and
+        std::is_floating_point_v<matrix_value_t<M>> and
+        rows_v<M> >= 2 and rows_v<M> <= 4 and has_simd<matrix_value_t<M>, 4>;
+
+    template<typename V, typename T, size_t N>
+    concept simd_vector_of = same_type_tuple<V> and tpa_tuple_size_v<V> == N and
+        std::is_same_v<std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<V>>>, T>;
+
+    template<typename T>
+    using mat_simd_t = xsimd::make_sized_batch_t<T, 4>;
+
+    template<typename M>
+    FORCE_INLINE auto load_rows(M&& m) {
+        using T = matrix_value_t<M>;
+        using simd_t = mat_simd_t<T>;
+        constexpr size_t N = rows_v<M>;
+        std::array<simd_t, N> rows;
+        constexpr_for<0, N, 1>([&](auto I) {
+            const auto& r = get<I>(m);
+            if constexpr (N == 4)
+                rows[I] = to_simd<T>(r);
+            else if constexpr (N == 3)
+                rows[I] = simd_t(get<0>(r), get<1>(r), get<2>(r), T(0));
+            else
+                rows[I] = simd_t(get<0>(r), get<1>(r), T(0), T(0));
+        });
+        return rows;
+    }
+
+    // First N lanes of the first N rows
+    template<size_t N, typename T, typename A, size_t R>
+    FORCE_INLINE auto store_rows(const std::array<xsimd::batch<T, A>, R>& rows) {
+        mat<T, N, N> ret;
+        constexpr_for<0, N, 1>([&](auto I) {
+            const auto r = to_array(rows[I]);
+            constexpr_for<0, N, 1>([&](auto J) { ret[I][J] = r[J]; });
+        });
+        return ret;
+    }
+
+    // 2x2 matrix in one batch
+    template<typename M>
+    FORCE_INLINE auto load_mat2(M&& m) {
+        using T = matrix_value_t<M>;
+        return mat_simd_t<T>(get<0>(get<0>(m)), get<1>(get<0>(m)), get<0>(get<1>(m)), get<1>(get<1>(m)));
+    }
+
+    template<typename T, typename A>
+    FORCE_INLINE auto store_mat2(const xsimd::batch<T, A>& x) {
+        const auto v = to_array(x);
+        return mat<T, 2, 2>{{ {v[0], v[1]}, {v[2], v[3]} }};
+    }
+
+    // 2x2 products on packed matrices: a * b, adj(a) * b, a * adj(b)
+    template<typename S>
+    FORCE_INLINE S mat2_mul(const S& a, const S& b) {
+        return xsimd::fma(a, permute<0, 3, 0, 3>(b), permute<1, 0, 3, 2>(a) * permute<2, 1, 2, 1>(b));
+    }
+    template<typename S>
+    FORCE_INLINE S mat2_adj_mul(const S& a, const S& b) {
+        return xsimd::fms(permute<3, 3, 0, 0>(a), b, permute<1, 1, 2, 2>(a) * permute<2, 3, 0, 1>(b));
+    }
+    template<typename S>
+    FORCE_INLINE S mat2_mul_adj(const S& a, const S& b) {
+        return xsimd::fms(a, permute<3, 0, 3, 0>(b), permute<1, 0, 3, 2>(a) * permute<2, 1, 2, 1>(b));
+    }
+
+    // Transpose of 4 rows, in two rounds of interleaving.
+    template<typename S>
+    FORCE_INLINE std::array<S, 4> transpose_rows(const std::array<S, 4>& r) {
+        const S t0 = xsimd::zip_lo(r[0], r[1]);
+        const S t1 = xsimd::zip_lo(r[2], r[3]);
+        const S t2 = xsimd::zip_hi(r[0], r[1]);
+        const S t3 = xsimd::zip_hi(r[2], r[3]);
+        return {shuffle<0, 1, 4, 5>(t0, t1), shuffle<2, 3, 6, 7>(t0, t1),
+                shuffle<0, 1, 4, 5>(t2, t3), shuffle<2, 3, 6, 7>(t2, t3)};
+    }
+
+    template<typename S, size_t N>
+    FORCE_INLINE std::array<S, 4> padded_rows(const std::array<S, N>& r) {
+        if constexpr (N == 4)
+            return r;
+        else
+            return {r[0], r[1], r[2], S(0)};
+    }
+
+    // Padded 3-vector cross product
+    template<typename S>
+    FORCE_INLINE S cross3(const S& a, const S& b) {
+        return xsimd::fms(permute<1, 2, 0, 3>(a), permute<2, 0, 1, 3>(b),
+                          permute<2, 0, 1, 3>(a) * permute<1, 2, 0, 3>(b));
+    }
+
+    /**
+     * 4x4 inverse by 2x2 blocks [A B; C D]: the blocks and their determinants
+     * are formed with shuffles, then the adjugate is assembled with 2x2 products.
+     * Returns the rows of the adjugate, det(m) * inverse(m), and det(m) in every lane.
+     */
+    template<typename S>
+    FORCE_INLINE auto adjugate4(const std::array<S, 4>& r) {
+        const S A = shuffle<0, 1, 4, 5>(r[0], r[1]);
+        const S B = shuffle<2, 3, 6, 7>(r[0], r[1]);
+        const S C = shuffle<0, 1, 4, 5>(r[2], r[3]);
+        const S D = shuffle<2, 3, 6, 7>(r[2], r[3]);
+        const S det_sub = xsimd::fms(shuffle<0, 2, 4, 6>(r[0], r[2]), shuffle<1, 3, 5, 7>(r[1], r[3]),
+                                     shuffle<1, 3, 5, 7>(r[0], r[2]) * shuffle<0, 2, 4, 6>(r[1], r[3]));
+        const S det_a = permute<0, 0, 0, 0>(det_sub);
+        const S det_b = permute<1, 1, 1, 1>(det_sub);
+        const S det_c = permute<2, 2, 2, 2>(det_sub);
+        const S det_d = permute<3, 3, 3, 3>(det_sub);
+        const S d_c = mat2_adj_mul(D, C);
+        const S a_b = mat2_adj_mul(A, B);
+        const S x = xsimd::fms(det_d, A, mat2_mul(B, d_c));
+        const S w = xsimd::fms(det_a, D, mat2_mul(C, a_b));
+        const S y = xsimd::fms(det_b, C, mat2_mul_adj(D, a_b));
+        const S z = xsimd::fms(det_c, B, mat2_mul_adj(A, d_c));
+        const auto tr = xsimd::reduce_add(a_b * permute<0, 2, 1, 3>(d_c));
+        const S det = xsimd::fma(det_a, det_d, det_b * det_c) - S(tr);
+        using T = typename S::value_type;
+        const S sign(T(1), T(-1), T(-1), T(1));
+        const S xs = x * sign, ys = y * sign, zs = z * sign, ws = w * sign;
+        return std::pair{std::array<S, 4>{
+            shuffle<3, 1, 7, 5>(xs, ys), shuffle<2, 0, 6, 4>(xs, ys),
+            shuffle<3, 1, 7, 5>(zs, ws), shuffle<2, 0, 6, 4>(zs, ws)}, det};
+    }
+}
+
+template<tuple_like M>
+    requires( detail::simd_matrix<M> )
+FORCE_INLINE auto transpose(M&& m) {
+    constexpr size_t N = detail::rows_v<M>;
+    if constexpr (N == 2)
+        return detail::store_mat2(permute<0, 2, 1, 3>(detail::load_mat2(m)));
+    else {
+        const auto t = detail::transpose_rows(detail::padded_rows(detail::load_rows(m)));
+        return detail::store_rows<N>(t);
+    }
+}
+
+// Row i of the product is the sum of rows of x scaled by m[i][k].
+template<tuple_like M, tuple_like X>
+    requires( detail::simd_matrix<M> and detail::simd_matrix<X> and
+              detail::rows_v<M> == detail::rows_v<X> and
+              std::is_same_v<detail::matrix_value_t<M>, detail::matrix_value_t<X>> )
+FORCE_INLINE auto matmul(M&& m, X&& x) {
+    using T = detail::matrix_value_t<M>;
+    using simd_t = detail::mat_simd_t<T>;
+    constexpr size_t N = detail::rows_v<M>;
+    if constexpr (N == 2)
+        return detail::store_mat2(detail::mat2_mul(detail::load_mat2(m), detail::load_mat2(x)));
+    else {
+        const auto b = detail::load_rows(x);
+        std::array<simd_t, N> ret;
+        constexpr_for<0, N, 1>([&](auto I) {
+            const auto& row = get<I>(m);
+            simd_t acc = simd_t(T(get<0>(row))) * b[0];
+            constexpr_for<1, N, 1>([&](auto K) {
+                acc = xsimd::fma(simd_t(T(get<K>(row))), b[K], acc);
+            });
+            ret[I] = acc;
+        });
+        return detail::store_rows<N>(ret);
+    }
+}
+
+// Matrix-vector product: the sum of columns of m scaled by v[k].
+template<tuple_like M, tuple_like V>
+    requires( detail::simd_matrix<M> and detail::rows_v<M> != 2 and
+              detail::simd_vector_of<V, detail::matrix_value_t<M>, detail::rows_v<M>> )
+FORCE_INLINE auto matmul(M&& m, V&& v) {
+    using T = detail::matrix_value_t<M>;
+    using simd_t = detail::mat_simd_t<T>;
+    constexpr size_t N = detail::rows_v<M>;
+    const auto cols = detail::transpose_rows(detail::padded_rows(detail::load_rows(m)));
+    simd_t acc = simd_t(T(get<0>(v))) * cols[0];
+    constexpr_for<1, N, 1>([&](auto K) {
+        acc = xsimd::fma(simd_t(T(get<K>(v))), cols[K], acc);
+    });
+    const auto r = to_array(acc);
+    std::array<T, N> ret;
+    constexpr_for<0, N, 1>([&](auto I) { ret[I] = r[I]; });
+    return ret;
+}
+
+template<tuple_like M>
+    requires( detail::simd_matrix<M> )
+FORCE_INLINE auto det(M&& m) {
+    constexpr size_t N = detail::rows_v<M>;
+    if constexpr (N == 2) {
+        const auto a = detail::load_mat2(m);
+        const auto s = to_array(a * permute<3, 2, 1, 0>(a));
+        return s[0] - s[1];
+    }
+    else if constexpr (N == 3) {
+        const auto r = detail::load_rows(m);
+        return xsimd::reduce_add(r[0] * detail::cross3(r[1], r[2]));
+    }
+    else
+        return to_array(detail::adjugate4(detail::load_rows(m)).second)[0];
+}
+
+template<tuple_like M>
+    requires( detail::simd_matrix<M> )
+FORCE_INLINE auto inverse(M&& m) {
+    using T = detail::matrix_value_t<M>;
+    using simd_t = detail::mat_simd_t<T>;
+    constexpr size_t N = detail::rows_v<M>;
+    if constexpr (N == 2) {
+        // adj((a, b, c, d)) = (d, -b, -c, a)
+        const auto a = detail::load_mat2(m);
+        const auto s = to_array(a * permute<3, 2, 1, 0>(a));
+        const simd_t sign(T(1), T(-1), T(-1), T(1));
+        return detail::store_mat2(permute<3, 1, 2, 0>(a) * (sign / simd_t(s[0] - s[1])));
+    }
+    else if constexpr (N == 3) {
+        const auto r = detail::load_rows(m);
+        const std::array<simd_t, 3> adj_t{detail::cross3(r[1], r[2]), detail::cross3(r[2], r[0]), detail::cross3(r[0], r[1])};
+        const simd_t rdet = simd_t(T(1)) / simd_t(xsimd::reduce_add(r[0] * adj_t[0]));
+        auto inv = detail::transpose_rows(detail::padded_rows(adj_t));
+        constexpr_for<0, 3, 1>([&](auto I) { inv[I] *= rdet; });
+        return detail::store_rows<3>(inv);
+    }
+    else {
+        const auto [adj, d] = detail::adjugate4(detail::load_rows(m));
+        const simd_t rdet = simd_t(T(1)) / d;
+        std::array<simd_t, 4> inv;
+        constexpr_for<0, 4, 1>([&](auto I) { inv[I] = adj[I] * rdet; });
+        return detail::store_rows<4>(inv);
+    }
+}
+
+}
@@ -0,0 +1,148 @@
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tpa_basic/basics.hpp"
+#include "../tpa_basic/functions.hpp"
+#include "xsimd_cast.hpp"
+#include "xsimd_tpa_op.hpp"
+
+#pragma once
+
+namespace tpa {
+
+/**
+ * Compile-time lane permutations. On batches they lower to xsimd::swizzle and
+ * xsimd::shuffle; so do permutations of same-type arithmetic tuple temporaries
+ * that fit in a batch, which are returned as std::arrays. Permutations of
+ * lvalue tuples still return tuples of references.
+ */
+namespace detail {
+    // Lane indices 0, 1, ..., W-1 as a batch of integers of the same width as T.
+    template<typename T, typename A>
+    FORCE_INLINE auto lane_indices() {
+        using int_t = xsimd::as_integer_t<T>;
+        using ib_t = xsimd::batch<int_t, A>;
+        alignas(A::alignment()) std::array<int_t, ib_t::size> lanes;
+        for (size_t i = 0; i < lanes.size(); ++i)
+            lanes[i] = int_t(i);
+        return ib_t::load_aligned(lanes.data());
+    }
+
+    template<typename T, typename A, size_t...I>
+    using lane_constant = xsimd::batch_constant<xsimd::as_unsigned_integer_t<T>, A, xsimd::as_unsigned_integer_t<T>(I)...>;
+
+    template<typename Tp>
+    concept simd_permute_tuple = same_type_tuple<Tp> and not std::is_lvalue_reference_v<Tp> and
+        std::is_arithmetic_v<std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>> and
+        has_simd<std::tuple_element_t<0, std::remove_cvref_t<Tp>>, std::tuple_size_v<std::remove_cvref_t<Tp>>>;
+
+    template<typename X> struct lane_count : std::tuple_size<std::remove_cvref_t<X>> {};
+    template<typename T, typename A> struct lane_count<xsimd::batch<T, A>> : std::integral_constant<size_t, xsimd::batch<T, A>::size> {};
+    template<typename X> static constexpr size_t lane_count_v = lane_count<std::remove_cvref_t<X>>::value;
+
+    // permute<Map::at(0, W), Map::at(1, W), ...>(x) for the W lanes or elements of x.
+    template<typename Map, typename X, size_t...I>
+    FORCE_INLINE auto permute_map(X&& x, std::index_sequence<I...>);
+
+    template<size_t J> struct broadcast_map { static constexpr size_t at(size_t, size_t) { return J; } };
+    template<size_t S> struct rotate_map { static constexpr size_t at(size_t i, size_t w) { return (i + S) % w; } };
+    struct reverse_map { static constexpr size_t at(size_t i, size_t w) { return w - 1 - i; } };
+    template<size_t S> struct butterfly_map { static constexpr size_t at(size_t i, size_t) { return i ^ S; } };
+}
+
+// out[i] = x[Idx[i]]. A batch is returned if as many lanes are selected as x has,
+// an std::array otherwise.
+template<size_t...Idx, typename T, typename A>
+FORCE_INLINE auto permute(const xsimd::batch<T, A>& x) {
+    constexpr size_t W = xsimd::batch<T, A>::size;
+    static_assert(((Idx < W) && ...), "permute: lane index out of range");
+    if constexpr (sizeof...(Idx) == W)
+        return xsimd::swizzle(x, detail::lane_constant<T, A, Idx...>{});
+    else {
+        const auto v = to_array(x);
+        return std::array<T, sizeof...(Idx)>{ v[Idx]... };
+    }
+}
+
+template<size_t...Idx, tuple_like Tp>
+    requires( detail::simd_permute_tuple<Tp> )
+FORCE_INLINE auto permute(Tp&& tp) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+    constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<Tp>>;
+    if constexpr (sizeof...(Idx) == N)
+        return to_array(permute<Idx...>(to_simd<T>(std::forward<Tp>(tp))));
+    else
+        return std::array<T, sizeof...(Idx)>{ T(get<Idx>(tp))... };
+}
+
+// First N lanes of a batch, as an std::array (or the batch itself for all lanes).
+template<size_t N, typename T, typename A>
+FORCE_INLINE auto firstN(const xsimd::batch<T, A>& x) {
+    if constexpr (N == xsimd::batch<T, A>::size)
+        return x;
+    else
+        return detail::permute_map<detail::rotate_map<0>>(x, std::make_index_sequence<N>{});
+}
+
+template<size_t N, tuple_like Tp>
+    requires( detail::simd_permute_tuple<Tp> )
+FORCE_INLINE auto firstN(Tp&& tp) {
+    return detail::permute_map<detail::rotate_map<0>>(std::forward<Tp>(tp), std::make_index_sequence<N>{});
+}
+
+// out[i] = x[Idx[i]] for Idx[i] < W, y[Idx[i] - W] otherwise.
+template<size_t...Idx, typename T, typename A>
+FORCE_INLINE auto shuffle(const xsimd::batch<T, A>& x, const xsimd::batch<T, A>& y) {
+    static_assert(((Idx < 2 * xsimd::batch<T, A>::size) && ...), "shuffle: lane index out of range");
+    return xsimd::shuffle(x, y, detail::lane_constant<T, A, Idx...>{});
+}
+
+// out[i] = x[J] for every lane or element.
+template<size_t J, typename X>
+FORCE_INLINE auto broadcast_lane(X&& x) {
+    return detail::permute_map<detail::broadcast_map<J>>(std::forward<X>(x), std::make_index_sequence<detail::lane_count_v<X>>{});
+}
+
+// out[i] = x[(i + S) % W]: rotate towards lane 0.
+template<size_t S, typename X>
+FORCE_INLINE auto rotate_lanes(X&& x) {
+    return detail::permute_map<detail::rotate_map<S>>(std::forward<X>(x), std::make_index_sequence<detail::lane_count_v<X>>{});
+}
+
+// out[i] = x[W - 1 - i]
+template<typename X>
+FORCE_INLINE auto reverse_lanes(X&& x) {
+    return detail::permute_map<detail::reverse_map>(std::forward<X>(x), std::make_index_sequence<detail::lane_count_v<X>>{});
+}
+
+// (a0, a1, ...), (b0, b1, ...) -> (a0, b0, a1, b1, ...) as a pair of batches.
+template<typename T, typename A>
+FORCE_INLINE auto interleave(const xsimd::batch<T, A>& a, const xsimd::batch<T, A>& b) {
+    return std::pair{xsimd::zip_lo(a, b), xsimd::zip_hi(a, b)};
+}
+
+// (x0, y0, x1, y1, ...) in two batches -> (x0, x1, ...), (y0, y1, ...)
+template<typename T, typename A>
+FORCE_INLINE auto deinterleave(const xsimd::batch<T, A>& a, const xsimd::batch<T, A>& b) {
+    constexpr size_t W = xsimd::batch<T, A>::size;
+    return [&]<size_t...I>(std::index_sequence<I...>) {
+        return std::pair{shuffle<(2 * I)...>(a, b), shuffle<(2 * I + 1)...>(a, b)};
+    }(std::make_index_sequence<W>{});
+}
+
+namespace detail {
+    template<typename Map, typename X, size_t...I>
+    FORCE_INLINE auto permute_map(X&& x, std::index_sequence<I...>) {
+        constexpr size_t W = lane_count_v<X>;
+        return permute<Map::at(I, W)...>(std::forward<X>(x));
+    }
+
+    // out[i] = in[i ^ S], one step of a butterfly reduction
+    template<size_t S, typename T, typename A>
+    FORCE_INLINE auto butterfly_lanes(const xsimd::batch<T, A>& b) {
+        return permute_map<butterfly_map<S>>(b, std::make_index_sequence<xsimd::batch<T, A>::size>{});
+    }
+}
+
+}
@@ -0,0 +1,35 @@
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tpa_basic/basics.hpp"
+#include "../tpa_basic/other.hpp"
+#include "xsimd_cast.hpp"
+#include "xsimd_tpa_op.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    template<typename Tp>
+    concept simd_poly_tuple = same_type_tuple<Tp> and
+        std::is_floating_point_v<std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>> and
+        has_simd<std::tuple_element_t<0, std::remove_cvref_t<Tp>>, std::tuple_size_v<std::remove_cvref_t<Tp>>>;
+}
+
+// Same-type floating point tuples that fit in a batch are evaluated as one batch.
+template<auto...C, tuple_like X>
+    requires( detail::simd_poly_tuple<X> )
+FORCE_INLINE auto polyval(X&& x) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<X>>>;
+    return to_array(polyval<C...>(to_simd<T>(std::forward<X>(x))));
+}
+
+template<tuple_like Coeffs, tuple_like X>
+    requires( detail::simd_poly_tuple<X> )
+FORCE_INLINE auto polyval(Coeffs&& coeffs, X&& x) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<X>>>;
+    return to_array(polyval(std::forward<Coeffs>(coeffs), to_simd<T>(std::forward<X>(x))));
+}
+
+}
@@ -0,0 +1,72 @@
+#include <array>
+#include <type_traits>
+#include <xsimd/xsimd.hpp>
+#include "../tpa_basic/basics.hpp"
+#include "../tpa_basic/quaternion.hpp"
+#include "xsimd_cast.hpp"
+#include "xsimd_tpa_op.hpp"
+#include "xsimd_matrix.hpp"
+
+#pragma once
+
+namespace tpa {
+
+/**
+ * A single float or double quaternion is kept in one 4-lane batch (x, y, z, w);
+ * 3-vectors are padded with a zero lane.
+ */
+namespace detail {
+    template<typename Q>
+    concept simd_quat = quat_like<Q> and same_type_tuple<Q> and
+        std::is_floating_point_v<std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Q>>>> and
+        has_simd<std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Q>>>, 4>;
+
+    template<typename V, typename Q>
+    concept simd_vec3_for = vec3_like<V> and same_type_tuple<V> and
+        std::is_same_v<std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<V>>>,
+                       std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Q>>>>;
+
+    template<typename Q>
+    using quat_elem_t = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Q>>>;
+
+    template<typename S>
+    FORCE_INLINE S quat_mul_simd(const S& a, const S& b) {
+        using T = typename S::value_type;
+        const S sign(T(1), T(1), T(1), T(-1));
+        S r = permute<3, 3, 3, 3>(a) * b;
+        r = xsimd::fma(permute<0, 1, 2, 0>(a) * permute<3, 3, 3, 0>(b), sign, r);
+        r = xsimd::fma(permute<1, 2, 0, 1>(a) * permute<2, 0, 1, 1>(b), sign, r);
+        return xsimd::fnma(permute<2, 0, 1, 2>(a), permute<1, 2, 0, 2>(b), r);
+    }
+}
+
+template<tuple_like Q1, tuple_like Q2>
+    requires( detail::simd_quat<Q1> and detail::simd_quat<Q2> and
+              std::is_same_v<detail::quat_elem_t<Q1>, detail::quat_elem_t<Q2>> )
+FORCE_INLINE auto quat_mul(Q1&& q1, Q2&& q2) {
+    using T = detail::quat_elem_t<Q1>;
+    return to_array(detail::quat_mul_simd(to_simd<T>(std::forward<Q1>(q1)), to_simd<T>(std::forward<Q2>(q2))));
+}
+
+template<tuple_like Q>
+    requires( detail::simd_quat<Q> )
+FORCE_INLINE auto quat_conjugate(Q&& q) {
+    using T = detail::quat_elem_t<Q>;
+    using simd_t = detail::mat_simd_t<T>;
+    return to_array(to_simd<T>(std::forward<Q>(q)) * simd_t(T(-1), T(-1), T(-1), T(1)));
+}
+
+template<tuple_like Q, tuple_like V>
+    requires( detail::simd_quat<Q> and detail::vec3_like<V> and detail::simd_vec3_for<V, Q> )
+FORCE_INLINE auto quat_rotate(Q&& q, V&& v) {
+    using T = detail::quat_elem_t<Q>;
+    using simd_t = detail::mat_simd_t<T>;
+    const auto a = to_simd<T>(std::forward<Q>(q));
+    const simd_t x(T(get<0>(v)), T(get<1>(v)), T(get<2>(v)), T(0));
+    const simd_t t = detail::cross3(a, x) * simd_t(T(2));
+    const simd_t r = xsimd::fma(permute<3, 3, 3, 3>(a), t, x + detail::cross3(a, t));
+    const auto ra = to_array(r);
+    return std::array<T, 3>{ra[0], ra[1], ra[2]};
+}
+
+}
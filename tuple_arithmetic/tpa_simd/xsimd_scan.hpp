@@ -0,0 +1,56 @@
+#include <type_traits>
+#include <xsimd/xsimd.hpp>
+#include "../tpa_basic/basics.hpp"
+#include "../tpa_basic/scan_op.hpp"
+#include "xsimd_cast.hpp"
+#include "xsimd_tpa_op.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Log-step prefix sum: x[i] += x[i - S] for S = 1, 2, 4, ... (shifted-in lanes are zero)
+    template<size_t S, typename T, typename A>
+    FORCE_INLINE auto simd_scan_step(const xsimd::batch<T, A>& x) {
+        if constexpr (S >= xsimd::batch<T, A>::size)
+            return x;
+        else
+            return simd_scan_step<2*S>(x + xsimd::slide_left<S * sizeof(T)>(x));
+    }
+
+    template<typename Tp>
+    concept simd_scan_tuple = same_value_tuple<Tp> and
+        std::is_arithmetic_v<std::tuple_element_t<0, std::remove_cvref_t<Tp>>> and
+        has_simd<std::tuple_element_t<0, std::remove_cvref_t<Tp>>, std::tuple_size_v<std::remove_cvref_t<Tp>>>;
+}
+
+// (a1, a2, ...) -> (a1, a1 + a2, ...), computed in log2(size) shift-add steps.
+template<typename T, typename A>
+FORCE_INLINE auto inclusive_scan(const xsimd::batch<T, A>& x) {
+    return detail::simd_scan_step<1>(x);
+}
+
+// (a1, a2, ...), init -> (init, init + a1, init + a1 + a2, ...)
+template<typename T, typename A, typename Init>
+    requires( not tuple_like<Init> )
+FORCE_INLINE auto exclusive_scan(const xsimd::batch<T, A>& x, Init&& init) {
+    return xsimd::slide_left<sizeof(T)>(inclusive_scan(x)) + xsimd::batch<T, A>(init);
+}
+
+// Same-type arithmetic tuples that fit in a batch are scanned in registers.
+template<tuple_like Tp>
+    requires( detail::simd_scan_tuple<Tp> )
+FORCE_INLINE auto inclusive_scan(Tp&& tp) {
+    using T = std::tuple_element_t<0, std::remove_cvref_t<Tp>>;
+    return to_array(inclusive_scan(to_simd<T>(std::forward<Tp>(tp))));
+}
+
+template<tuple_like Tp, typename Init>
+    requires( detail::simd_scan_tuple<Tp> and std::is_arithmetic_v<std::remove_cvref_t<Init>> )
+FORCE_INLINE auto exclusive_scan(Tp&& tp, Init&& init) {
+    using T = std::tuple_element_t<0, std::remove_cvref_t<Tp>>;
+    return to_array(exclusive_scan(to_simd<T>(std::forward<Tp>(tp)), T(init)));
+}
+
+}
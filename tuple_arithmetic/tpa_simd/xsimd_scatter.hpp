@@ -0,0 +1,107 @@
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tpa_basic/basics.hpp"
+#include "../tpa_basic/scatter.hpp"
+#include "xsimd_cast.hpp"
+#include "xsimd_tpa_op.hpp"
+#include "xsimd_permute.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    /**
+     * Lane conflict resolver for a batch of indices.
+     * reduce(v)[i] is the sum of v[j] over all lanes j with idx[j] == idx[i].
+     * Lanes are accumulated in lane order, so duplicated lanes hold bitwise
+     * identical sums and a following scatter is correct whichever lane wins.
+     */
+    template<typename ib_t>
+    struct lane_conflicts {
+        static constexpr size_t W = ib_t::size;
+        std::array<typename ib_t::batch_bool_type, W> eq;
+
+        FORCE_INLINE lane_conflicts(const ib_t& idx) {
+            constexpr_for<0, W, 1>([&](auto J) {
+                eq[J] = idx == broadcast_lane<J>(idx);
+            });
+        }
+
+        template<typename T, typename A>
+        FORCE_INLINE auto reduce(const xsimd::batch<T, A>& v) const {
+            using simd_t = xsimd::batch<T, A>;
+            simd_t acc(T(0));
+            constexpr_for<0, W, 1>([&](auto J) {
+                acc += xsimd::select(xsimd::batch_bool_cast<T>(eq[J]), broadcast_lane<J>(v), simd_t(T(0)));
+            });
+            return acc;
+        }
+    };
+
+    template<typename T, size_t W>
+    using scatter_simd_t = xsimd::make_sized_batch_t<std::remove_cv_t<T>, W>;
+
+    template<typename T, typename ib_t, typename V>
+    FORCE_INLINE void scatter_add_resolved(T* ptr, const ib_t& ib, const lane_conflicts<ib_t>& conflicts, V&& val) {
+        using simd_t = xsimd::batch<T, typename ib_t::arch_type>;
+        auto acc = conflicts.reduce(cast_simd<simd_t>(std::forward<V>(val)));
+        (simd_t::gather(ptr, ib) + acc).scatter(ptr, ib);
+    }
+}
+
+/**
+ * ptr[idx[i]] += val[i] for every lane i, correct for duplicated indices.
+ * val is a batch, tuple or scalar with the same number of lanes as idx.
+ * Falls back to a serial update if T has no batch of that width.
+ */
+template<typename T, typename I, typename A, typename Val>
+    requires( std::is_arithmetic_v<T> )
+FORCE_INLINE void scatter_add(T* ptr, const xsimd::batch<I, A>& idx, Val&& val) {
+    constexpr size_t W = xsimd::batch<I, A>::size;
+    using simd_t = detail::scatter_simd_t<T, W>;
+    if constexpr (std::is_void_v<simd_t>) {
+        scatter_add(ptr, to_array(idx), to_array_deep(std::forward<Val>(val)));
+    }
+    else {
+        using int_t = xsimd::as_integer_t<T>;
+        const auto ib = to_simd<int_t>(idx);
+        detail::scatter_add_resolved(ptr, ib, detail::lane_conflicts<std::remove_cvref_t<decltype(ib)>>(ib), std::forward<Val>(val));
+    }
+}
+
+/**
+ * SoA bins: (p1, p2, ...)[idx[i]] += (v1[i], v2[i], ...).
+ * Conflicts are resolved once and shared by all columns of the same type.
+ */
+template<tuple_like Ptrs, typename I, typename A, typename Val>
+FORCE_INLINE void scatter_add(Ptrs&& ptrs, const xsimd::batch<I, A>& idx, Val&& val) {
+    constexpr size_t W = xsimd::batch<I, A>::size;
+    using ptr_t = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Ptrs>>>;
+    decltype(auto) tv = detail::broadcast<Ptrs>(std::forward<Val>(val));
+    auto serial = [&]() {
+        constexpr_for<0, std::tuple_size_v<std::remove_cvref_t<Ptrs>>, 1>([&](auto J) {
+            scatter_add(get<J>(ptrs), idx, get<J>(tv));
+        });
+    };
+    if constexpr (same_type_tuple<Ptrs> and std::is_pointer_v<ptr_t> and
+                  std::is_arithmetic_v<std::remove_pointer_t<ptr_t>>) {
+        using T = std::remove_pointer_t<ptr_t>;
+        if constexpr (std::is_void_v<detail::scatter_simd_t<T, W>>)
+            serial();
+        else {
+            using int_t = xsimd::as_integer_t<T>;
+            const auto ib = to_simd<int_t>(idx);
+            const detail::lane_conflicts<std::remove_cvref_t<decltype(ib)>> conflicts(ib);
+            constexpr_for<0, std::tuple_size_v<std::remove_cvref_t<Ptrs>>, 1>([&](auto J) {
+                detail::scatter_add_resolved(get<J>(ptrs), ib, conflicts, get<J>(tv));
+            });
+        }
+    }
+    else
+        serial();
+}
+
+}
@@ -0,0 +1,128 @@
+#include <type_traits>
+#include <utility>
+#include <xsimd/xsimd.hpp>
+#include "../tpa_basic/basics.hpp"
+#include "../tpa_basic/sort_op.hpp"
+#include "xsimd_cast.hpp"
+#include "xsimd_tpa_op.hpp"
+#include "xsimd_permute.hpp"
+
+#pragma once
+
+namespace tpa {
+
+namespace detail {
+    // Lane-packed networks: every lane of a tuple of batches is an independent record.
+    template<typename T, typename A>
+    struct sort_traits<xsimd::batch<T, A>> {
+        using index_type = xsimd::batch<xsimd::as_integer_t<T>, A>;
+        FORCE_INLINE static index_type index(size_t k) { return index_type(xsimd::as_integer_t<T>(k)); }
+        FORCE_INLINE static auto select(const xsimd::batch_bool<T, A>& cond, const xsimd::batch<T, A>& a, const xsimd::batch<T, A>& b) {
+            return xsimd::select(cond, a, b);
+        }
+        template<typename U>
+        FORCE_INLINE static auto select(const xsimd::batch_bool<T, A>& cond, const xsimd::batch<U, A>& a, const xsimd::batch<U, A>& b) {
+            return xsimd::select(xsimd::batch_bool_cast<U>(cond), a, b);
+        }
+    };
+
+    // out[i] = x[P[L][i]]
+    template<typename Net, size_t L, typename B, size_t...I>
+    FORCE_INLINE auto network_swizzle(const B& x, std::index_sequence<I...>) {
+        return permute<Net::partner[L][I]...>(x);
+    }
+
+    // Lanes that take the smaller (lo) or larger (hi) value of their pair in layer L.
+    template<typename Net, size_t L, bool Lo>
+    constexpr uint64_t network_lanes() {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < Net::partner[L].size(); ++i)
+            if (Lo ? i < Net::partner[L][i] : i > Net::partner[L][i])
+                bits |= uint64_t(1) << i;
+        return bits;
+    }
+
+    // Apply the network across the lanes of x (and idx): one swizzle, two compares and a blend per layer.
+    template<typename Net, typename T, typename A, typename...Idx>
+    FORCE_INLINE void run_lane_network(xsimd::batch<T, A>& x, Idx&...idx) {
+        using simd_t = xsimd::batch<T, A>;
+        using bsimd_t = typename simd_t::batch_bool_type;
+        constexpr auto seq = std::make_index_sequence<simd_t::size>{};
+        constexpr_for<0, Net::depth, 1>([&](auto L) {
+            constexpr size_t l = decltype(L)::value;
+            const auto lo = bsimd_t::from_mask(network_lanes<Net, l, true>());
+            const auto hi = bsimd_t::from_mask(network_lanes<Net, l, false>());
+            const simd_t y = network_swizzle<Net, l>(x, seq);
+            const auto take = (lo & (y < x)) | (hi & (x < y));
+            ((idx = xsimd::select(xsimd::batch_bool_cast<typename std::remove_cvref_t<Idx>::value_type>(take),
+                                  network_swizzle<Net, l>(idx, seq), idx)), ...);
+            x = xsimd::select(take, y, x);
+        });
+    }
+
+    template<typename Tp>
+    concept simd_sort_tuple = sortable_tuple<Tp> and
+        std::is_arithmetic_v<std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>> and
+        has_simd<std::tuple_element_t<0, std::remove_cvref_t<Tp>>, std::tuple_size_v<std::remove_cvref_t<Tp>>>;
+}
+
+// Sort the lanes of a batch.
+template<typename T, typename A>
+FORCE_INLINE auto sort(xsimd::batch<T, A> x) {
+    detail::run_lane_network<detail::sorting_network<xsimd::batch<T, A>::size>>(x);
+    return x;
+}
+
+// Lane indices that sort the batch, as a batch of integers of the same width.
+template<typename T, typename A>
+FORCE_INLINE auto argsort(xsimd::batch<T, A> x) {
+    auto idx = detail::lane_indices<T, A>();
+    detail::run_lane_network<detail::sorting_network<xsimd::batch<T, A>::size>>(x, idx);
+    return idx;
+}
+
+template<size_t K, typename T, typename A>
+FORCE_INLINE auto nth_element(xsimd::batch<T, A> x) {
+    static_assert(K < xsimd::batch<T, A>::size, "nth_element: K out of range");
+    detail::run_lane_network<detail::sorting_network<xsimd::batch<T, A>::size, uint64_t(1) << K>>(x);
+    return to_array(x)[K];
+}
+
+template<typename T, typename A>
+FORCE_INLINE auto median(xsimd::batch<T, A> x) {
+    constexpr size_t N = xsimd::batch<T, A>::size;
+    detail::run_lane_network<detail::sorting_network<N, uint64_t(3) << (N/2 - 1)>>(x);
+    const auto v = to_array(x);
+    return v[N/2 - 1] + (v[N/2] - v[N/2 - 1]) / 2;
+}
+
+// Same-type arithmetic tuples that fit in a batch are sorted across lanes.
+template<tuple_like Tp>
+    requires( detail::simd_sort_tuple<Tp> )
+FORCE_INLINE auto sort(Tp&& tp) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+    return to_array(sort(to_simd<T>(std::forward<Tp>(tp))));
+}
+
+template<tuple_like Tp>
+    requires( detail::simd_sort_tuple<Tp> )
+FORCE_INLINE auto argsort(Tp&& tp) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+    return cast<size_t>(to_array(argsort(to_simd<T>(std::forward<Tp>(tp)))));
+}
+
+template<size_t K, tuple_like Tp>
+    requires( detail::simd_sort_tuple<Tp> )
+FORCE_INLINE auto nth_element(Tp&& tp) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+    return nth_element<K>(to_simd<T>(std::forward<Tp>(tp)));
+}
+
+template<tuple_like Tp>
+    requires( detail::simd_sort_tuple<Tp> )
+FORCE_INLINE auto median(Tp&& tp) {
+    using T = std::remove_cvref_t<std::tuple_element_t<0, std::remove_cvref_t<Tp>>>;
+    return median(to_simd<T>(std::forward<Tp>(tp)));
+}
+
+}
@@ -0,0 +1,35 @@
+/**
+ * This header provides bulk kernels and algorithms built on top of
+ * "tuple_arithmetic.hpp" and "tuple_math.hpp". Each of them can also be
+ * included separately from "tpa_algo/".
+ */
+#ifndef TUPLE_ALGORITHM
+#define TUPLE_ALGORITHM
+
+#include "tuple_arithmetic.hpp"
+#include "tuple_math.hpp"
+#include "tpa_algo/soa.hpp"
+#include "tpa_algo/parallel.hpp"
+#include "tpa_algo/histogram.hpp"
+#include "tpa_algo/scan.hpp"
+#include "tpa_algo/arg_reduce.hpp"
+#include "tpa_algo/interp.hpp"
+#include "tpa_algo/transform.hpp"
+#include "tpa_algo/solve.hpp"
+#include "tpa_algo/vectors.hpp"
+#include "tpa_algo/neighbors.hpp"
+#include "tpa_algo/kd_tree.hpp"
+#include "tpa_algo/intersect.hpp"
+#include "tpa_algo/ode.hpp"
+#include "tpa_algo/particles.hpp"
+#include "tpa_algo/dual.hpp"
+#include "tpa_algo/random.hpp"
+#include "tpa_algo/stats.hpp"
+#include "tpa_algo/filter.hpp"
+#include "tpa_algo/spline.hpp"
+#include "tpa_algo/roots.hpp"
+#include "tpa_algo/fft.hpp"
+#include "tpa_algo/pixels.hpp"
+#include "tpa_algo/stencil.hpp"
+
+#endif
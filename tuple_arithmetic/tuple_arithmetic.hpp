@@ -8,11 +8,25 @@
 #include "tpa_basic/unary_op.hpp"
 #include "tpa_simd/xsimd_cast.hpp"
 #include "tpa_simd/xsimd_tpa_op.hpp"
+#include "tpa_simd/xsimd_permute.hpp"
 #include "tpa_basic/assign.hpp"
 #include "tpa_basic/binary_op.hpp"
 #include "tpa_basic/reduce_op.hpp"
+#include "tpa_basic/scan_op.hpp"
+#include "tpa_simd/xsimd_scan.hpp"
+#include "tpa_basic/sort_op.hpp"
+#include "tpa_simd/xsimd_sort.hpp"
+#include "tpa_basic/arg_reduce_op.hpp"
+#include "tpa_simd/xsimd_arg_reduce.hpp"
 #include "tpa_basic/ternary_op.hpp"
 #include "tpa_basic/other.hpp"
+#include "tpa_simd/xsimd_polyval.hpp"
+#include "tpa_basic/matrix.hpp"
+#include "tpa_simd/xsimd_matrix.hpp"
+#include "tpa_basic/quaternion.hpp"
+#include "tpa_simd/xsimd_quaternion.hpp"
+#include "tpa_basic/scatter.hpp"
+#include "tpa_simd/xsimd_scatter.hpp"
 
 #if defined(TP_NAMESPACE)
 using TP_NAMESPACE::operator+;